@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Headless editor paint benchmark
+
+    Builds the plugin editor against a prepared processor, renders it offscreen
+    with createComponentSnapshot at 1x and 2x and reports the mean, min and max
+    time of the whole editor and of each of its visible child components,
+    slowest first. Nothing is shown on screen, so it runs on build machines.
+
+    Between snapshots the processor plays a test tone with auto stutter on
+    under a fake play head, and every refresh client is refreshed by hand
+    (the refresh coordinator skips editors that are not showing), so the
+    timings include live visualizer, timeline and glow state.
+
+    Usage:  EditorBenchmark [iterations]        (default 50 per scale)
+
+    Build from EditorBenchmark.jucer in this folder; it compiles the plugin
+    sources from ../Source into a console app.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/PluginEditor.h"
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int BLOCK_SIZE = 512;
+    constexpr int DEFAULT_ITERATIONS = 50;
+    constexpr int WARM_UP_ITERATIONS = 3;
+    constexpr double TEMPO_BPM = 120.0;
+    constexpr double TEST_TONE_HZ = 220.0;
+    constexpr int BLOCKS_PER_FRAME = 3;     // About one 25 ms refresh frame at 48 kHz
+
+    // Transport that is always playing, advanced by the benchmark one block at a time
+    struct FakePlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo position;
+            position.setIsPlaying(true);
+            position.setBpm(TEMPO_BPM);
+            position.setTimeSignature(TimeSignature { 4, 4 });
+            position.setTimeInSamples(samplePosition);
+            position.setPpqPosition(static_cast<double>(samplePosition) / SAMPLE_RATE * (TEMPO_BPM / 60.0));
+            return position;
+        }
+
+        juce::int64 samplePosition = 0;
+    };
+
+    // Plays a few blocks of test tone, then refreshes the editor as one vblank frame would
+    class LiveProcessor
+    {
+    public:
+        LiveProcessor(NanoStuttAudioProcessor& p, NanoStuttAudioProcessorEditor& e)
+            : processor(p), editor(e)
+        {
+            processor.setPlayHead(&playHead);
+
+            auto* autoStutter = processor.getParameters().getParameter("autoStutterEnabled");
+            autoStutter->setValueNotifyingHost(1.0f);
+
+            collectClients(editor);
+        }
+
+        ~LiveProcessor() { processor.setPlayHead(nullptr); }
+
+        void advanceFrame()
+        {
+            for (int i = 0; i < BLOCKS_PER_FRAME; ++i)
+                processBlock();
+
+            auto state = DisplayState::capture(processor, autoStutterEnabledParam);
+            for (auto* client : clients)
+                client->refresh(state);
+            editor.refresh(state);  // Last, as in the editor's own client order
+        }
+
+    private:
+        void collectClients(juce::Component& parent)
+        {
+            for (auto* child : parent.getChildren())
+            {
+                if (auto* client = dynamic_cast<RefreshClient*>(child))
+                    clients.push_back(client);
+                collectClients(*child);
+            }
+        }
+
+        void processBlock()
+        {
+            for (int sample = 0; sample < BLOCK_SIZE; ++sample)
+            {
+                auto value = 0.5f * static_cast<float>(std::sin(tonePhase));
+                tonePhase += juce::MathConstants<double>::twoPi * TEST_TONE_HZ / SAMPLE_RATE;
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.setSample(channel, sample, value);
+            }
+
+            processor.processBlock(buffer, midi);
+            midi.clear();
+            playHead.samplePosition += BLOCK_SIZE;
+        }
+
+        NanoStuttAudioProcessor& processor;
+        NanoStuttAudioProcessorEditor& editor;
+        const std::atomic<float>& autoStutterEnabledParam { *processor.getParameters().getRawParameterValue("autoStutterEnabled") };
+        FakePlayHead playHead;
+        std::vector<RefreshClient*> clients;
+        juce::AudioBuffer<float> buffer { 2, BLOCK_SIZE };
+        juce::MidiBuffer midi;
+        double tonePhase = 0.0;
+    };
+
+    struct Timing
+    {
+        juce::String name;
+        double totalMs = 0.0;
+        double minMs = 0.0;
+        double maxMs = 0.0;
+        int count = 0;
+
+        void add(double ms)
+        {
+            minMs = count == 0 ? ms : juce::jmin(minMs, ms);
+            maxMs = juce::jmax(maxMs, ms);
+            totalMs += ms;
+            ++count;
+        }
+
+        double getMeanMs() const { return count > 0 ? totalMs / count : 0.0; }
+    };
+
+    double timeSnapshot(juce::Component& component, float scale)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        auto image = component.createComponentSnapshot(component.getLocalBounds(), true, scale);
+        auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+        juce::ignoreUnused(image);
+        return juce::Time::highResolutionTicksToSeconds(elapsed) * 1000.0;
+    }
+
+    juce::String describe(const juce::Component& component, int index)
+    {
+        if (component.getName().isNotEmpty())
+            return component.getName();
+        if (component.getComponentID().isNotEmpty())
+            return component.getComponentID();
+
+        // Unnamed controls are told apart by their place in the layout
+        return "child " + juce::String(index) + " @ " + component.getBounds().toString();
+    }
+
+    void printTimings(std::vector<Timing> timings, float scale)
+    {
+        std::sort(timings.begin(), timings.end(),
+                  [](const Timing& a, const Timing& b) { return a.getMeanMs() > b.getMeanMs(); });
+
+        std::cout << "\n=== " << juce::String(scale, 1) << "x ===\n";
+        std::cout << juce::String("component").paddedRight(' ', 44)
+                  << juce::String("mean ms").paddedLeft(' ', 10)
+                  << juce::String("min ms").paddedLeft(' ', 10)
+                  << juce::String("max ms").paddedLeft(' ', 10) << "\n";
+
+        for (const auto& timing : timings)
+        {
+            std::cout << timing.name.substring(0, 43).paddedRight(' ', 44)
+                      << juce::String(timing.getMeanMs(), 3).paddedLeft(' ', 10)
+                      << juce::String(timing.minMs, 3).paddedLeft(' ', 10)
+                      << juce::String(timing.maxMs, 3).paddedLeft(' ', 10) << "\n";
+        }
+    }
+
+    void runBenchmark(juce::Component& editor, LiveProcessor& live, float scale, int iterations)
+    {
+        std::vector<juce::Component*> children;
+        for (auto* child : editor.getChildren())
+            if (child->isVisible() && !child->getBounds().isEmpty())
+                children.push_back(child);
+
+        std::vector<Timing> timings(children.size() + 1);
+        timings[0].name = "[editor, all children]";
+        for (size_t i = 0; i < children.size(); ++i)
+            timings[i + 1].name = describe(*children[i], (int) i);
+
+        // First renders fill the glow sprites and texture caches; steady-state paints are what matter
+        for (int i = 0; i < WARM_UP_ITERATIONS; ++i)
+        {
+            live.advanceFrame();
+            timeSnapshot(editor, scale);
+        }
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            live.advanceFrame();
+            timings[0].add(timeSnapshot(editor, scale));
+            for (size_t c = 0; c < children.size(); ++c)
+            {
+                live.advanceFrame();
+                timings[c + 1].add(timeSnapshot(*children[c], scale));
+            }
+        }
+
+        printTimings(std::move(timings), scale);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    int iterations = argc > 1 ? juce::jmax(1, juce::String(argv[1]).getIntValue()) : DEFAULT_ITERATIONS;
+
+    NanoStuttAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, SAMPLE_RATE, BLOCK_SIZE);
+    processor.prepareToPlay(SAMPLE_RATE, BLOCK_SIZE);
+
+    std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditorIfNeeded());
+    auto* nanoStuttEditor = dynamic_cast<NanoStuttAudioProcessorEditor*>(editor.get());
+    if (nanoStuttEditor == nullptr)
+    {
+        std::cerr << "The processor did not create an editor\n";
+        return 1;
+    }
+
+    // Let the editor's deferred setup (async callbacks, background textures) settle before measuring
+    juce::MessageManager::getInstance()->runDispatchLoopUntil(500);
+
+    std::cout << "NanoStutt editor " << editor->getWidth() << "x" << editor->getHeight()
+              << ", " << iterations << " snapshots per scale\n";
+
+    {
+        LiveProcessor live(processor, *nanoStuttEditor);
+        for (float scale : { 1.0f, 2.0f })
+            runBenchmark(*editor, live, scale, iterations);
+    }
+
+    editor.reset();     // Detaches itself from the processor
+    processor.releaseResources();
+    return 0;
+}
@@ -8,6 +8,9 @@
     - Black: Auto stutter disabled
     - Green: Auto stutter enabled but not active
     - Bright green: Currently stuttering
+    - Letter: sync group (A-H), lower case when following
+
+    Click toggles auto stutter, right-click opens the group sync and state link menu.
 
   ==============================================================================
 */
@@ -16,13 +19,31 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "RefreshCoordinator.h"
 
-class AutoStutterIndicator : public juce::Component, private juce::Timer
+class AutoStutterIndicator : public juce::Component, public RefreshClient
 {
 public:
     AutoStutterIndicator(NanoStuttAudioProcessor& p) : processor(p)
     {
-        startTimerHz(30); // Update at 30Hz for real-time feedback
+        syncGroupParam = processor.getParameters().getRawParameterValue("syncGroup");
+        syncRoleParam = processor.getParameters().getRawParameterValue("syncRole");
+    }
+
+    // Repaints only when the shown state changes
+    void refresh(const DisplayState& state) override
+    {
+        Shown next { state.autoStutterEnabled,
+                     state.autoStutterActive,
+                     state.usingNanoRate,
+                     static_cast<int>(syncGroupParam->load()),
+                     syncRoleParam->load() > 0.5f };
+
+        if (next != shown)
+        {
+            shown = next;
+            repaint();
+        }
     }
 
     void paint(juce::Graphics& g) override
@@ -31,10 +52,10 @@ public:
         auto centre = bounds.getCentre();
         float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) / 2.0f - 2.0f;
 
-        // Get states
-        bool isEnabled = processor.getParameters().getRawParameterValue("autoStutterEnabled")->load() > 0.5f;
-        bool isStuttering = processor.isAutoStutterActive();
-        bool isNanoStutter = processor.isUsingNanoRate();
+        // Get states (as of the last refresh)
+        bool isEnabled = shown.enabled;
+        bool isStuttering = shown.stuttering;
+        bool isNanoStutter = shown.nano;
 
         // Determine color
         juce::Colour fillColour;
@@ -54,10 +75,27 @@ public:
         // Draw outline
         g.setColour(juce::Colours::darkgrey);
         g.drawEllipse(centre.x - radius, centre.y - radius, radius * 2, radius * 2, 1.5f);
+
+        // Sync group letter
+        int group = shown.syncGroup;
+        if (group > 0)
+        {
+            bool isFollower = shown.follower;
+            juce::String letter = juce::String::charToString(static_cast<juce::juce_wchar>('A' + group - 1));
+            g.setColour(isEnabled || isStuttering ? juce::Colours::black : juce::Colours::lightgrey);
+            g.setFont(juce::FontOptions(radius * 1.2f, juce::Font::bold));
+            g.drawText(isFollower ? letter.toLowerCase() : letter, bounds, juce::Justification::centred);
+        }
     }
 
-    void mouseDown(const juce::MouseEvent&) override
+    void mouseDown(const juce::MouseEvent& event) override
     {
+        if (event.mods.isPopupMenu())
+        {
+            showSyncMenu();
+            return;
+        }
+
         // Toggle the parameter
         auto* param = processor.getParameters().getRawParameterValue("autoStutterEnabled");
         float currentValue = param->load();
@@ -65,8 +103,83 @@ public:
     }
 
 private:
-    void timerCallback() override { repaint(); }
+    void showSyncMenu()
+    {
+        auto& params = processor.getParameters();
+        int group = static_cast<int>(params.getRawParameterValue("syncGroup")->load());
+        bool isFollower = params.getRawParameterValue("syncRole")->load() > 0.5f;
+        bool followRates = params.getRawParameterValue("syncFollowRates")->load() > 0.5f;
+        int link = static_cast<int>(params.getRawParameterValue("stateLink")->load());
+        bool excludeMix = params.getRawParameterValue("linkExcludeMix")->load() > 0.5f;
+        bool excludeTuning = params.getRawParameterValue("linkExcludeTuning")->load() > 0.5f;
+
+        juce::PopupMenu groupMenu;
+        groupMenu.addItem(100, "Off", true, group == 0);
+        for (int i = 1; i <= StutterGroupRegistry::NUM_GROUPS; ++i)
+            groupMenu.addItem(100 + i, "Group " + juce::String::charToString(static_cast<juce::juce_wchar>('A' + i - 1)), true, group == i);
+
+        juce::PopupMenu linkMenu;
+        linkMenu.addItem(200, "Off", true, link == 0);
+        for (int i = 1; i <= LinkedStateRegistry::NUM_CHANNELS; ++i)
+            linkMenu.addItem(200 + i, "Link " + juce::String::charToString(static_cast<juce::juce_wchar>('A' + i - 1)), true, link == i);
+
+        juce::PopupMenu menu;
+        menu.addSectionHeader("Group Sync");
+        menu.addSubMenu("Group", groupMenu);
+        menu.addItem(1, "Leader", group > 0, !isFollower);
+        menu.addItem(2, "Follower", group > 0, isFollower);
+        menu.addItem(3, "Follow Leader Rates", group > 0 && isFollower, followRates);
+        menu.addSectionHeader("State Link");
+        menu.addSubMenu("Link", linkMenu);
+        menu.addItem(4, "Keep Mix Mode Local", link > 0, excludeMix);
+        menu.addItem(5, "Keep Tuning Local", link > 0, excludeTuning);
+
+        menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this),
+            [this, followRates, excludeMix, excludeTuning](int result)
+            {
+                auto& apvts = processor.getParameters();
+                auto setParam = [&apvts](const juce::String& id, float plainValue)
+                {
+                    if (auto* param = apvts.getParameter(id))
+                        param->setValueNotifyingHost(param->convertTo0to1(plainValue));
+                };
+
+                if (result >= 200)
+                    setParam("stateLink", static_cast<float>(result - 200));
+                else if (result >= 100)
+                    setParam("syncGroup", static_cast<float>(result - 100));
+                else if (result == 1 || result == 2)
+                    setParam("syncRole", static_cast<float>(result - 1));
+                else if (result == 3)
+                    setParam("syncFollowRates", followRates ? 0.0f : 1.0f);
+                else if (result == 4)
+                    setParam("linkExcludeMix", excludeMix ? 0.0f : 1.0f);
+                else if (result == 5)
+                    setParam("linkExcludeTuning", excludeTuning ? 0.0f : 1.0f);
+            });
+    }
+
+    struct Shown
+    {
+        bool enabled = false;
+        bool stuttering = false;
+        bool nano = false;
+        int syncGroup = 0;
+        bool follower = false;
+
+        bool operator!=(const Shown& other) const
+        {
+            return enabled != other.enabled || stuttering != other.stuttering || nano != other.nano
+                || syncGroup != other.syncGroup || follower != other.follower;
+        }
+    };
+
     NanoStuttAudioProcessor& processor;
+    Shown shown;
+
+    // Parameters polled by refresh(), resolved once in the constructor
+    std::atomic<float>* syncGroupParam = nullptr;
+    std::atomic<float>* syncRoleParam = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoStutterIndicator)
 };
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    BackgroundTextureCache.h
+    Process-wide cache of the editor's neumorphic noise texture
+
+    The noise is generated per pixel, which is too slow to do on the message
+    thread every time an editor opens. Textures are keyed by editor size and
+    display scale, generated once on a background thread and shared by every
+    instance (and every reopened editor) through a SharedResourcePointer.
+    Processors hold the pointer too, so the cache outlives its editors.
+
+    Until a texture is ready, getTexture() returns a null image and the editor
+    paints its flat background colour; listeners get a change message when a
+    texture finishes so they can repaint.
+
+    Only the most recently used MAX_TEXTURES are kept, so resizing the editor
+    or moving it between displays does not accumulate full-size images.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TextureGenerator.h"
+
+class BackgroundTextureCache : public juce::ChangeBroadcaster
+{
+public:
+    static constexpr float NOISE_INTENSITY = 0.03f;
+    static constexpr int MAX_TEXTURES = 4;
+
+    BackgroundTextureCache() = default;
+
+    ~BackgroundTextureCache() override
+    {
+        // A running job writes into this cache, so it must have finished before
+        // anything is destroyed: wait for it without a timeout (generation is bounded)
+        {
+            const juce::ScopedLock lock(cacheLock);
+            shuttingDown = true;
+        }
+        pool.removeAllJobs(true, -1);
+    }
+
+    /**
+        Message thread: returns the texture for this size and scale, or a null
+        image if it is not ready yet (generation is started on first request).
+
+        @param width, height    Editor size in logical pixels
+        @param scale            Physical pixel scale factor of the display
+    */
+    juce::Image getTexture(int width, int height, float scale)
+    {
+        if (width <= 0 || height <= 0)
+            return {};
+
+        auto key = makeKey(width, height, scale);
+
+        const juce::ScopedLock lock(cacheLock);
+        auto index = keys.indexOf(key);
+        if (index >= 0)
+        {
+            // Most recently used last, so eviction drops the oldest
+            keys.move(index, -1);
+            textures.move(index, -1);
+            return textures.getLast();
+        }
+
+        if (!shuttingDown && !pending.contains(key))
+        {
+            pending.add(key);
+            int pixelWidth = juce::roundToInt(width * scale);
+            int pixelHeight = juce::roundToInt(height * scale);
+
+            pool.addJob([this, key, pixelWidth, pixelHeight]
+            {
+                auto texture = TextureGenerator::createNeumorphicNoise(pixelWidth, pixelHeight, NOISE_INTENSITY);
+                {
+                    const juce::ScopedLock generatedLock(cacheLock);
+                    if (shuttingDown)
+                        return;
+
+                    pending.removeString(key);
+                    keys.add(key);
+                    textures.add(texture);
+
+                    while (keys.size() > MAX_TEXTURES)
+                    {
+                        keys.remove(0);
+                        textures.remove(0);
+                    }
+                }
+                sendChangeMessage();
+            });
+        }
+
+        return {};
+    }
+
+    // Generation can be started before the first paint, when the scale is only a guess
+    void prefetch(int width, int height, float scale) { getTexture(width, height, scale); }
+
+private:
+    static juce::String makeKey(int width, int height, float scale)
+    {
+        return juce::String(width) + "x" + juce::String(height) + "@" + juce::String(juce::roundToInt(scale * 100.0f));
+    }
+
+    juce::CriticalSection cacheLock;
+    juce::StringArray keys;
+    juce::Array<juce::Image> textures;
+    juce::StringArray pending;
+    bool shuttingDown = false;          // Guarded by cacheLock
+    juce::ThreadPool pool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BackgroundTextureCache)
+};
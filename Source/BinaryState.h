@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    BinaryState.h
+    Compact binary plugin state (what the host stores in its session)
+
+    Sessions used to store the APVTS tree as XML, which means formatting and
+    reparsing ~100 PARAM elements plus attribute lookups per parameter on
+    every save and load. The binary state is:
+
+        int     MAGIC ("NSB1")
+        int     VERSION
+        int     flags (FLAG_COMPRESSED)
+        payload (GZIP-compressed if FLAG_COMPRESSED):
+            compressed int  number of parameters
+            string          parameter IDs, in table order
+            float           denormalised values, in the same order
+            ValueTree       EXTRA: the non-parameter children of the state
+                            (rate transitions, pattern script), plus
+                            the session-only morph sources
+
+    IDs are stored once so a session still maps correctly after parameters
+    were added, removed or reordered; unknown IDs are skipped on read.
+    Older sessions (XML via copyXmlToBinary) are recognised by the missing
+    magic and still restored through the XML path.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "ParameterTable.h"
+
+namespace BinaryState
+{
+    constexpr int MAGIC = 0x3142534e;           // "NSB1"
+    constexpr int VERSION = 1;
+    constexpr int FLAG_COMPRESSED = 1;
+    constexpr size_t COMPRESSION_THRESHOLD = 1024;  // Smaller payloads are stored as they are
+
+    const juce::Identifier extraType { "EXTRA" };
+    const juce::Identifier parameterType { "PARAM" };
+
+    struct State
+    {
+        juce::StringArray parameterIDs;
+        std::vector<float> values;              // Denormalised, parallel to parameterIDs
+        juce::ValueTree extra;                  // Non-parameter children of the state
+    };
+
+    /** True if data starts with the binary state header (anything else goes to the XML fallback). */
+    inline bool isBinaryState(const void* data, int sizeInBytes)
+    {
+        return data != nullptr
+            && sizeInBytes >= 3 * (int) sizeof(int)
+            && (int) juce::ByteOrder::littleEndianInt(data) == MAGIC;
+    }
+
+    /**
+        Writes the current parameter values and the non-parameter children of
+        state (a copy of the APVTS tree) to dest.
+    */
+    inline void write(const ParameterTable& table, const juce::ValueTree& state, juce::MemoryBlock& dest)
+    {
+        juce::MemoryOutputStream payload;
+        payload.writeCompressedInt(table.size());
+
+        for (int i = 0; i < table.size(); ++i)
+            payload.writeString(table.getID(i));
+
+        for (int i = 0; i < table.size(); ++i)
+        {
+            auto* parameter = table.getParameter(i);
+            payload.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+        }
+
+        juce::ValueTree extra(extraType);
+        for (const auto& child : state)
+        {
+            if (!child.hasType(parameterType))
+                extra.appendChild(child.createCopy(), nullptr);
+        }
+        extra.writeToStream(payload);
+
+        bool compress = payload.getDataSize() > COMPRESSION_THRESHOLD;
+
+        juce::MemoryOutputStream output(dest, false);
+        output.writeInt(MAGIC);
+        output.writeInt(VERSION);
+        output.writeInt(compress ? FLAG_COMPRESSED : 0);
+
+        if (compress)
+        {
+            juce::GZIPCompressorOutputStream compressor(output);
+            compressor.write(payload.getData(), payload.getDataSize());
+        }
+        else
+        {
+            output.write(payload.getData(), payload.getDataSize());
+        }
+    }
+
+    /**
+        Reads the parameter IDs, values and EXTRA tree of an (uncompressed)
+        payload; factory preset records use the same layout.
+
+        @return     False if the payload is truncated
+    */
+    inline bool readParameters(const void* payloadData, int sizeInBytes, State& result)
+    {
+        juce::MemoryInputStream payload(payloadData, (size_t) sizeInBytes, false);
+
+        int numParameters = payload.readCompressedInt();
+        if (numParameters < 0 || (size_t) numParameters * sizeof(float) > (size_t) sizeInBytes)
+            return false;
+
+        result.parameterIDs.clearQuick();
+        result.parameterIDs.ensureStorageAllocated(numParameters);
+        for (int i = 0; i < numParameters; ++i)
+            result.parameterIDs.add(payload.readString());
+
+        result.values.resize((size_t) numParameters);
+        for (auto& value : result.values)
+            value = payload.readFloat();
+
+        if (payload.isExhausted() && numParameters > 0)
+            return false;   // Truncated
+
+        result.extra = juce::ValueTree::readFromStream(payload);
+        return true;
+    }
+
+    /**
+        Reads a binary state written by write().
+
+        @return     False if the data is not a (readable) binary state of this or an older version
+    */
+    inline bool read(const void* data, int sizeInBytes, State& result)
+    {
+        if (!isBinaryState(data, sizeInBytes))
+            return false;
+
+        juce::MemoryInputStream input(data, (size_t) sizeInBytes, false);
+        input.readInt();    // Magic
+
+        int version = input.readInt();
+        int flags = input.readInt();
+        if (version < 1 || version > VERSION)
+        {
+            DBG("Binary state: unsupported version " + juce::String(version));
+            return false;
+        }
+
+        juce::MemoryBlock payloadData;
+        if ((flags & FLAG_COMPRESSED) != 0)
+        {
+            juce::GZIPDecompressorInputStream decompressor(input);
+            decompressor.readIntoMemoryBlock(payloadData);
+        }
+        else
+        {
+            input.readIntoMemoryBlock(payloadData);
+        }
+
+        return readParameters(payloadData.getData(), (int) payloadData.getSize(), result);
+    }
+}
@@ -12,6 +12,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "RefreshCoordinator.h"
+#include "PaintProfiler.h"
 
 //==============================================================================
 /**
@@ -23,14 +25,22 @@
  * Usage:
  * - Click and drag the center area to adjust main value
  * - Click and drag the outer ring to adjust randomization amount
+ *
+ * Rendering:
+ * - Guide ring and snap indicator are cached in an image per size and scale
+ * - Only the random arc and value markers are stroked live
+ * - The knob and its text box belong to a hidden slider that paint() draws,
+ *   so neither slider repaints itself when its value changes
+ * - Value changes mark the slider dirty; the owner's RefreshCoordinator
+ *   repaints it at most once per display frame (register it as a client)
  */
-class DualSlider : public juce::Component
+class DualSlider : public juce::Component, public RefreshClient
 {
 public:
     DualSlider()
     {
-        // Setup main value slider
-        addAndMakeVisible(mainSlider);
+        // Setup main value slider (hidden like randomSlider; paint() draws it)
+        addChildComponent(mainSlider);
         mainSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
         mainSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
         mainSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.2f,
@@ -42,7 +52,8 @@ public:
 
         // Setup randomization slider (hidden, we'll draw it ourselves)
         // Range -1.0 to 1.0: negative = subtract, positive = add (for unipolar mode)
-        addAndMakeVisible(randomSlider);
+        // Never made visible, so value changes don't repaint it
+        addChildComponent(randomSlider);
         randomSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
         randomSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
         randomSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.2f,
@@ -51,13 +62,21 @@ public:
         randomSlider.setRange(-1.0, 1.0, 0.01);
         randomSlider.setValue(0.0);
 
-        // Make random slider invisible (we'll draw it manually)
-        randomSlider.setAlpha(0.0f);
         randomSlider.setInterceptsMouseClicks(false, false);
 
-        // Listen for value changes to trigger repaints
-        mainSlider.onValueChange = [this]() { repaint(); };
-        randomSlider.onValueChange = [this]() { repaint(); };
+        // Value changes (automation, attachments) only mark the slider dirty, see refresh()
+        mainSlider.onValueChange = [this]() { repaintPending = true; };
+        randomSlider.onValueChange = [this]() { repaintPending = true; };
+    }
+
+    // Coalesces any number of value changes since the last frame into one repaint
+    void refresh(const DisplayState&) override
+    {
+        if (repaintPending)
+        {
+            repaintPending = false;
+            repaint();
+        }
     }
 
     // Set bipolar mode (true = ±random, false = +random only)
@@ -119,6 +138,7 @@ public:
 
     void paint(juce::Graphics& g) override
     {
+        PaintProfiler::Scope profileScope(paintProfiler, g);
         auto bounds = getLocalBounds().toFloat();
         auto centreX = bounds.getCentreX();
         auto centreY = bounds.getCentreY();
@@ -142,15 +162,11 @@ public:
         float mainProportion = static_cast<float>((mainValue - mainMin) / (mainMax - mainMin));
         float centerAngle = startAngle + (mainProportion * angleRange);
 
-        // Draw guide ring (subtle)
-        juce::Path guideRing;
-        guideRing.addCentredArc(centreX, centreY,
-                               randomRingRadius, randomRingRadius,
-                               0.0f,
-                               startAngle, endAngle,
-                               true);
-        g.setColour(juce::Colours::grey.withAlpha(0.15f));
-        g.strokePath(guideRing, juce::PathStrokeType(6.0f));
+        // Guide ring and snap indicator (cached)
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (scale != cachedScale || snapModeEnabled != cachedSnapMode || staticLayer.isNull())
+            renderStaticLayer(scale);
+        g.drawImage(staticLayer, bounds);
 
         // Draw randomization range if value != 0
         if (std::abs(randomAmount) > 0.005f)
@@ -233,20 +249,8 @@ public:
             g.fillEllipse(centerX - endPointRadius, centerY - endPointRadius, endPointRadius * 2, endPointRadius * 2);
         }
 
-        // Visual feedback for snap-to-quarter mode
-        if (snapModeEnabled)
-        {
-            // Draw cyan colored ring around the outer edge to indicate snap mode is active
-            g.setColour(juce::Colours::cyan.withAlpha(0.6f));
-            juce::Path snapIndicatorRing;
-            float snapRingRadius = outerRadius * 1.05f;
-            snapIndicatorRing.addCentredArc(centreX, centreY,
-                                           snapRingRadius, snapRingRadius,
-                                           0.0f,
-                                           startAngle, endAngle,
-                                           true);
-            g.strokePath(snapIndicatorRing, juce::PathStrokeType(2.5f));
-        }
+        // Knob and text box last, over the ring (the slider shares our bounds)
+        mainSlider.paintEntireComponent(g, false);
     }
 
     void resized() override
@@ -258,6 +262,8 @@ public:
 
         // Random slider is invisible but needs bounds for value storage
         randomSlider.setBounds(bounds);
+
+        staticLayer = {};  // Re-rendered at the next paint
     }
 
     void mouseDown(const juce::MouseEvent& event) override
@@ -439,6 +445,57 @@ private:
     float randomSensitivity = 0.003f;  // Drag sensitivity for random slider (default 0.003, higher = more sensitive)
     double originalMainInterval = 0.01;  // Store original main slider interval when snap mode is toggled
     double originalRandomInterval = 0.01;  // Store original random slider interval when snap mode is toggled
+    bool repaintPending = false;  // Value changed since the last frame
+    juce::Image staticLayer;  // Guide ring + snap indicator
+    float cachedScale = 0.0f;
+    bool cachedSnapMode = false;
+    PaintProfiler paintProfiler { "DualSlider" };
+
+    void renderStaticLayer(float scale)
+    {
+        cachedScale = scale;
+        cachedSnapMode = snapModeEnabled;
+
+        auto bounds = getLocalBounds().toFloat();
+        staticLayer = juce::Image(juce::Image::ARGB,
+                                  juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale)),
+                                  juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale)),
+                                  true);
+        juce::Graphics g(staticLayer);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        auto centreX = bounds.getCentreX();
+        auto centreY = bounds.getCentreY();
+        float outerRadius = juce::jmin(bounds.getWidth(), bounds.getHeight()) * 0.45f;
+        float randomRingRadius = outerRadius * 0.85f;
+        float startAngle = juce::MathConstants<float>::pi * 1.2f;
+        float endAngle = juce::MathConstants<float>::pi * 2.8f;
+
+        // Draw guide ring (subtle)
+        juce::Path guideRing;
+        guideRing.addCentredArc(centreX, centreY,
+                               randomRingRadius, randomRingRadius,
+                               0.0f,
+                               startAngle, endAngle,
+                               true);
+        g.setColour(juce::Colours::grey.withAlpha(0.15f));
+        g.strokePath(guideRing, juce::PathStrokeType(6.0f));
+
+        // Visual feedback for snap-to-quarter mode
+        if (snapModeEnabled)
+        {
+            // Draw cyan colored ring around the outer edge to indicate snap mode is active
+            g.setColour(juce::Colours::cyan.withAlpha(0.6f));
+            juce::Path snapIndicatorRing;
+            float snapRingRadius = outerRadius * 1.05f;
+            snapIndicatorRing.addCentredArc(centreX, centreY,
+                                           snapRingRadius, snapRingRadius,
+                                           0.0f,
+                                           startAngle, endAngle,
+                                           true);
+            g.strokePath(snapIndicatorRing, juce::PathStrokeType(2.5f));
+        }
+    }
 
     void updateRandomFromMouse(const juce::MouseEvent& event)
     {
@@ -474,7 +531,6 @@ private:
         }
 
         randomSlider.setValue(newValue, juce::sendNotificationAsync);
-        repaint();
     }
 
     void updateMainFromMouse(const juce::MouseEvent& event)
@@ -497,7 +553,6 @@ private:
         }
 
         mainSlider.setValue(newValue, juce::sendNotificationAsync);
-        repaint();
     }
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DualSlider)
 };
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    FactoryPresetBank.h
+    Factory presets embedded in the plugin binary as one packed resource
+
+    Factory presets used to be a dozen XML resources that every PresetManager
+    (i.e. every plugin instance, including the ones a host creates to scan)
+    parsed in full just to list them. They are now packed by
+    Source/Presets/pack_factory_presets.py into FactoryPresets.bin:
+
+        int     MAGIC ("NSF1")
+        int     VERSION
+        compressed int  number of presets
+        index, per preset:
+            string  name, category, author, creationDate, description, tags
+            int     offset of its record (from the start of the records)
+            int     size of its record
+        records, per preset (read with BinaryState::readParameters):
+            compressed int  number of parameters
+            string          parameter IDs
+            float           denormalised values, in the same order
+            ValueTree       EXTRA: the non-parameter children of the state
+
+    Only the index is read, once per process (SharedResourcePointer); a
+    record is decoded when its preset is loaded, previewed or used as a
+    morph source. The XML files in Source/Presets stay the editable source;
+    rerun the packer after changing them.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "BinaryState.h"
+
+class FactoryPresetBank
+{
+public:
+    static constexpr int MAGIC = 0x3146534e;    // "NSF1"
+    static constexpr int VERSION = 1;
+
+    struct Entry
+    {
+        juce::String name;
+        juce::String category;
+        juce::String author;
+        juce::String creationDate;
+        juce::String description;
+        juce::StringArray tags;
+        int recordOffset = 0;
+        int recordSize = 0;
+    };
+
+    FactoryPresetBank()
+        : data(BinaryData::FactoryPresets_bin),
+          dataSize(BinaryData::FactoryPresets_binSize)
+    {
+        readIndex();
+    }
+
+    int size() const                            { return (int) entries.size(); }
+    const Entry& getEntry(int index) const      { return entries[(size_t) index]; }
+
+    /**
+        The encoded record of a preset (what decode() reads), e.g. for hashing.
+
+        @return     Nullptr for an invalid index
+    */
+    const char* getRecord(int index, int& sizeInBytes) const
+    {
+        sizeInBytes = 0;
+        if (!juce::isPositiveAndBelow(index, size()))
+            return nullptr;
+
+        const auto& entry = entries[(size_t) index];
+        sizeInBytes = entry.recordSize;
+        return data + recordsStart + entry.recordOffset;
+    }
+
+    /** Decodes the parameter values and non-parameter children of a preset. */
+    bool decode(int index, BinaryState::State& result) const
+    {
+        int recordSize = 0;
+        auto* record = getRecord(index, recordSize);
+        return record != nullptr && BinaryState::readParameters(record, recordSize, result);
+    }
+
+private:
+    void readIndex()
+    {
+        juce::MemoryInputStream input(data, (size_t) dataSize, false);
+
+        if (dataSize < 2 * (int) sizeof(int) || input.readInt() != MAGIC)
+        {
+            DBG("Factory presets: missing or invalid FactoryPresets.bin");
+            return;
+        }
+
+        int version = input.readInt();
+        if (version < 1 || version > VERSION)
+        {
+            DBG("Factory presets: unsupported version " + juce::String(version));
+            return;
+        }
+
+        int numPresets = input.readCompressedInt();
+        if (numPresets < 0 || numPresets > dataSize)
+            return;
+
+        entries.resize((size_t) numPresets);
+        for (auto& entry : entries)
+        {
+            entry.name = input.readString();
+            entry.category = input.readString();
+            entry.author = input.readString();
+            entry.creationDate = input.readString();
+            entry.description = input.readString();
+            entry.tags = juce::StringArray::fromTokens(input.readString(), ",", "");
+            entry.tags.trim();
+            entry.tags.removeEmptyStrings();
+            entry.recordOffset = input.readInt();
+            entry.recordSize = input.readInt();
+        }
+
+        recordsStart = (int) input.getPosition();
+
+        // A truncated pack lists nothing rather than decoding past its end
+        for (const auto& entry : entries)
+        {
+            if (entry.recordOffset < 0 || entry.recordSize < 0
+                || recordsStart + entry.recordOffset + entry.recordSize > dataSize)
+            {
+                DBG("Factory presets: truncated FactoryPresets.bin");
+                entries.clear();
+                return;
+            }
+        }
+    }
+
+    const char* data;
+    int dataSize;
+    int recordsStart = 0;
+    std::vector<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FactoryPresetBank)
+};
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    GlowSpriteCache.h
+    Pre-rendered glow strokes for static shapes
+
+    GlowEffect::drawStrokeWithGlow strokes several blurred passes every time it
+    is called. For shapes that only change on resize (section borders, frames)
+    the result is rendered once into an ARGB image at the display's physical
+    scale and blitted on every paint, with the per-frame intensity applied as
+    opacity. The sprite is re-rendered only when the path, style or scale
+    changes. Genuinely dynamic paths (waveform segments) stay stroked live.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "GlowEffect.h"
+
+class GlowSprite
+{
+public:
+    struct Style
+    {
+        juce::Colour colour;
+        float width = 2.0f;
+        juce::Colour glowColour;
+        float glowWidth = 4.0f;
+
+        bool operator== (const Style& other) const
+        {
+            return colour == other.colour && width == other.width
+                && glowColour == other.glowColour && glowWidth == other.glowWidth;
+        }
+        bool operator!= (const Style& other) const { return !operator== (other); }
+    };
+
+    /**
+        Draws the glowing stroke of a path, re-rendering the sprite only if needed.
+
+        @param g            Target graphics (component coordinates)
+        @param path         Shape to stroke, in component coordinates (or relative to offset)
+        @param style        Stroke and glow colours/widths
+        @param opacity      Intensity of this frame, 0 - 1
+        @param offset       Translation applied when blitting, so one sprite can be
+                            reused for a shape that only moves (e.g. a playhead line)
+    */
+    void draw(juce::Graphics& g, const juce::Path& path, const Style& style,
+              float opacity = 1.0f, juce::Point<float> offset = {})
+    {
+        drawSprite(g, path, style, false, opacity, offset);
+    }
+
+    /**
+        Draws a glowing line with GlowEffect::drawGlowingLine (whose look differs
+        from a stroked path), re-rendering the sprite only if needed.
+    */
+    void drawLine(juce::Graphics& g, juce::Point<float> start, juce::Point<float> end, const Style& style,
+                  float opacity = 1.0f, juce::Point<float> offset = {})
+    {
+        juce::Path line;
+        line.startNewSubPath(start);
+        line.lineTo(end);
+        drawSprite(g, line, style, true, opacity, offset);
+    }
+
+    // Forces a re-render at the next draw (e.g. after a look-and-feel change)
+    void invalidate() { sprite = {}; }
+
+private:
+    void drawSprite(juce::Graphics& g, const juce::Path& path, const Style& style, bool isLine,
+                    float opacity, juce::Point<float> offset)
+    {
+        if (opacity <= 0.0f || path.isEmpty())
+            return;
+
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (scale != cachedScale || style != cachedStyle || isLine != cachedIsLine || path != cachedPath || sprite.isNull())
+            render(path, style, isLine, scale);
+
+        g.saveState();
+        g.setOpacity(juce::jmin(1.0f, opacity));
+        g.drawImage(sprite, spriteArea + offset);
+        g.restoreState();
+    }
+
+    void render(const juce::Path& path, const Style& style, bool isLine, float scale)
+    {
+        cachedPath = path;
+        cachedStyle = style;
+        cachedIsLine = isLine;
+        cachedScale = scale;
+
+        // Leave room for the outermost glow pass around the stroke
+        float margin = style.width + style.glowWidth * 2.0f + 2.0f;
+        spriteArea = path.getBounds().expanded(margin).getSmallestIntegerContainer().toFloat();
+
+        int w = juce::jmax(1, juce::roundToInt(spriteArea.getWidth() * scale));
+        int h = juce::jmax(1, juce::roundToInt(spriteArea.getHeight() * scale));
+        sprite = juce::Image(juce::Image::ARGB, w, h, true);
+
+        juce::Graphics spriteGraphics(sprite);
+        spriteGraphics.addTransform(juce::AffineTransform::translation(-spriteArea.getX(), -spriteArea.getY())
+                                        .scaled(scale));
+        if (isLine)
+        {
+            // A line path holds exactly its two end points
+            juce::Path::Iterator points(path);
+            points.next();
+            juce::Point<float> start(points.x1, points.y1);
+            points.next();
+            juce::Point<float> end(points.x1, points.y1);
+
+            GlowEffect::drawGlowingLine(spriteGraphics, start, end,
+                                        style.colour, style.width,
+                                        style.glowColour, style.glowWidth);
+        }
+        else
+        {
+            GlowEffect::drawStrokeWithGlow(spriteGraphics, path,
+                                            style.colour, style.width,
+                                            style.glowColour, style.glowWidth);
+        }
+    }
+
+    juce::Image sprite;
+    juce::Rectangle<float> spriteArea;
+    juce::Path cachedPath;
+    Style cachedStyle;
+    bool cachedIsLine = false;
+    float cachedScale = 0.0f;
+};
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    LinkedState.h
+    Live parameter linking between instances in the same process
+
+    Instances join one of a fixed set of link channels (A-H). Each linked
+    instance compares its parameters once per block against what it last
+    sent or received and publishes the differences as (index, value)
+    changes; then it applies every change on the channel since its last
+    block, in channel order, through the batched write path. Because an
+    instance publishes before it applies and applies its own changes too,
+    edits made on two instances at once settle on the later one everywhere.
+
+    A channel is a ring of changes, each packed into a single 64-bit atomic
+    (value, parameter index, position tag), so publishing from any instance
+    and reading are lock-free and never tear. A reader that fell a whole
+    ring behind (an instance that was not processed for a while) catches up
+    from the channel's latest value per parameter instead.
+
+    Parameter indices are ParameterTable indices, which are the same for
+    every instance of the same build. Session parameters are never linked;
+    each instance can also keep its mix and its tuning to itself.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include "ParameterTable.h"
+
+class LinkedStateRegistry
+{
+public:
+    static constexpr int NUM_CHANNELS = 8;              // Link parameter: 0 = off, 1-8 = A-H
+    static constexpr int RING_SIZE = 1024;              // Changes a reader may fall behind
+    static constexpr int MAX_PARAMETERS = 1024;
+
+    LinkedStateRegistry()
+    {
+        for (auto& channel : channels)
+        {
+            channel.writePosition.store(0);
+            for (size_t i = 0; i < channel.ring.size(); ++i)
+                channel.ring[i].store(pack((juce::uint64) i - RING_SIZE, 0, 0.0f));     // Tagged as the lap before position 0
+            for (size_t i = 0; i < channel.latest.size(); ++i)
+            {
+                channel.latest[i].store(0.0f);
+                channel.hasLatest[i].store(false);
+            }
+        }
+    }
+
+    static bool isValidChannel(int channel) { return channel >= 1 && channel <= NUM_CHANNELS; }
+
+    // Position the next change will be published at (a new reader starts here)
+    juce::uint64 getWritePosition(int channel) const
+    {
+        return isValidChannel(channel) ? channels[(size_t) channel - 1].writePosition.load(std::memory_order_acquire) : 0;
+    }
+
+    // Any thread, any number of publishers
+    void publish(int channel, int index, float value)
+    {
+        if (!isValidChannel(channel) || !juce::isPositiveAndBelow(index, MAX_PARAMETERS))
+            return;
+
+        auto& c = channels[(size_t) channel - 1];
+        auto position = c.writePosition.fetch_add(1, std::memory_order_acq_rel);
+        c.latest[(size_t) index].store(value, std::memory_order_relaxed);
+        c.hasLatest[(size_t) index].store(true, std::memory_order_relaxed);
+        c.ring[(size_t) (position % RING_SIZE)].store(pack(position, index, value), std::memory_order_release);
+    }
+
+    /**
+        Calls apply(index, value) for the changes published on channel from
+        readPosition on, in order. Stops early at a change that is still being
+        written; it is picked up by the next call.
+
+        @return     The position to continue reading from
+    */
+    template <typename ApplyFunction>
+    juce::uint64 receive(int channel, juce::uint64 readPosition, ApplyFunction&& apply) const
+    {
+        if (!isValidChannel(channel))
+            return readPosition;
+
+        const auto& c = channels[(size_t) channel - 1];
+        auto end = c.writePosition.load(std::memory_order_acquire);
+
+        // Overwritten before they were read: catch up from the latest values instead
+        if (end - readPosition > (juce::uint64) RING_SIZE)
+        {
+            for (size_t i = 0; i < c.latest.size(); ++i)
+            {
+                if (c.hasLatest[i].load(std::memory_order_relaxed))
+                    apply((int) i, c.latest[i].load(std::memory_order_relaxed));
+            }
+            return end;
+        }
+
+        for (; readPosition < end; ++readPosition)
+        {
+            auto packed = c.ring[(size_t) (readPosition % RING_SIZE)].load(std::memory_order_acquire);
+            if ((packed & TAG_MASK) != (readPosition & TAG_MASK))
+                break;
+
+            apply(static_cast<int>((packed >> 16) & 0xffff), unpackValue(packed));
+        }
+
+        return readPosition;
+    }
+
+private:
+    // Bit layout: 0-15 position tag, 16-31 parameter index, 32-63 value (float bits)
+    static constexpr juce::uint64 TAG_MASK = 0xffff;
+
+    static juce::uint64 pack(juce::uint64 position, int index, float value)
+    {
+        juce::uint32 valueBits;
+        std::memcpy(&valueBits, &value, sizeof(valueBits));
+        return (position & TAG_MASK) | (static_cast<juce::uint64>(index & 0xffff) << 16) | (static_cast<juce::uint64>(valueBits) << 32);
+    }
+
+    static float unpackValue(juce::uint64 packed)
+    {
+        auto valueBits = static_cast<juce::uint32>(packed >> 32);
+        float value;
+        std::memcpy(&value, &valueBits, sizeof(value));
+        return value;
+    }
+
+    struct Channel
+    {
+        std::atomic<juce::uint64> writePosition;
+        std::array<std::atomic<juce::uint64>, RING_SIZE> ring;
+        std::array<std::atomic<float>, MAX_PARAMETERS> latest;
+        std::array<std::atomic<bool>, MAX_PARAMETERS> hasLatest;
+    };
+
+    std::array<Channel, NUM_CHANNELS> channels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinkedStateRegistry)
+};
+
+//==============================================================================
+/**
+    One instance's side of a link channel (audio thread after prepare()).
+*/
+class LinkedStateMember
+{
+public:
+    enum Exclusion
+    {
+        ExcludeMix = 1,         // MixMode, GainCompensation
+        ExcludeTuning = 2       // Nano base, tuning system, scale, ratios and active slots
+    };
+
+    /**
+        Message thread, before use.
+
+        @param neverLinked      Parameter IDs that are never sent or applied (session parameters)
+    */
+    void prepare(const ParameterTable& tableToUse, const juce::StringArray& neverLinked)
+    {
+        table = &tableToUse;
+        jassert(table->size() <= LinkedStateRegistry::MAX_PARAMETERS);
+
+        auto size = (size_t) table->size();
+        exclusionOf.assign(size, 0);
+        for (int i = 0; i < table->size(); ++i)
+        {
+            auto id = table->getID(i);
+            if (neverLinked.contains(id))
+                exclusionOf[(size_t) i] = ALWAYS_EXCLUDED;
+            else if (id == "MixMode" || id == "GainCompensation")
+                exclusionOf[(size_t) i] = ExcludeMix;
+            else if (id == "nanoBase" || id == "tuningSystem" || id == "scale"
+                     || id.startsWith("nanoRatio_") || id.startsWith("nanoActive_"))
+                exclusionOf[(size_t) i] = ExcludeTuning;
+        }
+
+        sent.assign(size, 0.0f);
+    }
+
+    // True for parameters the editor shows through its tuning displays (ratios, scale)
+    bool isTuningParameter(int index) const { return exclusionOf[(size_t) index] == ExcludeTuning; }
+
+    /**
+        Audio thread, once per block: publishes this instance's changes, then
+        calls write(parameterIndex, normalisedValue) for each change from the
+        channel that differs from the current value.
+
+        @param channel          Link channel, 0 = not linked
+        @param exclusions       Exclusion flags in effect for this instance
+        @return                 True if any parameter was written
+    */
+    template <typename WriteFunction>
+    bool process(LinkedStateRegistry& registry, int channel, int exclusions, WriteFunction&& write)
+    {
+        // Joining a channel (or changing what is linked) starts from the current state: nothing is sent
+        // for it, and only changes published from now on are applied
+        if (channel != joinedChannel || exclusions != joinedExclusions)
+        {
+            if (channel != joinedChannel)
+                readPosition = registry.getWritePosition(channel);
+
+            joinedChannel = channel;
+            joinedExclusions = exclusions;
+            for (int i = 0; i < table->size(); ++i)
+                sent[(size_t) i] = table->getParameter(i)->getValue();
+        }
+
+        if (!LinkedStateRegistry::isValidChannel(channel))
+            return false;
+
+        int excludedMask = exclusions | ALWAYS_EXCLUDED;
+
+        for (int i = 0; i < table->size(); ++i)
+        {
+            if ((exclusionOf[(size_t) i] & excludedMask) != 0)
+                continue;
+
+            float value = table->getParameter(i)->getValue();
+            if (value != sent[(size_t) i])
+            {
+                registry.publish(channel, i, value);
+                sent[(size_t) i] = value;
+            }
+        }
+
+        bool wrote = false;
+        readPosition = registry.receive(channel, readPosition, [&](int index, float value)
+        {
+            if (index >= table->size() || (exclusionOf[(size_t) index] & excludedMask) != 0)
+                return;
+
+            sent[(size_t) index] = value;
+            if (table->getParameter(index)->getValue() != value)
+            {
+                write(index, value);
+                wrote = true;
+            }
+        });
+
+        return wrote;
+    }
+
+private:
+    static constexpr juce::uint8 ALWAYS_EXCLUDED = 0x80;
+
+    const ParameterTable* table = nullptr;
+    std::vector<juce::uint8> exclusionOf;       // Exclusion flag per parameter (0 = always linked)
+    std::vector<float> sent;                    // Last value sent or received, per parameter
+
+    int joinedChannel = 0;
+    int joinedExclusions = 0;
+    juce::uint64 readPosition = 0;
+};
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    PaintProfiler.h
+    Debug-build paint timing for editor components
+
+    A component keeps a PaintProfiler member and opens a Scope at the top of
+    paint(). Every REPORT_INTERVAL paints the mean, min and max paint time are
+    logged with DBG, together with the display scale they were measured at,
+    so paint regressions show up in the debug log at 1x and 2x alike.
+
+    Compiles to nothing in release builds.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class PaintProfiler
+{
+public:
+    static constexpr int REPORT_INTERVAL = 200;
+
+    explicit PaintProfiler(const char* componentName) : name(componentName)
+    {
+        juce::ignoreUnused(name);
+    }
+
+    class Scope
+    {
+    public:
+        Scope(PaintProfiler& profilerToUse, juce::Graphics& g)
+           #if JUCE_DEBUG
+            : profiler(profilerToUse),
+              scale(g.getInternalContext().getPhysicalPixelScaleFactor()),
+              startTicks(juce::Time::getHighResolutionTicks())
+           #endif
+        {
+            juce::ignoreUnused(profilerToUse, g);
+        }
+
+       #if JUCE_DEBUG
+        ~Scope()
+        {
+            profiler.addMeasurement(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0,
+                                    scale);
+        }
+
+    private:
+        PaintProfiler& profiler;
+        float scale;
+        juce::int64 startTicks;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+private:
+   #if JUCE_DEBUG
+    void addMeasurement(double ms, float scale)
+    {
+        // Scale changes (window moved to another display) start a new report
+        if (scale != reportScale)
+        {
+            reportScale = scale;
+            count = 0;
+        }
+
+        if (count == 0)
+        {
+            totalMs = 0.0;
+            minMs = ms;
+            maxMs = ms;
+        }
+
+        totalMs += ms;
+        minMs = juce::jmin(minMs, ms);
+        maxMs = juce::jmax(maxMs, ms);
+
+        if (++count >= REPORT_INTERVAL)
+        {
+            DBG("Paint " << name << " @" << juce::String(reportScale, 2) << "x: mean "
+                << juce::String(totalMs / count, 3) << " ms, min " << juce::String(minMs, 3)
+                << " ms, max " << juce::String(maxMs, 3) << " ms (" << count << " paints)");
+            count = 0;
+        }
+    }
+
+    int count = 0;
+    double totalMs = 0.0, minMs = 0.0, maxMs = 0.0;
+    float reportScale = 0.0f;
+   #endif
+
+    const char* name;
+};
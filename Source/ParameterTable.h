@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    ParameterTable.h
+    Flat, index-addressed view of the plugin's parameters
+
+    Built once from the processor's parameter list. Everything that moves
+    whole parameter sets around (preset morphing, state slots, state
+    restore) works on std::vector<float> of normalised values in this
+    index order instead of string-keyed lookups.
+
+    Continuous parameters are AudioParameterFloats without a step interval;
+    choices, bools and stepped floats (octaves, Euclidean steps) are
+    discrete and are switched rather than interpolated.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+class ParameterTable
+{
+public:
+    explicit ParameterTable(juce::AudioProcessor& processor)
+    {
+        for (auto* parameter : processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(ranged);
+                bool continuous = floatParameter != nullptr && floatParameter->range.interval <= 0.0f;
+
+                indexByID.set(ranged->getParameterID(), (int) entries.size());
+                entries.push_back({ ranged, continuous });
+            }
+        }
+    }
+
+    int size() const                                            { return (int) entries.size(); }
+    juce::RangedAudioParameter* getParameter(int index) const   { return entries[(size_t) index].parameter; }
+    juce::String getID(int index) const                         { return entries[(size_t) index].parameter->getParameterID(); }
+    bool isContinuous(int index) const                          { return entries[(size_t) index].continuous; }
+
+    // -1 if there is no parameter with this ID
+    int indexOf(const juce::String& parameterID) const          { return indexByID.contains(parameterID) ? indexByID[parameterID] : -1; }
+
+    // Current normalised values, in table order
+    std::vector<float> capture() const
+    {
+        std::vector<float> values;
+        values.reserve(entries.size());
+        for (const auto& entry : entries)
+            values.push_back(entry.parameter->getValue());
+        return values;
+    }
+
+    // Normalised default values, in table order
+    std::vector<float> getDefaults() const
+    {
+        std::vector<float> values;
+        values.reserve(entries.size());
+        for (const auto& entry : entries)
+            values.push_back(entry.parameter->getDefaultValue());
+        return values;
+    }
+
+private:
+    struct Entry
+    {
+        juce::RangedAudioParameter* parameter;
+        bool continuous;
+    };
+
+    std::vector<Entry> entries;
+    juce::HashMap<juce::String, int> indexByID;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterTable)
+};
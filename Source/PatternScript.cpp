@@ -0,0 +1,598 @@
+/*
+  ==============================================================================
+
+    PatternScript.cpp
+    Compiler and VM for the pattern scripting language
+
+  ==============================================================================
+*/
+
+#include "PatternScript.h"
+#include <vector>
+
+namespace PatternScript
+{
+    namespace
+    {
+        //======================================================================
+        // Name tables
+        //======================================================================
+
+        struct NamedRegister
+        {
+            const char* name;
+            int index;
+        };
+
+        const std::array<NamedRegister, 11> registerNames = {{
+            { "bar", Bar }, { "beat", Beat }, { "unit", Unit }, { "quant", Quant }, { "last", Last },
+            { "chance", Chance }, { "revchance", RevChance }, { "blend", Blend },
+            { "fire", Fire }, { "rate", Rate }, { "reverse", Reverse }
+        }};
+
+        struct NamedFunction
+        {
+            const char* name;
+            OpCode op;
+            int arity;
+        };
+
+        const std::array<NamedFunction, 6> functionNames = {{
+            { "rand", OpCode::Rand, 0 }, { "floor", OpCode::Floor, 1 }, { "abs", OpCode::Abs, 1 },
+            { "min", OpCode::Min, 2 }, { "max", OpCode::Max, 2 }, { "nano", OpCode::Nano, 1 }
+        }};
+
+        // Number of stack values an opcode consumes (each pushes at most one)
+        int getPopCount(OpCode op)
+        {
+            switch (op)
+            {
+                case OpCode::PushConst:
+                case OpCode::Load:
+                case OpCode::Jump:
+                case OpCode::Rand:
+                case OpCode::Halt:
+                    return 0;
+                case OpCode::Store:
+                case OpCode::Neg:
+                case OpCode::Not:
+                case OpCode::JumpIfFalse:
+                case OpCode::Floor:
+                case OpCode::Abs:
+                case OpCode::Nano:
+                    return 1;
+                default:
+                    return 2;
+            }
+        }
+
+        // Number of stack values an opcode leaves behind (0 or 1)
+        int getPushCount(OpCode op)
+        {
+            switch (op)
+            {
+                case OpCode::Store:
+                case OpCode::Jump:
+                case OpCode::JumpIfFalse:
+                case OpCode::Halt:
+                    return 0;
+                default:
+                    return 1;
+            }
+        }
+
+        //======================================================================
+        // Recursive-descent compiler
+        //======================================================================
+
+        class Compiler
+        {
+        public:
+            Compiler(const juce::String& sourceText, Program& target)
+                : program(target)
+            {
+                tokenize(sourceText);
+            }
+
+            juce::Result run()
+            {
+                program = Program();
+
+                while (!hasError() && current().type != Token::End)
+                    parseStatement();
+
+                emit(OpCode::Halt);
+
+                if (hasError())
+                {
+                    program.isValid = false;
+                    return juce::Result::fail(error);
+                }
+
+                program.isValid = program.codeSize > 1;  // Empty script: built-in behaviour
+                return juce::Result::ok();
+            }
+
+        private:
+            struct Token
+            {
+                enum Type { End, Number, Identifier, Symbol } type = End;
+                juce::String text;
+                float value = 0.0f;
+                int line = 1;
+            };
+
+            Program& program;
+            std::vector<Token> tokens;
+            size_t position = 0;
+            int depth = 0;
+            int stackDepth = 0;     // Values on the VM stack after the last emitted instruction
+            juce::StringArray localNames;
+            juce::String error;
+
+            // Bounds the recursion of the recursive-descent parser on deeply nested input
+            struct NestingScope
+            {
+                explicit NestingScope(Compiler& c) : compiler(c)
+                {
+                    if (++compiler.depth > MAX_NESTING_DEPTH)
+                        compiler.fail("nesting is too deep");
+                }
+                ~NestingScope() { --compiler.depth; }
+
+                Compiler& compiler;
+            };
+
+            //==================================================================
+            // Lexer
+
+            void tokenize(const juce::String& sourceText)
+            {
+                auto text = sourceText.getCharPointer();
+                int line = 1;
+
+                while (!text.isEmpty() && error.isEmpty())
+                {
+                    auto c = *text;
+
+                    if (c == '\n')
+                    {
+                        ++line;
+                        ++text;
+                    }
+                    else if (juce::CharacterFunctions::isWhitespace(c) || c == ';')
+                    {
+                        ++text;
+                    }
+                    else if (c == '#' || (c == '/' && text[1] == '/'))
+                    {
+                        // Comment to end of line
+                        while (!text.isEmpty() && *text != '\n')
+                            ++text;
+                    }
+                    else if (juce::CharacterFunctions::isDigit(c) || (c == '.' && juce::CharacterFunctions::isDigit(text[1])))
+                    {
+                        juce::String number;
+                        while (juce::CharacterFunctions::isDigit(*text) || *text == '.')
+                            number += *text++;
+                        tokens.push_back({ Token::Number, number, number.getFloatValue(), line });
+                    }
+                    else if (juce::CharacterFunctions::isLetter(c) || c == '_')
+                    {
+                        juce::String name;
+                        while (juce::CharacterFunctions::isLetterOrDigit(*text) || *text == '_')
+                            name += *text++;
+                        tokens.push_back({ Token::Identifier, name, 0.0f, line });
+                    }
+                    else
+                    {
+                        static const juce::StringArray twoCharSymbols { "==", "!=", "<=", ">=", "&&", "||" };
+                        juce::String pair = juce::String::charToString(c) + juce::String::charToString(text[1]);
+
+                        if (twoCharSymbols.contains(pair))
+                        {
+                            tokens.push_back({ Token::Symbol, pair, 0.0f, line });
+                            text += 2;
+                        }
+                        else if (juce::String("+-*/%<>!=(){},").containsChar(c))
+                        {
+                            tokens.push_back({ Token::Symbol, juce::String::charToString(c), 0.0f, line });
+                            ++text;
+                        }
+                        else
+                        {
+                            error = "Line " + juce::String(line) + ": unexpected character '" + juce::String::charToString(c) + "'";
+                        }
+                    }
+                }
+
+                tokens.push_back({ Token::End, {}, 0.0f, line });
+            }
+
+            //==================================================================
+            // Helpers
+
+            bool hasError() const { return error.isNotEmpty(); }
+
+            const Token& current() const { return tokens[juce::jmin(position, tokens.size() - 1)]; }
+
+            void fail(const juce::String& message)
+            {
+                if (!hasError())
+                    error = "Line " + juce::String(current().line) + ": " + message;
+            }
+
+            bool match(const juce::String& symbol)
+            {
+                const auto& token = current();
+                if ((token.type == Token::Symbol || token.type == Token::Identifier) && token.text == symbol)
+                {
+                    ++position;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(const juce::String& symbol)
+            {
+                if (!match(symbol))
+                    fail("expected '" + symbol + "'");
+            }
+
+            int emit(OpCode op, int arg = 0)
+            {
+                if (program.codeSize >= MAX_CODE_SIZE)
+                {
+                    fail("script is too long");
+                    return 0;
+                }
+                program.code[program.codeSize] = { op, static_cast<juce::int16>(arg) };
+
+                // Jumps only happen between statements, where the stack is empty, so the
+                // depth at each instruction is known here and the VM can never overflow
+                stackDepth += getPushCount(op) - getPopCount(op);
+                if (stackDepth > MAX_STACK_DEPTH)
+                    fail("expression is too complex");
+
+                return program.codeSize++;
+            }
+
+            void emitConstant(float value)
+            {
+                for (int i = 0; i < program.numConstants; ++i)
+                {
+                    if (program.constants[i] == value)
+                    {
+                        emit(OpCode::PushConst, i);
+                        return;
+                    }
+                }
+
+                if (program.numConstants >= MAX_CONSTANTS)
+                {
+                    fail("too many constants");
+                    return;
+                }
+                program.constants[program.numConstants] = value;
+                emit(OpCode::PushConst, program.numConstants++);
+            }
+
+            void patchJump(int instruction) { program.code[instruction].arg = static_cast<juce::int16>(program.codeSize); }
+
+            int findRegister(const juce::String& name) const
+            {
+                for (const auto& entry : registerNames)
+                    if (name == entry.name)
+                        return entry.index;
+
+                int local = localNames.indexOf(name);
+                return local >= 0 ? FirstLocal + local : -1;
+            }
+
+            //==================================================================
+            // Statements
+
+            void parseStatement()
+            {
+                if (match("if"))
+                {
+                    parseIf();
+                    return;
+                }
+
+                const auto token = current();
+                if (token.type != Token::Identifier)
+                {
+                    fail("expected a statement");
+                    return;
+                }
+                ++position;
+                expect("=");
+                parseExpression();
+
+                int reg = findRegister(token.text);
+                if (reg < 0)
+                {
+                    if (localNames.size() >= MAX_LOCALS)
+                    {
+                        fail("too many local variables");
+                        return;
+                    }
+                    localNames.add(token.text);
+                    reg = FirstLocal + localNames.size() - 1;
+                }
+                else if (reg < NumInputs)
+                {
+                    fail("'" + token.text + "' is read-only");
+                    return;
+                }
+
+                emit(OpCode::Store, reg);
+            }
+
+            void parseIf()
+            {
+                const NestingScope scope(*this);
+                if (hasError())
+                    return;
+
+                parseExpression();
+                int jumpToElse = emit(OpCode::JumpIfFalse);
+                parseBlock();
+
+                if (match("else"))
+                {
+                    int jumpToEnd = emit(OpCode::Jump);
+                    patchJump(jumpToElse);
+
+                    if (match("if"))
+                        parseIf();
+                    else
+                        parseBlock();
+
+                    patchJump(jumpToEnd);
+                }
+                else
+                {
+                    patchJump(jumpToElse);
+                }
+            }
+
+            void parseBlock()
+            {
+                expect("{");
+                while (!hasError() && !match("}"))
+                {
+                    if (current().type == Token::End)
+                    {
+                        fail("missing '}'");
+                        return;
+                    }
+                    parseStatement();
+                }
+            }
+
+            //==================================================================
+            // Expressions (lowest to highest precedence)
+
+            void parseExpression() { parseOr(); }
+
+            void parseOr()
+            {
+                parseAnd();
+                while (!hasError() && (match("||") || match("or")))
+                {
+                    parseAnd();
+                    emit(OpCode::Or);
+                }
+            }
+
+            void parseAnd()
+            {
+                parseComparison();
+                while (!hasError() && (match("&&") || match("and")))
+                {
+                    parseComparison();
+                    emit(OpCode::And);
+                }
+            }
+
+            void parseComparison()
+            {
+                parseAdditive();
+
+                static const std::array<std::pair<const char*, OpCode>, 6> comparisons = {{
+                    { "==", OpCode::Equal }, { "!=", OpCode::NotEqual }, { "<=", OpCode::LessEqual },
+                    { ">=", OpCode::GreaterEqual }, { "<", OpCode::Less }, { ">", OpCode::Greater }
+                }};
+
+                for (const auto& [symbol, op] : comparisons)
+                {
+                    if (match(symbol))
+                    {
+                        parseAdditive();
+                        emit(op);
+                        return;
+                    }
+                }
+            }
+
+            void parseAdditive()
+            {
+                parseMultiplicative();
+                while (!hasError())
+                {
+                    if (match("+"))      { parseMultiplicative(); emit(OpCode::Add); }
+                    else if (match("-")) { parseMultiplicative(); emit(OpCode::Sub); }
+                    else break;
+                }
+            }
+
+            void parseMultiplicative()
+            {
+                parseUnary();
+                while (!hasError())
+                {
+                    if (match("*"))      { parseUnary(); emit(OpCode::Mul); }
+                    else if (match("/")) { parseUnary(); emit(OpCode::Div); }
+                    else if (match("%")) { parseUnary(); emit(OpCode::Mod); }
+                    else break;
+                }
+            }
+
+            void parseUnary()
+            {
+                const NestingScope scope(*this);
+                if (hasError())
+                    return;
+
+                if (match("-"))                     { parseUnary(); emit(OpCode::Neg); }
+                else if (match("!") || match("not")) { parseUnary(); emit(OpCode::Not); }
+                else                                 parsePrimary();
+            }
+
+            void parsePrimary()
+            {
+                const auto token = current();
+
+                if (token.type == Token::Number)
+                {
+                    ++position;
+                    emitConstant(token.value);
+                }
+                else if (match("("))
+                {
+                    parseExpression();
+                    expect(")");
+                }
+                else if (token.type == Token::Identifier)
+                {
+                    ++position;
+
+                    if (token.text == "true" || token.text == "false")
+                    {
+                        emitConstant(token.text == "true" ? 1.0f : 0.0f);
+                    }
+                    else if (match("("))
+                    {
+                        parseCall(token.text);
+                    }
+                    else
+                    {
+                        int reg = findRegister(token.text);
+                        if (reg < 0)
+                            fail("unknown variable '" + token.text + "'");
+                        else
+                            emit(OpCode::Load, reg);
+                    }
+                }
+                else
+                {
+                    fail("expected a value");
+                }
+            }
+
+            void parseCall(const juce::String& name)
+            {
+                const NamedFunction* function = nullptr;
+                for (const auto& entry : functionNames)
+                    if (name == entry.name)
+                        function = &entry;
+
+                if (function == nullptr)
+                {
+                    fail("unknown function '" + name + "'");
+                    return;
+                }
+
+                int numArgs = 0;
+                if (!match(")"))
+                {
+                    do
+                    {
+                        parseExpression();
+                        ++numArgs;
+                    } while (!hasError() && match(","));
+                    expect(")");
+                }
+
+                if (numArgs != function->arity)
+                    fail("'" + name + "' takes " + juce::String(function->arity) + " argument(s)");
+                else
+                    emit(function->op);
+            }
+        };
+    }
+
+    //==========================================================================
+    juce::Result compile(const juce::String& source, Program& program)
+    {
+        Compiler compiler(source, program);
+        return compiler.run();
+    }
+
+    //==========================================================================
+    bool execute(const Program& program, Registers& registers, juce::Random& random)
+    {
+        if (!program.isValid)
+            return false;
+
+        std::array<float, MAX_STACK_DEPTH> stack;
+        int sp = 0;
+        int pc = 0;
+
+        auto pop = [&]() { return stack[--sp]; };
+
+        for (int budget = INSTRUCTION_BUDGET; budget > 0; --budget)
+        {
+            if (!juce::isPositiveAndBelow(pc, program.codeSize))
+                return false;
+
+            const auto& instruction = program.code[pc++];
+
+            // Stack bounds: underflow on pop, overflow on the (at most one) push
+            int pops = getPopCount(instruction.op);
+            if (sp < pops || sp - pops >= MAX_STACK_DEPTH)
+                return false;
+
+            switch (instruction.op)
+            {
+                case OpCode::PushConst:   stack[sp++] = program.constants[instruction.arg]; break;
+                case OpCode::Load:        stack[sp++] = registers[instruction.arg]; break;
+                case OpCode::Store:       registers[instruction.arg] = pop(); break;
+
+                case OpCode::Add:         { float b = pop(), a = pop(); stack[sp++] = a + b; break; }
+                case OpCode::Sub:         { float b = pop(), a = pop(); stack[sp++] = a - b; break; }
+                case OpCode::Mul:         { float b = pop(), a = pop(); stack[sp++] = a * b; break; }
+                case OpCode::Div:         { float b = pop(), a = pop(); stack[sp++] = b != 0.0f ? a / b : 0.0f; break; }
+                case OpCode::Mod:         { float b = pop(), a = pop(); stack[sp++] = b != 0.0f ? std::fmod(a, b) : 0.0f; break; }
+                case OpCode::Less:        { float b = pop(), a = pop(); stack[sp++] = a < b ? 1.0f : 0.0f; break; }
+                case OpCode::LessEqual:   { float b = pop(), a = pop(); stack[sp++] = a <= b ? 1.0f : 0.0f; break; }
+                case OpCode::Greater:     { float b = pop(), a = pop(); stack[sp++] = a > b ? 1.0f : 0.0f; break; }
+                case OpCode::GreaterEqual:{ float b = pop(), a = pop(); stack[sp++] = a >= b ? 1.0f : 0.0f; break; }
+                case OpCode::Equal:       { float b = pop(), a = pop(); stack[sp++] = a == b ? 1.0f : 0.0f; break; }
+                case OpCode::NotEqual:    { float b = pop(), a = pop(); stack[sp++] = a != b ? 1.0f : 0.0f; break; }
+                case OpCode::And:         { float b = pop(), a = pop(); stack[sp++] = (a != 0.0f && b != 0.0f) ? 1.0f : 0.0f; break; }
+                case OpCode::Or:          { float b = pop(), a = pop(); stack[sp++] = (a != 0.0f || b != 0.0f) ? 1.0f : 0.0f; break; }
+
+                case OpCode::Neg:         stack[sp - 1] = -stack[sp - 1]; break;
+                case OpCode::Not:         stack[sp - 1] = stack[sp - 1] == 0.0f ? 1.0f : 0.0f; break;
+
+                case OpCode::Jump:        pc = instruction.arg; break;
+                case OpCode::JumpIfFalse: if (pop() == 0.0f) pc = instruction.arg; break;
+
+                case OpCode::Rand:        stack[sp++] = random.nextFloat(); break;
+                case OpCode::Floor:       stack[sp - 1] = std::floor(stack[sp - 1]); break;
+                case OpCode::Abs:         stack[sp - 1] = std::abs(stack[sp - 1]); break;
+                case OpCode::Nano:        stack[sp - 1] = static_cast<float>(FIRST_NANO_SLOT) + std::floor(stack[sp - 1]); break;
+                case OpCode::Min:         { float b = pop(), a = pop(); stack[sp++] = juce::jmin(a, b); break; }
+                case OpCode::Max:         { float b = pop(), a = pop(); stack[sp++] = juce::jmax(a, b); break; }
+
+                case OpCode::Halt:        return true;
+                default:                  return false;
+            }
+        }
+
+        return false;  // Instruction budget exhausted
+    }
+}
@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    PatternScript.h
+    Sandboxed pattern scripting for stutter decisions
+
+    A tiny expression language compiled on the message thread into bytecode
+    for a stack VM. The VM runs on the audio thread only at scheduling points,
+    never allocates, and aborts after a fixed instruction budget.
+
+    Example:
+        # Every 4th bar: 1/32 roll reversed, otherwise weighted random
+        if bar % 4 == 3 {
+            fire = 1
+            rate = 12
+            reverse = 1
+        }
+
+    Inputs (read-only):
+        bar, beat       Bar index and quarter-note position within the bar (4/4) of the next unit
+        unit            Absolute quant unit index of the next unit
+        quant           Current quant index (0 = 4 bars ... 8 = 1/32)
+        last            Rate slot of the previous event (-1 = none)
+        chance, revchance, blend    Current Chance, Reverse Chance and Repeat/Nano values
+
+    Outputs (read/write, preset to the built-in decision):
+        fire            Non-zero schedules the next unit
+        rate            Rate slot: 0-12 repeat rates, 13-24 nano rates, -1 = weighted random
+                        (an inactive slot also falls back to weighted random)
+        reverse         1 = reversed, 0 = forward, -1 = use Reverse Chance
+
+    Functions: rand(), floor(x), abs(x), min(a, b), max(a, b), nano(i)
+    Operators: + - * / %  == != < <= > >=  && || !   (and / or / not also accepted)
+    Any other assigned name becomes a local variable, reset to 0 on every run.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+namespace PatternScript
+{
+    //==========================================================================
+    // LIMITS
+    //==========================================================================
+
+    static constexpr int MAX_CODE_SIZE = 512;
+    static constexpr int MAX_CONSTANTS = 64;
+    static constexpr int MAX_LOCALS = 16;
+    static constexpr int MAX_STACK_DEPTH = 32;      // Checked at compile time; deeper expressions are rejected
+    static constexpr int INSTRUCTION_BUDGET = 1024;
+    static constexpr int MAX_NESTING_DEPTH = 64;    // Nested ifs, parentheses and unary operators
+    static constexpr int FIRST_NANO_SLOT = 13;      // Rate slots match RateMarkovChain
+
+    //==========================================================================
+    // REGISTERS (inputs, then outputs, then locals)
+    //==========================================================================
+
+    enum Register
+    {
+        Bar = 0,
+        Beat,
+        Unit,
+        Quant,
+        Last,
+        Chance,
+        RevChance,
+        Blend,
+        NumInputs,
+
+        Fire = NumInputs,
+        Rate,
+        Reverse,
+        FirstLocal,
+
+        NumRegisters = FirstLocal + MAX_LOCALS
+    };
+
+    using Registers = std::array<float, NumRegisters>;
+
+    //==========================================================================
+    // BYTECODE
+    //==========================================================================
+
+    enum class OpCode : juce::uint8
+    {
+        PushConst, Load, Store,
+        Add, Sub, Mul, Div, Mod, Neg, Not,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or,
+        Jump, JumpIfFalse,
+        Rand, Floor, Abs, Min, Max, Nano,
+        Halt
+    };
+
+    struct Instruction
+    {
+        OpCode op = OpCode::Halt;
+        juce::int16 arg = 0;
+    };
+
+    // Plain fixed-size program so it can be copied to the audio thread without allocation
+    struct Program
+    {
+        std::array<Instruction, MAX_CODE_SIZE> code {};
+        std::array<float, MAX_CONSTANTS> constants {};
+        int codeSize = 0;
+        int numConstants = 0;
+        bool isValid = false;
+    };
+
+    /**
+        Compiles script source into a program (message thread).
+
+        @param source       Script text
+        @param program      Receives the compiled program
+        @return             Ok, or a failure with a line-numbered error message
+    */
+    juce::Result compile(const juce::String& source, Program& program);
+
+    /**
+        Runs a program against the given registers (audio thread, allocation-free).
+
+        @return     False if the program is invalid, faulted or ran out of budget;
+                    outputs must then be ignored
+    */
+    bool execute(const Program& program, Registers& registers, juce::Random& random);
+
+    //==========================================================================
+    // ENGINE
+    //==========================================================================
+
+    /**
+        Holds the current script source and its compiled program, and hands the
+        program to the audio thread. The audio thread never blocks: if a new
+        program is being published, run() reports failure and the built-in
+        decision is used for that unit.
+    */
+    class Engine
+    {
+    public:
+        static inline const juce::Identifier stateType { "PATTERN_SCRIPT" };
+
+        /**
+            Message thread: compiles and publishes the new source.
+            While editing, the previous program and its source stay active on error, so
+            the stored source is always the one that runs; when restoring state, a failing
+            script is kept but disabled instead so stale programs never run.
+        */
+        juce::Result setSource(const juce::String& newSource, bool keepPreviousOnError = true)
+        {
+            auto scratch = std::make_unique<Program>();
+            auto result = compile(newSource, *scratch);
+            if (result.wasOk() || !keepPreviousOnError)
+            {
+                source = newSource;
+                const juce::SpinLock::ScopedLockType lock(programLock);
+                program = *scratch;
+            }
+            return result;
+        }
+
+        const juce::String& getSource() const { return source; }
+
+        // Audio thread
+        bool run(Registers& registers, juce::Random& random) const
+        {
+            const juce::SpinLock::ScopedTryLockType lock(programLock);
+            if (!lock.isLocked() || !program.isValid)
+                return false;
+            return execute(program, registers, random);
+        }
+
+        juce::ValueTree toValueTree() const
+        {
+            juce::ValueTree tree(stateType);
+            tree.setProperty("source", source, nullptr);
+            return tree;
+        }
+
+        juce::Result fromValueTree(const juce::ValueTree& tree)
+        {
+            return setSource(tree.isValid() ? tree.getProperty("source").toString() : juce::String(), false);
+        }
+
+    private:
+        juce::String source;
+        Program program;
+        mutable juce::SpinLock programLock;
+    };
+}
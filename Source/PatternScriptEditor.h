@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    PatternScriptEditor.h
+    Editing panel for the pattern script, shown in a call-out box
+
+    - Multi-line code editor (script syntax documented in PatternScript.h)
+    - Compile button: compiles on the message thread and reports errors
+    - Enabled toggle attached to the patternScriptEnabled parameter
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+class PatternScriptEditor : public juce::Component
+{
+public:
+    PatternScriptEditor(NanoStuttAudioProcessor& p) : processor(p)
+    {
+        addAndMakeVisible(codeEditor);
+        codeEditor.setMultiLine(true, false);
+        codeEditor.setReturnKeyStartsNewLine(true);
+        codeEditor.setTabKeyUsedAsCharacter(true);
+        codeEditor.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+        codeEditor.setTextToShowWhenEmpty("# e.g.  if bar % 4 == 3 { fire = 1; rate = 12; reverse = 1 }", juce::Colours::grey);
+        codeEditor.setText(processor.getPatternScriptSource(), false);
+
+        addAndMakeVisible(compileButton);
+        compileButton.setButtonText("Compile");
+        compileButton.onClick = [this]() { compileScript(); };
+
+        addAndMakeVisible(enabledToggle);
+        enabledToggle.setButtonText("Enabled");
+        enabledAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            processor.getParameters(), "patternScriptEnabled", enabledToggle);
+
+        addAndMakeVisible(statusLabel);
+        statusLabel.setFont(juce::FontOptions(12.0f));
+        statusLabel.setText("Inputs: bar beat unit quant last chance revchance blend  |  Outputs: fire rate reverse",
+                            juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+
+        setSize(460, 300);
+    }
+
+    void resized() override
+    {
+        auto bounds = getLocalBounds().reduced(6);
+
+        auto bottomRow = bounds.removeFromBottom(24);
+        compileButton.setBounds(bottomRow.removeFromRight(80));
+        bottomRow.removeFromRight(6);
+        enabledToggle.setBounds(bottomRow.removeFromRight(80));
+
+        statusLabel.setBounds(bounds.removeFromBottom(36));
+        codeEditor.setBounds(bounds.withTrimmedBottom(4));
+    }
+
+private:
+    void compileScript()
+    {
+        auto result = processor.setPatternScriptSource(codeEditor.getText());
+
+        if (result.wasOk())
+        {
+            statusLabel.setText("Compiled", juce::dontSendNotification);
+            statusLabel.setColour(juce::Label::textColourId, juce::Colours::lime);
+        }
+        else
+        {
+            // Previous program keeps running until the script compiles
+            statusLabel.setText(result.getErrorMessage(), juce::dontSendNotification);
+            statusLabel.setColour(juce::Label::textColourId, juce::Colours::orange);
+        }
+    }
+
+    NanoStuttAudioProcessor& processor;
+
+    juce::TextEditor codeEditor;
+    juce::TextButton compileButton;
+    juce::ToggleButton enabledToggle;
+    juce::Label statusLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> enabledAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatternScriptEditor)
+};
@@ -38,24 +38,109 @@ namespace
                 shape->setFill(juce::FillType(tintColour));
         }
     }
+
+    // Preset menu entry that reports when it is highlighted (hover previews)
+    class PresetMenuItem : public juce::PopupMenu::CustomComponent
+    {
+    public:
+        PresetMenuItem(const juce::String& nameToShow, std::function<void(bool)> onHighlightChanged)
+            : name(nameToShow), onHighlight(std::move(onHighlightChanged))
+        {
+        }
+
+        ~PresetMenuItem() override
+        {
+            if (highlighted)
+                onHighlight(false);  // Menu closed while hovering
+        }
+
+        void getIdealSize(int& idealWidth, int& idealHeight) override
+        {
+            getLookAndFeel().getIdealPopupMenuItemSize(name, false, -1, idealWidth, idealHeight);
+        }
+
+        void paint(juce::Graphics& g) override
+        {
+            // A highlight change repaints the item, so this is where hovering is noticed
+            if (isItemHighlighted() != highlighted)
+            {
+                highlighted = isItemHighlighted();
+                onHighlight(highlighted);
+            }
+
+            getLookAndFeel().drawPopupMenuItem(g, getLocalBounds(), false, true, highlighted, false, false,
+                                               name, {}, nullptr, nullptr);
+        }
+
+    private:
+        juce::String name;
+        std::function<void(bool)> onHighlight;
+        bool highlighted = false;
+    };
+
+    // What the attachments do when a parameter changes; their own listeners then see no change
+    void showParameterValue(juce::Slider& slider, const juce::RangedAudioParameter& parameter)
+    {
+        slider.setValue(parameter.convertFrom0to1(parameter.getValue()), juce::sendNotificationSync);
+    }
+
+    void showParameterValue(juce::Button& button, const juce::RangedAudioParameter& parameter)
+    {
+        button.setToggleState(parameter.getValue() >= 0.5f, juce::sendNotificationSync);
+    }
+
+    void showParameterValue(juce::ComboBox& comboBox, const juce::RangedAudioParameter& parameter)
+    {
+        int index = juce::roundToInt(parameter.getValue() * static_cast<float>(comboBox.getNumItems() - 1));
+        comboBox.setSelectedItemIndex(index, juce::sendNotificationSync);
+    }
+}
+
+//==============================================================================
+template <typename AttachmentType, typename ControlType>
+std::unique_ptr<AttachmentType> NanoStuttAudioProcessorEditor::attach(const juce::String& parameterID, ControlType& control)
+{
+    if (auto* parameter = audioProcessor.getParameters().getParameter(parameterID))
+        followQuietWrites(parameterID, [parameter, &control] { showParameterValue(control, *parameter); });
+
+    return std::make_unique<AttachmentType>(audioProcessor.getParameters(), parameterID, control);
+}
+
+void NanoStuttAudioProcessorEditor::followQuietWrites(const juce::String& parameterID, std::function<void()> update)
+{
+    const auto& table = audioProcessor.getParameterTable();
+    int index = table.indexOf(parameterID);
+    if (index < 0)
+        return;
+
+    // One control per parameter; attaching a control again replaces the previous one
+    quietWriteFollowers.resize((size_t) table.size());
+    quietWriteFollowers[(size_t) index] = std::move(update);
 }
 
 //==============================================================================
 NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProcessor& p)
-: AudioProcessorEditor (&p), autoStutterIndicator(p), visualizer(p), tuner(p), audioProcessor (p)
+: AudioProcessorEditor (&p), autoStutterIndicator(p), visualizer(p), eventTimeline(p), spectrumAnalyzer(p), sliceThumbnail(p), tuner(p), audioProcessor (p), refreshCoordinator(*this, p)
 {
     // Apply modern LookAndFeel for futuristic/technical UI styling
     setLookAndFeel(&modernLookAndFeel);
 
-    // Pre-generate neumorphic background texture (once, no paint() allocation)
-    backgroundTexture = TextureGenerator::createNeumorphicNoise(800, 600, 0.03f);
+    // Neumorphic background texture is generated off the message thread; repaint when it arrives
+    backgroundTextures->addChangeListener(this);
+
+    // The user preset index is kept current in the background while an editor is open; rebuild the menu when it changes
+    audioProcessor.getPresetManager().getLibrary().addChangeListener(this);
+    audioProcessor.getPresetManager().getLibrary().beginWatching();
+
+    // Preset previews render in the background while the editor is open
+    presetPreviews = std::make_unique<PresetPreviewRenderer>(audioProcessor.getSampleRate());
+    presetPreviews->addChangeListener(this);
 
     // === Manual Stutter Button === //
     addAndMakeVisible(stutterButton);
     stutterButton.setButtonText("Stutter");
 
-    stutterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        audioProcessor.getParameters(),
+    stutterAttachment = attach<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         "stutterOn",
         stutterButton);
     
@@ -67,16 +152,16 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     autoStutterChanceSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     autoStutterChanceSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
 
-    autoStutterChanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "autoStutterChance", autoStutterChanceSlider);
+    autoStutterChanceAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "autoStutterChance", autoStutterChanceSlider);
 
     // === Reverse Chance Slider ===
     addAndMakeVisible(reverseChanceSlider);
     reverseChanceSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     reverseChanceSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
 
-    reverseChanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "reverseChance", reverseChanceSlider);
+    reverseChanceAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "reverseChance", reverseChanceSlider);
 
     // === Quantization Menu ===
     addAndMakeVisible(autoStutterQuantMenu);
@@ -85,8 +170,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     autoStutterQuantMenu.addItem("1/16", 3);
     autoStutterQuantMenu.addItem("1/32", 4);
 
-    autoStutterQuantAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "autoStutterQuant", autoStutterQuantMenu);
+    autoStutterQuantAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "autoStutterQuant", autoStutterQuantMenu);
 
     // === Envelope Controls ===
     auto setupKnob = [this] (juce::Slider& slider, const juce::String& paramID, std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>& attachment)
@@ -94,7 +179,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         addAndMakeVisible(slider);
         slider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
         slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 16);  // Reduced textbox height from 20 to 16
-        attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.getParameters(), paramID, slider);
+        attachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(paramID, slider);
     };
 
     // Setup DualSliders for NanoGate and NanoShape with randomization
@@ -105,10 +190,10 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     auto panelOrange = ColorPalette::rhythmicOrange;
     auto panelPurple = ColorPalette::nanoPurple;
     nanoGateDualSlider.setSectionGradient(panelOrange, panelPurple);
-    nanoGateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoGate", nanoGateDualSlider.getMainSlider());
-    nanoGateRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoGateRandom", nanoGateDualSlider.getRandomSlider());
+    nanoGateAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoGate", nanoGateDualSlider.getMainSlider());
+    nanoGateRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoGateRandom", nanoGateDualSlider.getRandomSlider());
 
     // Setup bipolar state synchronization for NanoGate
     nanoGateBipolarAttachment = std::make_unique<juce::ParameterAttachment>(
@@ -116,6 +201,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             nanoGateDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("NanoGateRandomBipolar", [this] { nanoGateBipolarAttachment->sendInitialUpdate(); });
 
     // Set initial state
     nanoGateDualSlider.setBipolarMode(
@@ -137,6 +223,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             nanoGateDualSlider.setSnapMode(newValue > 0.5f);
         });
+    followQuietWrites("NanoGateSnapMode", [this] { nanoGateSnapModeAttachment->sendInitialUpdate(); });
 
     // Set initial snap mode state from parameter
     nanoGateDualSlider.setSnapMode(
@@ -155,10 +242,10 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     nanoShapeDualSlider.setScaleMarkings(5, {"0", ".25", ".5", ".75", "1"});  // Scale: 0.0 to 1.0
     // Vertical gradient: exact panel background colors (reuse panel colors)
     nanoShapeDualSlider.setSectionGradient(panelOrange, panelPurple);
-    nanoShapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoShape", nanoShapeDualSlider.getMainSlider());
-    nanoShapeRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoShapeRandom", nanoShapeDualSlider.getRandomSlider());
+    nanoShapeAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoShape", nanoShapeDualSlider.getMainSlider());
+    nanoShapeRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoShapeRandom", nanoShapeDualSlider.getRandomSlider());
 
     // Setup bipolar state synchronization for NanoShape
     nanoShapeBipolarAttachment = std::make_unique<juce::ParameterAttachment>(
@@ -166,6 +253,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             nanoShapeDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("NanoShapeRandomBipolar", [this] { nanoShapeBipolarAttachment->sendInitialUpdate(); });
 
     // Set initial state
     nanoShapeDualSlider.setBipolarMode(
@@ -204,10 +292,10 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     };
 
     // Create attachments AFTER text formatters (will respect formatters for discrete parameters)
-    nanoOctaveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoOctave", nanoOctaveDualSlider.getMainSlider());
-    nanoOctaveRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoOctaveRandom", nanoOctaveDualSlider.getRandomSlider());
+    nanoOctaveAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoOctave", nanoOctaveDualSlider.getMainSlider());
+    nanoOctaveRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoOctaveRandom", nanoOctaveDualSlider.getRandomSlider());
 
     // Setup bipolar state synchronization for NanoOctave
     nanoOctaveBipolarAttachment = std::make_unique<juce::ParameterAttachment>(
@@ -215,6 +303,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             nanoOctaveDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("NanoOctaveRandomBipolar", [this] { nanoOctaveBipolarAttachment->sendInitialUpdate(); });
 
     // Set initial state
     nanoOctaveDualSlider.setBipolarMode(
@@ -239,10 +328,10 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     nanoEmaDualSlider.setScaleMarkings(5, {"0", ".25", ".5", ".75", "1"});  // Scale: 0.0 to 1.0
     // Vertical gradient: exact panel background colors (reuse panel colors)
     nanoEmaDualSlider.setSectionGradient(panelOrange, panelPurple);
-    nanoEmaAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoEmaFilter", nanoEmaDualSlider.getMainSlider());
-    nanoEmaRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "NanoEmaFilterRandom", nanoEmaDualSlider.getRandomSlider());
+    nanoEmaAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoEmaFilter", nanoEmaDualSlider.getMainSlider());
+    nanoEmaRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "NanoEmaFilterRandom", nanoEmaDualSlider.getRandomSlider());
 
     // Setup bipolar state synchronization for NanoEma
     nanoEmaBipolarAttachment = std::make_unique<juce::ParameterAttachment>(
@@ -250,6 +339,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             nanoEmaDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("NanoEmaFilterRandomBipolar", [this] { nanoEmaBipolarAttachment->sendInitialUpdate(); });
     nanoEmaDualSlider.setBipolarMode(
         audioProcessor.getParameters().getRawParameterValue("NanoEmaFilterRandomBipolar")->load() > 0.5f);
     nanoEmaDualSlider.onBipolarModeChange = [this](bool isBipolar) {
@@ -264,10 +354,10 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     nanoCycleCrossfadeDualSlider.setScaleMarkings(5, {"0", ".25", ".5", ".75", "1"});  // Scale: 0.0 to 1.0
     // Vertical gradient: exact panel background colors (reuse panel colors)
     nanoCycleCrossfadeDualSlider.setSectionGradient(panelOrange, panelPurple);
-    nanoCycleCrossfadeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "CycleCrossfade", nanoCycleCrossfadeDualSlider.getMainSlider());
-    nanoCycleCrossfadeRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "CycleCrossfadeRandom", nanoCycleCrossfadeDualSlider.getRandomSlider());
+    nanoCycleCrossfadeAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "CycleCrossfade", nanoCycleCrossfadeDualSlider.getMainSlider());
+    nanoCycleCrossfadeRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "CycleCrossfadeRandom", nanoCycleCrossfadeDualSlider.getRandomSlider());
 
     // Setup bipolar state synchronization for CycleCrossfade
     nanoCycleCrossfadeBipolarAttachment = std::make_unique<juce::ParameterAttachment>(
@@ -275,6 +365,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             nanoCycleCrossfadeDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("CycleCrossfadeRandomBipolar", [this] { nanoCycleCrossfadeBipolarAttachment->sendInitialUpdate(); });
     nanoCycleCrossfadeDualSlider.setBipolarMode(
         audioProcessor.getParameters().getRawParameterValue("CycleCrossfadeRandomBipolar")->load() > 0.5f);
     nanoCycleCrossfadeDualSlider.onBipolarModeChange = [this](bool isBipolar) {
@@ -287,28 +378,26 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     addAndMakeVisible(fadeLengthSlider);
     fadeLengthSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     fadeLengthSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
-    fadeLengthSlider.setVisible(false);  // Hidden by default
-    fadeLengthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "FadeLength", fadeLengthSlider);
+    fadeLengthSlider.setVisible(false);  // Hidden by default, attached in attachAdvancedControls()
 
     // Setup DualSliders for MacroGate and MacroShape with randomization
     addAndMakeVisible(macroGateDualSlider);
     macroGateDualSlider.setDefaultValues(1.0, 0.0);  // MacroGate default: 1.0, Random default: 0.0
     macroGateDualSlider.setScaleMarkings(4, {".25", ".5", ".75", "1"});  // Scale: 0.25 to 1.0
     macroGateDualSlider.setSectionColor(ColorPalette::accentCyan);  // Green for macro section
-    macroGateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "MacroGate", macroGateDualSlider.getMainSlider());
-    macroGateRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "MacroGateRandom", macroGateDualSlider.getRandomSlider());
+    macroGateAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "MacroGate", macroGateDualSlider.getMainSlider());
+    macroGateRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "MacroGateRandom", macroGateDualSlider.getRandomSlider());
 
     addAndMakeVisible(macroShapeDualSlider);
     macroShapeDualSlider.setDefaultValues(0.5, 0.0);  // MacroShape default: 0.5, Random default: 0.0
     macroShapeDualSlider.setScaleMarkings(5, {"0", ".25", ".5", ".75", "1"});  // Scale: 0.0 to 1.0
     macroShapeDualSlider.setSectionColor(ColorPalette::accentCyan);  // Green for macro section
-    macroShapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "MacroShape", macroShapeDualSlider.getMainSlider());
-    macroShapeRandomAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "MacroShapeRandom", macroShapeDualSlider.getRandomSlider());
+    macroShapeAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "MacroShape", macroShapeDualSlider.getMainSlider());
+    macroShapeRandomAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "MacroShapeRandom", macroShapeDualSlider.getRandomSlider());
 
     // Setup bipolar state synchronization for MacroGate
     macroGateBipolarAttachment = std::make_unique<juce::ParameterAttachment>(
@@ -316,6 +405,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             macroGateDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("MacroGateRandomBipolar", [this] { macroGateBipolarAttachment->sendInitialUpdate(); });
 
     // Set initial state
     macroGateDualSlider.setBipolarMode(
@@ -337,6 +427,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             macroGateDualSlider.setSnapMode(newValue > 0.5f);
         });
+    followQuietWrites("MacroGateSnapMode", [this] { macroGateSnapModeAttachment->sendInitialUpdate(); });
 
     // Set initial snap mode state from parameter
     macroGateDualSlider.setSnapMode(
@@ -355,6 +446,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         [this](float newValue) {
             macroShapeDualSlider.setBipolarMode(newValue > 0.5f);
         });
+    followQuietWrites("MacroShapeRandomBipolar", [this] { macroShapeBipolarAttachment->sendInitialUpdate(); });
 
     // Set initial state
     macroShapeDualSlider.setBipolarMode(
@@ -376,8 +468,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     addAndMakeVisible(timingOffsetSlider);
     timingOffsetSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     timingOffsetSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
-    timingOffsetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "TimingOffset", timingOffsetSlider);
+    timingOffsetAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "TimingOffset", timingOffsetSlider);
 
     // === Labels ===
     auto setupLabel = [this] (juce::Label& label, const juce::String& text, juce::Component& component)
@@ -414,6 +506,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     repeatRatesLabel.setText("Repeat Rates", juce::dontSendNotification);
     repeatRatesLabel.setJustificationType(juce::Justification::centred);
     repeatRatesLabel.setColour(juce::Label::textColourId, ColorPalette::rhythmicOrange);
+    repeatRatesLabel.setTooltip("Right-click for rate transition (Markov) options");
+    repeatRatesLabel.addMouseListener(this, false);  // Right-click opens the rate transition menu
     addAndMakeVisible(repeatRatesLabel);
 
     nanoRatesLabel.setText("Nano Rates", juce::dontSendNotification);
@@ -440,20 +534,16 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         // Note: Labels are created later after SVG loading (see after line 850)
 
         juce::String paramId = "rateProb_" + rateLabels[i];
-        rateProbAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-            audioProcessor.getParameters(), paramId, *slider));
+        rateProbAttachments.push_back(attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            paramId, *slider));
 
         // Create visibility toggle button (eye icon)
         auto* toggleButton = new juce::TextButton();
         toggleButton->setButtonText(juce::CharPointer_UTF8("\xf0\x9f\x91\x81")); // 👁 emoji
         toggleButton->setClickingTogglesState(true);
-        toggleButton->onClick = [this]() { resized(); };
-        addAndMakeVisible(toggleButton);
+        toggleButton->onClick = [this]() { if (!attachingAdvancedControls) resized(); };
+        addChildComponent(toggleButton);  // Advanced view only, attached in attachAdvancedControls()
         rateActiveButtons.add(toggleButton);
-
-        juce::String activeParamId = "rateActive_" + rateLabels[i];
-        rateActiveAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-            audioProcessor.getParameters(), activeParamId, *toggleButton));
     }
     
     // === Quant Probability Sliders (updated naming) ===
@@ -470,25 +560,23 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         // Note: Labels are created later after SVG loading (see after line 850)
 
         juce::String paramId = "quantProb_" + quantLabels[i];
-        quantProbAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-            audioProcessor.getParameters(), paramId, *slider));
+        quantProbAttachments.push_back(attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            paramId, *slider));
 
         // Create visibility toggle button (eye icon)
         auto* toggleButton = new juce::TextButton();
         toggleButton->setButtonText(juce::CharPointer_UTF8("\xf0\x9f\x91\x81")); // 👁 emoji
         toggleButton->setClickingTogglesState(true);
-        toggleButton->onClick = [this]() { resized(); };
-        addAndMakeVisible(toggleButton);
+        toggleButton->onClick = [this]() { if (!attachingAdvancedControls) resized(); };
+        addChildComponent(toggleButton);  // Advanced view only, attached in attachAdvancedControls()
         quantActiveButtons.add(toggleButton);
-
-        juce::String activeParamId = "quantActive_" + quantLabels[i];
-        quantActiveAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-            audioProcessor.getParameters(), activeParamId, *toggleButton));
     }
     
     // === Labels for main knobs ===
     chanceLabel.setText("Chance", juce::dontSendNotification);
     chanceLabel.attachToComponent(&autoStutterChanceSlider, false);
+    chanceLabel.setTooltip("Right-click for Euclidean occurrence options");
+    chanceLabel.addMouseListener(this, false);  // Right-click opens the occurrence menu
     addAndMakeVisible(chanceLabel);
 
     reverseLabel.setText("Reverse", juce::dontSendNotification);
@@ -502,8 +590,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     // === Mix Mode Menu ===
     addAndMakeVisible(mixModeMenu);
     mixModeMenu.addItemList({ "Gate", "Insert", "Mix" }, 1);
-    mixModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "MixMode", mixModeMenu);
+    mixModeAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "MixMode", mixModeMenu);
 
     mixModeLabel = std::make_unique<juce::Label>();
     mixModeLabel->setText("Mix Mode", juce::dontSendNotification);
@@ -547,8 +635,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     addAndMakeVisible(nanoBlendSlider);
     nanoBlendSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     nanoBlendSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
-    nanoBlendAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "nanoBlend", nanoBlendSlider);
+    nanoBlendAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "nanoBlend", nanoBlendSlider);
 
     nanoBlendLabel.setText("Repeat/Nano", juce::dontSendNotification);
     nanoBlendLabel.attachToComponent(&nanoBlendSlider, false);
@@ -558,8 +646,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     addAndMakeVisible(nanoTuneSlider);
     nanoTuneSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     nanoTuneSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
-    nanoTuneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "nanoTune", nanoTuneSlider);
+    nanoTuneAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "nanoTune", nanoTuneSlider);
 
     nanoTuneLabel.setText("Nano Tune", juce::dontSendNotification);
     nanoTuneLabel.attachToComponent(&nanoTuneSlider, false);
@@ -568,20 +656,20 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     // === Nano Tuning System Controls ===
     addAndMakeVisible(nanoBaseMenu);
     nanoBaseMenu.addItemList({ "BPM Synced", "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" }, 1);
-    nanoBaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "nanoBase", nanoBaseMenu);
+    nanoBaseAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "nanoBase", nanoBaseMenu);
 
     addAndMakeVisible(tuningSystemMenu);
     tuningSystemMenu.addItemList({ "Equal Temperament", "Just Intonation", "Pythagorean", "Quarter-comma Meantone", "Custom (Fraction)", "Custom (Decimal)", "Custom (Semitone)" }, 1);
-    tuningSystemAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "tuningSystem", tuningSystemMenu);
+    tuningSystemAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "tuningSystem", tuningSystemMenu);
 
     addAndMakeVisible(scaleMenu);
     scaleMenu.addItemList({ "Chromatic", "Major", "Natural Minor", "Major Pentatonic", "Minor Pentatonic",
                            "Dorian", "Phrygian", "Lydian", "Mixolydian", "Aeolian", "Locrian",
                            "Harmonic Minor", "Melodic Minor", "Whole Tone", "Diminished", "Custom" }, 1);
-    scaleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "scale", scaleMenu);
+    scaleAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "scale", scaleMenu);
 
     // Window Type ComboBox (advanced view only)
     windowTypeLabel = std::make_unique<juce::Label>("", "Window Type");
@@ -592,9 +680,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     addAndMakeVisible(windowTypeMenu);
     windowTypeMenu.addItemList({ "None", "Hann", "Hamming", "Blackman", "Blackman-Harris",
                                   "Bartlett", "Kaiser", "Tukey", "Gaussian", "Planck", "Exponential" }, 1);
-    windowTypeMenu.setVisible(false);  // Hidden by default
-    windowTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "WindowType", windowTypeMenu);
+    windowTypeMenu.setVisible(false);  // Hidden by default, attached in attachAdvancedControls()
 
     // Fade Length label (advanced view only - attaches to slider)
     fadeLengthLabel.setText("Fade Length", juce::dontSendNotification);
@@ -611,14 +697,14 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     waveshaperAlgorithmMenu.addItem("Hard Clip", 4);
     waveshaperAlgorithmMenu.addItem("Tube", 5);
     waveshaperAlgorithmMenu.addItem("Fold", 6);
-    waveshaperAlgorithmAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "WaveshapeAlgorithm", waveshaperAlgorithmMenu);
+    waveshaperAlgorithmAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "WaveshapeAlgorithm", waveshaperAlgorithmMenu);
 
     addAndMakeVisible(waveshaperSlider);
     waveshaperSlider.setSliderStyle(juce::Slider::LinearHorizontal);
     waveshaperSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
-    waveshaperAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.getParameters(), "Drive", waveshaperSlider);
+    waveshaperAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "Drive", waveshaperSlider);
 
     waveshaperLabel.setText("Drive", juce::dontSendNotification);
     waveshaperLabel.attachToComponent(&waveshaperSlider, false);
@@ -627,8 +713,8 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     // === Gain Compensation Toggle ===
     addAndMakeVisible(gainCompensationToggle);
     gainCompensationToggle.setButtonText("Gain Comp");
-    gainCompensationAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        audioProcessor.getParameters(), "GainCompensation", gainCompensationToggle);
+    gainCompensationAttachment = attach<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        "GainCompensation", gainCompensationToggle);
 
     // === Preset UI Components ===
     addAndMakeVisible(savePresetButton);
@@ -643,8 +729,61 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     presetNameLabel.setJustificationType(juce::Justification::centredLeft);
     presetNameLabel.setText("No Preset Loaded", juce::dontSendNotification);
 
-    // Start timer for updating preset name label (30Hz)
-    startTimerHz(30);
+    // === Preset Morph (A/B) ===
+    addAndMakeVisible(morphAButton);
+    morphAButton.setButtonText("A");
+    morphAButton.setTooltip("Morph source A: store the current sound or pick a preset");
+    morphAButton.onClick = [this]() { showMorphSourceMenu(PresetMorph::A); };
+
+    addAndMakeVisible(morphBButton);
+    morphBButton.setButtonText("B");
+    morphBButton.setTooltip("Morph source B: store the current sound or pick a preset");
+    morphBButton.onClick = [this]() { showMorphSourceMenu(PresetMorph::B); };
+
+    addAndMakeVisible(morphSlider);
+    morphSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    morphSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    morphSlider.setTooltip("Preset morph: continuous parameters glide from A to B, discrete ones switch halfway");
+    morphAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "presetMorph", morphSlider);
+    updateMorphButtons();
+
+    // === State slots ===
+    for (int i = 0; i < StateSlots::NUM_SLOTS; ++i)
+    {
+        auto& button = stateSlotButtons[(size_t) i];
+        addAndMakeVisible(button);
+        button.setButtonText(juce::String(i + 1));
+        button.setTooltip("State slot " + juce::String(i + 1) + ": click to store (empty) or recall at the next event, "
+                          "shift-click to store again, alt-click to clear");
+        button.onClick = [this, i]() { onStateSlotClicked(i); };
+    }
+    updateStateSlotButtons();
+
+    // Resolve parameters polled by refresh() once, so frames do no string building or lookups
+    auto& apvts = audioProcessor.getParameters();
+    tuningSystemParam = apvts.getRawParameterValue("tuningSystem");
+    scaleParam = apvts.getRawParameterValue("scale");
+    auto rateParamLabels = juce::StringArray { "1", "1/2d", "1/2", "1/4d", "1/3", "1/4", "1/8d", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32" };
+    auto quantParamLabels = juce::StringArray { "4", "2", "1", "1/2", "1/4", "1/8d", "1/8", "1/16", "1/32" };
+    for (size_t i = 0; i < rateActiveParams.size(); ++i)
+        rateActiveParams[i] = apvts.getRawParameterValue("rateActive_" + rateParamLabels[(int) i]);
+    for (size_t i = 0; i < nanoActiveParams.size(); ++i)
+        nanoActiveParams[i] = apvts.getRawParameterValue("nanoActive_" + juce::String((int) i));
+    for (size_t i = 0; i < quantActiveParams.size(); ++i)
+        quantActiveParams[i] = apvts.getRawParameterValue("quantActive_" + quantParamLabels[(int) i]);
+
+    // Periodic UI updates (preset name label, glows, visualizers) run from the refresh coordinator
+    refreshCoordinator.addClient(&autoStutterIndicator);
+    refreshCoordinator.addClient(&visualizer);
+    refreshCoordinator.addClient(&eventTimeline);
+    refreshCoordinator.addClient(&spectrumAnalyzer);
+    refreshCoordinator.addClient(&sliceThumbnail);
+    refreshCoordinator.addClient(&tuner);
+    for (auto* dualSlider : { &macroGateDualSlider, &macroShapeDualSlider, &nanoGateDualSlider, &nanoShapeDualSlider,
+                              &nanoOctaveDualSlider, &nanoEmaDualSlider, &nanoCycleCrossfadeDualSlider })
+        refreshCoordinator.addClient(dualSlider);  // Coalesces value-change repaints to one per frame
+    refreshCoordinator.addClient(this);  // Last, so "next up" glows see this frame's timeline
 
     // === Advanced View Toggle ===
     addAndMakeVisible(advancedViewToggle);
@@ -652,6 +791,17 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
     advancedViewToggle.onClick = [this]() {
         showAdvancedView = !showAdvancedView;
 
+        // Advanced-only controls listen to their parameters only while shown
+        if (showAdvancedView)
+        {
+            createAdvancedComponents();
+            attachAdvancedControls();
+        }
+        else
+        {
+            detachAdvancedControls();
+        }
+
         // Auto-resize window for better fit in advanced view
         const int currentWidth = getWidth();
         if (showAdvancedView) {
@@ -671,70 +821,7 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         repaint();  // Force repaint to update borders immediately
     };
 
-    // === Editable Nano Ratio Numerator/Denominator Sliders ===
-    for (int i = 0; i < 12; ++i)
-    {
-        auto* numBox = new juce::TextEditor();
-        numBox->setInputRestrictions(3, "0123456789");
-        numBox->setJustification(juce::Justification::centred);
-        numBox->setText("1", juce::dontSendNotification);
-        numBox->onFocusLost = numBox->onReturnKey = [this, i, numBox]() {
-            updateNanoRatioFromFraction(i);
-        };
-        addAndMakeVisible(numBox);
-        nanoNumerators.add(numBox);
-
-        auto* denomBox = new juce::TextEditor();
-        denomBox->setInputRestrictions(3, "0123456789");
-        denomBox->setJustification(juce::Justification::centred);
-        denomBox->setText("1", juce::dontSendNotification);
-        denomBox->onFocusLost = denomBox->onReturnKey = [this, i, denomBox]() {
-            updateNanoRatioFromFraction(i);
-        };
-        addAndMakeVisible(denomBox);
-        nanoDenominators.add(denomBox);
-
-        // Load initial value from parameter
-        float ratioVal = audioProcessor.getParameters().getRawParameterValue("nanoRatio_" + juce::String(i))->load();
-        int num = static_cast<int>(std::round(ratioVal * 100));
-        int denom = 100;
-        int gcd = std::gcd(num, denom);
-        numBox->setText(juce::String(num / gcd), juce::dontSendNotification);
-        denomBox->setText(juce::String(denom / gcd), juce::dontSendNotification);
-
-        // === Semitone editors for Equal Temperament ===
-        auto* semitoneBox = new juce::TextEditor();
-        semitoneBox->setInputRestrictions(2, "0123456789");
-        semitoneBox->setJustification(juce::Justification::centred);
-        semitoneBox->setText(juce::String(i), juce::dontSendNotification);
-        semitoneBox->onFocusLost = semitoneBox->onReturnKey = [this, i]() {
-            updateNanoRatioFromSemitone(i);
-        };
-        addAndMakeVisible(semitoneBox);
-        nanoSemitoneEditors.add(semitoneBox);
-        semitoneBox->setVisible(false);  // Hidden by default
-
-        // === Decimal labels for Quarter-comma Meantone (read-only) ===
-        auto* decimalLabel = new juce::Label();
-        decimalLabel->setJustificationType(juce::Justification::centred);
-        decimalLabel->setText(juce::String(ratioVal, 3), juce::dontSendNotification);
-        addAndMakeVisible(decimalLabel);
-        nanoDecimalLabels.add(decimalLabel);
-        decimalLabel->setVisible(false);  // Hidden by default
-
-        // === Variant selectors for interval options (e.g., Aug 4th vs Dim 5th) ===
-        auto* variantSelector = new juce::ComboBox();
-        variantSelector->onChange = [this, i]() {
-            updateNanoRatioFromVariant(i);
-        };
-        addAndMakeVisible(variantSelector);
-        nanoVariantSelectors.add(variantSelector);
-        variantSelector->setVisible(false);  // Hidden by default, shown when variants exist
-    }
-
-
-
-
+    // Nano ratio editors (numerators, semitones, variants) are built on first advanced view, see createAdvancedComponents()
 
     // === Nano Rate Sliders ===
     for (int i = 0; i < 12; ++i)
@@ -747,20 +834,16 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
         nanoRateProbSliders.add(slider);
 
         juce::String paramId = "nanoProb_" + juce::String(i);
-        nanoRateProbAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-            audioProcessor.getParameters(), paramId, *slider));
+        nanoRateProbAttachments.push_back(attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            paramId, *slider));
 
         // Create visibility toggle button (eye icon)
         auto* toggleButton = new juce::TextButton();
         toggleButton->setButtonText(juce::CharPointer_UTF8("\xf0\x9f\x91\x81")); // 👁 emoji
         toggleButton->setClickingTogglesState(true);
-        toggleButton->onClick = [this]() { resized(); };
-        addAndMakeVisible(toggleButton);
+        toggleButton->onClick = [this]() { if (!attachingAdvancedControls) resized(); };
+        addChildComponent(toggleButton);  // Advanced view only, attached in attachAdvancedControls()
         nanoActiveButtons.add(toggleButton);
-
-        juce::String activeParamId = "nanoActive_" + juce::String(i);
-        nanoActiveAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-            audioProcessor.getParameters(), activeParamId, *toggleButton));
     }
 
     // Lambda function to load SVG from BinaryData
@@ -1086,12 +1169,41 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
 
 
     addAndMakeVisible(visualizer);
+    addAndMakeVisible(eventTimeline);
     addAndMakeVisible(tuner);
 
+    // Spectrum analyzer replaces the output waveform while toggled on (and only then analyses)
+    addChildComponent(spectrumAnalyzer);
+    addAndMakeVisible(spectrumToggle);
+    spectrumToggle.setButtonText("FFT");
+    spectrumToggle.setClickingTogglesState(true);
+    spectrumToggle.setTooltip("Show the output spectrum with nano slot frequencies");
+    spectrumToggle.onClick = [this]() {
+        if (spectrumToggle.getToggleState())
+            sliceToggle.setToggleState(false, juce::dontSendNotification);
+        updateVisualizerView();
+    };
+
+    // Slice thumbnail: waveform of the looped slice with loop, gate and crossfade markers
+    addChildComponent(sliceThumbnail);
+    addAndMakeVisible(sliceToggle);
+    sliceToggle.setButtonText("SLICE");
+    sliceToggle.setClickingTogglesState(true);
+    sliceToggle.setTooltip("Show the slice being looped, with loop position, nano gate and cycle crossfade");
+    sliceToggle.onClick = [this]() {
+        if (sliceToggle.getToggleState())
+            spectrumToggle.setToggleState(false, juce::dontSendNotification);
+        updateVisualizerView();
+    };
+
     setResizeLimits(1000, 610, 1000, 690);
     setSize(1000, 610);
     setResizable(false, false);
 
+    // Start generating the texture before the first paint (no-op if another editor already did)
+    if (auto* display = juce::Desktop::getInstance().getDisplays().getPrimaryDisplay())
+        backgroundTextures->prefetch(getWidth(), getHeight(), static_cast<float>(display->scale));
+
     // Load SVG panel backgrounds from embedded BinaryData
     quantPanelSVG = loadSVGFromBinary(BinaryData::QuantPanel_svg, "QuantPanel");
     rhythmicPanelSVG = loadSVGFromBinary(BinaryData::RhythemPanel_svg, "RhythemPanel");
@@ -1099,25 +1211,192 @@ NanoStuttAudioProcessorEditor::NanoStuttAudioProcessorEditor (NanoStuttAudioProc
 
     // Initialize tuning system UI
     updateNanoRatioUI();
+
+    constructedAtMs = juce::Time::getMillisecondCounterHiRes();
+}
+
+//==============================================================================
+void NanoStuttAudioProcessorEditor::createAdvancedComponents()
+{
+    if (advancedComponentsCreated)
+        return;
+    advancedComponentsCreated = true;
+
+    // === Editable Nano Ratio Numerator/Denominator Sliders ===
+    for (int i = 0; i < 12; ++i)
+    {
+        auto* numBox = new juce::TextEditor();
+        numBox->setInputRestrictions(3, "0123456789");
+        numBox->setJustification(juce::Justification::centred);
+        numBox->setText("1", juce::dontSendNotification);
+        numBox->onFocusLost = numBox->onReturnKey = [this, i, numBox]() {
+            updateNanoRatioFromFraction(i);
+        };
+        addAndMakeVisible(numBox);
+        nanoNumerators.add(numBox);
+
+        auto* denomBox = new juce::TextEditor();
+        denomBox->setInputRestrictions(3, "0123456789");
+        denomBox->setJustification(juce::Justification::centred);
+        denomBox->setText("1", juce::dontSendNotification);
+        denomBox->onFocusLost = denomBox->onReturnKey = [this, i, denomBox]() {
+            updateNanoRatioFromFraction(i);
+        };
+        addAndMakeVisible(denomBox);
+        nanoDenominators.add(denomBox);
+
+        // Load initial value from parameter
+        float ratioVal = audioProcessor.getParameters().getRawParameterValue("nanoRatio_" + juce::String(i))->load();
+        int num = static_cast<int>(std::round(ratioVal * 100));
+        int denom = 100;
+        int gcd = std::gcd(num, denom);
+        numBox->setText(juce::String(num / gcd), juce::dontSendNotification);
+        denomBox->setText(juce::String(denom / gcd), juce::dontSendNotification);
+
+        // === Semitone editors for Equal Temperament ===
+        auto* semitoneBox = new juce::TextEditor();
+        semitoneBox->setInputRestrictions(2, "0123456789");
+        semitoneBox->setJustification(juce::Justification::centred);
+        semitoneBox->setText(juce::String(i), juce::dontSendNotification);
+        semitoneBox->onFocusLost = semitoneBox->onReturnKey = [this, i]() {
+            updateNanoRatioFromSemitone(i);
+        };
+        addAndMakeVisible(semitoneBox);
+        nanoSemitoneEditors.add(semitoneBox);
+        semitoneBox->setVisible(false);  // Hidden by default
+
+        // === Decimal labels for Quarter-comma Meantone (read-only) ===
+        auto* decimalLabel = new juce::Label();
+        decimalLabel->setJustificationType(juce::Justification::centred);
+        decimalLabel->setText(juce::String(ratioVal, 3), juce::dontSendNotification);
+        addAndMakeVisible(decimalLabel);
+        nanoDecimalLabels.add(decimalLabel);
+        decimalLabel->setVisible(false);  // Hidden by default
+
+        // === Variant selectors for interval options (e.g., Aug 4th vs Dim 5th) ===
+        auto* variantSelector = new juce::ComboBox();
+        variantSelector->onChange = [this, i]() {
+            updateNanoRatioFromVariant(i);
+        };
+        addAndMakeVisible(variantSelector);
+        nanoVariantSelectors.add(variantSelector);
+        variantSelector->setVisible(false);  // Hidden by default, shown when variants exist
+    }
+}
+
+void NanoStuttAudioProcessorEditor::attachAdvancedControls()
+{
+    auto& apvts = audioProcessor.getParameters();
+    auto rateLabels = juce::StringArray { "1", "1/2d", "1/2", "1/4d", "1/3", "1/4", "1/8d", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32" };
+    auto quantLabels = juce::StringArray { "4", "2", "1", "1/2", "1/4", "1/8d", "1/8", "1/16", "1/32" };
+
+    // Attachments sync the controls to the current parameter values on creation, which clicks
+    // every toggle; the caller lays out once afterwards instead of once per toggle
+    const juce::ScopedValueSetter<bool> batchLayout(attachingAdvancedControls, true);
+
+    for (int i = 0; i < rateActiveButtons.size(); ++i)
+        rateActiveAttachments.push_back(attach<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            "rateActive_" + rateLabels[i], *rateActiveButtons[i]));
+
+    for (int i = 0; i < nanoActiveButtons.size(); ++i)
+        nanoActiveAttachments.push_back(attach<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            "nanoActive_" + juce::String(i), *nanoActiveButtons[i]));
+
+    for (int i = 0; i < quantActiveButtons.size(); ++i)
+        quantActiveAttachments.push_back(attach<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            "quantActive_" + quantLabels[i], *quantActiveButtons[i]));
+
+    windowTypeAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "WindowType", windowTypeMenu);
+    fadeLengthAttachment = attach<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        "FadeLength", fadeLengthSlider);
+}
+
+juce::uint64 NanoStuttAudioProcessorEditor::readActiveFlagMask() const
+{
+    // One bit per active flag: rate slots, then nano slots, then quant units
+    juce::uint64 mask = 0;
+    int bit = 0;
+    auto addFlags = [&](const auto& flags)
+    {
+        for (auto* flag : flags)
+        {
+            if (flag != nullptr && flag->load() > 0.5f)
+                mask |= 1ull << bit;
+            ++bit;
+        }
+    };
+
+    addFlags(rateActiveParams);
+    addFlags(nanoActiveParams);
+    addFlags(quantActiveParams);
+    return mask;
+}
+
+void NanoStuttAudioProcessorEditor::detachAdvancedControls()
+{
+    rateActiveAttachments.clear();
+    nanoActiveAttachments.clear();
+    quantActiveAttachments.clear();
+    windowTypeAttachment.reset();
+    fadeLengthAttachment.reset();
 }
 
 //==============================================================================
 NanoStuttAudioProcessorEditor::~NanoStuttAudioProcessorEditor()
 {
+    backgroundTextures->removeChangeListener(this);
+    audioProcessor.getPresetManager().getLibrary().endWatching();
+    audioProcessor.getPresetManager().getLibrary().removeChangeListener(this);
+    presetPreviews->removeChangeListener(this);
+    audioProcessor.stopPresetPreview();
+    audioProcessor.setEditorAttached(false);
+
     // Clean up LookAndFeel before destruction
     setLookAndFeel(nullptr);
 
     // unique_ptr handles cleanup automatically
 }
 
+//==============================================================================
+void NanoStuttAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source == &audioProcessor.getPresetManager().getLibrary())
+    {
+        updatePresetMenu();
+    }
+    else if (source == presetPreviews.get())
+    {
+        // A requested preview is ready: play it if its preset is still hovered
+        if (presetPreviewsEnabled && hoveredPreset.has_value())
+            if (auto preview = presetPreviews->getPreview(*hoveredPreset))
+                audioProcessor.startPresetPreview(*preview);
+    }
+    else
+    {
+        repaint();
+    }
+}
+
 //==============================================================================
 void NanoStuttAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    PaintProfiler::Scope profileScope(paintProfiler, g);
+
+    if (!firstPaintReported)
+    {
+        firstPaintReported = true;
+        audioProcessor.reportEditorFirstPaint(constructedAtMs);
+    }
+
     // Fill with modern dark background
     g.fillAll (ColorPalette::mainBackground);
 
-    // Draw subtle neumorphic noise texture
-    g.drawImageAt(backgroundTexture, 0, 0);
+    // Draw subtle neumorphic noise texture (flat background until it has been generated)
+    auto texture = backgroundTextures->getTexture(getWidth(), getHeight(),
+                                                  g.getInternalContext().getPhysicalPixelScaleFactor());
+    if (texture.isValid())
+        g.drawImage(texture, getLocalBounds().toFloat());
 
     // Draw colored backgrounds and borders around slider sections with modern styling
     // Cyan section for quantization sliders
@@ -1155,12 +1434,10 @@ void NanoStuttAudioProcessorEditor::paint (juce::Graphics& g)
             }
         }
 
-        // Glowing border
+        // Glowing border (cached sprite, re-rendered only on resize)
         juce::Path borderPath;
         borderPath.addRectangle(quantBounds);
-        GlowEffect::drawStrokeWithGlow(g, borderPath,
-                                        ColorPalette::accentCyan, 2.0f,
-                                        ColorPalette::accentGlow, 4.0f);
+        quantBorderGlow.draw(g, borderPath, { ColorPalette::accentCyan, 2.0f, ColorPalette::accentGlow, 4.0f });
     }
 
     // Orange section for rhythmic/regular rate sliders
@@ -1198,12 +1475,10 @@ void NanoStuttAudioProcessorEditor::paint (juce::Graphics& g)
             }
         }
 
-        // Glowing border
+        // Glowing border (cached sprite, re-rendered only on resize)
         juce::Path borderPath;
         borderPath.addRectangle(rhythmicBounds);
-        GlowEffect::drawStrokeWithGlow(g, borderPath,
-                                        ColorPalette::rhythmicOrange, 2.0f,
-                                        ColorPalette::rhythmicGlow, 4.0f);
+        rhythmicBorderGlow.draw(g, borderPath, { ColorPalette::rhythmicOrange, 2.0f, ColorPalette::rhythmicGlow, 4.0f });
     }
 
     // Purple section for nano sliders
@@ -1241,12 +1516,10 @@ void NanoStuttAudioProcessorEditor::paint (juce::Graphics& g)
             }
         }
 
-        // Glowing border
+        // Glowing border (cached sprite, re-rendered only on resize)
         juce::Path borderPath;
         borderPath.addRectangle(nanoBounds);
-        GlowEffect::drawStrokeWithGlow(g, borderPath,
-                                        ColorPalette::nanoPurple, 2.0f,
-                                        ColorPalette::nanoGlow, 4.0f);
+        nanoBorderGlow.draw(g, borderPath, { ColorPalette::nanoPurple, 2.0f, ColorPalette::nanoGlow, 4.0f });
     }
 }
 
@@ -1568,12 +1841,15 @@ void NanoStuttAudioProcessorEditor::layoutNanoControls(juce::Rectangle<int> boun
         {
             // Simple view: only active sliders with labels (NO toggles, NO ratio editors)
             nanoActiveButtons[i]->setVisible(false);  // Hide toggles in simple view
-            // Ratio display components hidden in simple view
-            nanoNumerators[i]->setVisible(false);
-            nanoDenominators[i]->setVisible(false);
-            nanoSemitoneEditors[i]->setVisible(false);
-            nanoDecimalLabels[i]->setVisible(false);
-            nanoVariantSelectors[i]->setVisible(false);  // Hide variant selectors too
+            // Ratio display components hidden in simple view (if they were ever built)
+            if (advancedComponentsCreated)
+            {
+                nanoNumerators[i]->setVisible(false);
+                nanoDenominators[i]->setVisible(false);
+                nanoSemitoneEditors[i]->setVisible(false);
+                nanoDecimalLabels[i]->setVisible(false);
+                nanoVariantSelectors[i]->setVisible(false);  // Hide variant selectors too
+            }
 
             // Keep interval labels visible in simple view
             nanoIntervalLabels[i]->setVisible(true);
@@ -1597,11 +1873,14 @@ void NanoStuttAudioProcessorEditor::layoutNanoControls(juce::Rectangle<int> boun
         {
             // Hide inactive sliders in simple view (hide ALL components)
             nanoActiveButtons[i]->setVisible(false);
-            nanoNumerators[i]->setVisible(false);
-            nanoDenominators[i]->setVisible(false);
-            nanoSemitoneEditors[i]->setVisible(false);
-            nanoDecimalLabels[i]->setVisible(false);
-            nanoVariantSelectors[i]->setVisible(false);
+            if (advancedComponentsCreated)
+            {
+                nanoNumerators[i]->setVisible(false);
+                nanoDenominators[i]->setVisible(false);
+                nanoSemitoneEditors[i]->setVisible(false);
+                nanoDecimalLabels[i]->setVisible(false);
+                nanoVariantSelectors[i]->setVisible(false);
+            }
             nanoRateProbSliders[i]->setVisible(false);
             nanoIntervalLabels[i]->setVisible(false);
         }
@@ -1790,7 +2069,24 @@ void NanoStuttAudioProcessorEditor::layoutRightPanel(juce::Rectangle<int> bounds
 
 void NanoStuttAudioProcessorEditor::layoutVisualizer(juce::Rectangle<int> bounds)
 {
-    visualizer.setBounds(bounds);
+    // Upcoming-event timeline runs as a thin strip above the output waveform, view toggles at its right
+    auto stripBounds = bounds.removeFromTop(16);
+    spectrumToggle.setBounds(stripBounds.removeFromRight(36));
+    sliceToggle.setBounds(stripBounds.removeFromRight(42).withTrimmedRight(2));
+    eventTimeline.setBounds(stripBounds.withTrimmedRight(2));
+    visualizer.setBounds(bounds.withTrimmedTop(2));
+    spectrumAnalyzer.setBounds(visualizer.getBounds());
+    sliceThumbnail.setBounds(visualizer.getBounds());
+}
+
+// Output waveform, spectrum or slice thumbnail: one at a time, only the shown one produces data
+void NanoStuttAudioProcessorEditor::updateVisualizerView()
+{
+    bool showSpectrum = spectrumToggle.getToggleState();
+    bool showSlice = sliceToggle.getToggleState();
+    spectrumAnalyzer.setVisible(showSpectrum);
+    sliceThumbnail.setVisible(showSlice);
+    visualizer.setVisible(!showSpectrum && !showSlice);
 }
 
 void NanoStuttAudioProcessorEditor::resized()
@@ -1801,16 +2097,23 @@ void NanoStuttAudioProcessorEditor::resized()
     if (bounds.getWidth() <= 0 || bounds.getHeight() <= 0)
         return;
 
+    laidOutActiveMask = readActiveFlagMask();
+
     // === Top-right corner controls (absolute positioning) ===
     autoStutterIndicator.setBounds(bounds.getWidth() - 158, 5, 28, 22);
     mixModeMenu.setBounds(bounds.getWidth() - 125, 5, 115, 22);
 
     // === Top-center: Preset controls (centered horizontally) ===
-    const int presetControlsWidth = 200 + 5 + 90 + 5 + 200; // menu + gap + button + gap + label = 500
+    const int presetControlsWidth = 190 + 5 + 90 + 5 + 110 + 5 + 22 + 2 + 90 + 2 + 22 + 6 + 4 * 20 + 3 * 2; // menu, save, label, A, morph, B, slots = 635
     const int presetStartX = (bounds.getWidth() - presetControlsWidth) / 2;
-    presetMenu.setBounds(presetStartX, 5, 200, 22);
-    savePresetButton.setBounds(presetStartX + 205, 5, 90, 22);
-    presetNameLabel.setBounds(presetStartX + 300, 5, 200, 22);
+    presetMenu.setBounds(presetStartX, 5, 190, 22);
+    savePresetButton.setBounds(presetStartX + 195, 5, 90, 22);
+    presetNameLabel.setBounds(presetStartX + 290, 5, 110, 22);
+    morphAButton.setBounds(presetStartX + 405, 5, 22, 22);
+    morphSlider.setBounds(presetStartX + 429, 5, 90, 22);
+    morphBButton.setBounds(presetStartX + 521, 5, 22, 22);
+    for (int i = 0; i < StateSlots::NUM_SLOTS; ++i)
+        stateSlotButtons[(size_t) i].setBounds(presetStartX + 549 + i * 22, 5, 20, 22);
 
     // Calculate main layout areas
     auto contentBounds = bounds.reduced(8).withTrimmedTop(15); // Leave space for top controls
@@ -2125,6 +2428,13 @@ void NanoStuttAudioProcessorEditor::updateNanoRatioUI()
     if (tuningSystemParam == nullptr)
         return;  // Parameters not initialized yet
 
+    // Ratio editors are only built once the advanced view has been shown
+    if (!advancedComponentsCreated)
+    {
+        resized();
+        return;
+    }
+
     int tuningIndex = static_cast<int>(tuningSystemParam->load());
     NanoTuning::TuningSystem tuning = static_cast<NanoTuning::TuningSystem>(tuningIndex);
 
@@ -2252,16 +2562,16 @@ void NanoStuttAudioProcessorEditor::refreshComboBoxesAndRatios()
     // Force ComboBoxAttachments to re-sync with current parameter values
     // by recreating them - this ensures display matches actual parameter state
     tuningSystemAttachment.reset();
-    tuningSystemAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "tuningSystem", tuningSystemMenu);
+    tuningSystemAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "tuningSystem", tuningSystemMenu);
 
     scaleAttachment.reset();
-    scaleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "scale", scaleMenu);
+    scaleAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "scale", scaleMenu);
 
     nanoBaseAttachment.reset();
-    nanoBaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getParameters(), "nanoBase", nanoBaseMenu);
+    nanoBaseAttachment = attach<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        "nanoBase", nanoBaseMenu);
 
     // Update ratio displays
     updateNanoRatioUI();
@@ -2282,6 +2592,7 @@ void NanoStuttAudioProcessorEditor::updatePresetMenu()
     presetMenu.addSeparator();
 
     int itemId = 2;
+    juce::Component::SafePointer<NanoStuttAudioProcessorEditor> safeThis(this);
 
     // Add factory presets organized by category
     auto factoryPresets = presetManager.getFactoryPresets();
@@ -2308,7 +2619,11 @@ void NanoStuttAudioProcessorEditor::updatePresetMenu()
             {
                 if (preset.category == category)
                 {
-                    categoryMenu.addItem(itemId++, preset.name);
+                    categoryMenu.addCustomItem(itemId++, std::make_unique<PresetMenuItem>(preset.name, [safeThis, preset](bool highlighted)
+                    {
+                        if (safeThis != nullptr)
+                            safeThis->onPresetHovered(preset, highlighted);
+                    }), nullptr, preset.name);
                 }
             }
 
@@ -2327,10 +2642,33 @@ void NanoStuttAudioProcessorEditor::updatePresetMenu()
 
         for (const auto& preset : userPresets)
         {
-            userMenu.addItem(itemId++, preset.name);
+            userMenu.addCustomItem(itemId++, std::make_unique<PresetMenuItem>(preset.name, [safeThis, preset](bool highlighted)
+            {
+                if (safeThis != nullptr)
+                    safeThis->onPresetHovered(preset, highlighted);
+            }), nullptr, preset.name);
         }
 
         presetMenu.getRootMenu()->addSubMenu("User Presets", userMenu);
+        presetMenu.addItem("Search User Presets...", SEARCH_PRESETS_ID);
+    }
+
+    // Preview on hover: what previews are rendered over
+    updatePreviewSampleRate();
+    bool overTrackInput = presetPreviews->getInputSource() == PresetPreviewRenderer::InputSource::CapturedInput;
+    juce::PopupMenu previewMenu;
+    previewMenu.addSectionHeader("Heard while the transport is stopped");
+    previewMenu.addItem(PREVIEW_OFF_ID, "Off", true, !presetPreviewsEnabled);
+    previewMenu.addItem(PREVIEW_TEST_LOOP_ID, "Test Loop", true, presetPreviewsEnabled && !overTrackInput);
+    previewMenu.addItem(PREVIEW_TRACK_INPUT_ID, "Track Input (last 4 s)", true, presetPreviewsEnabled && overTrackInput);
+    presetMenu.addSeparator();
+    presetMenu.getRootMenu()->addSubMenu("Preview on Hover", previewMenu);
+
+    // Previews of presets that are not cached yet render in the background
+    if (presetPreviewsEnabled)
+    {
+        presetPreviews->queueInBackground(factoryPresets);
+        presetPreviews->queueInBackground(userPresets);
     }
 }
 
@@ -2354,10 +2692,192 @@ void NanoStuttAudioProcessorEditor::updatePresetNameLabel()
     }
 }
 
+void NanoStuttAudioProcessorEditor::showMorphSourceMenu(PresetMorph::Source source)
+{
+    auto& presetManager = audioProcessor.getPresetManager();
+    auto factoryPresets = presetManager.getFactoryPresets();
+    auto userPresets = presetManager.getUserPresets();
+
+    // Item IDs: 1 store, 2 clear, 100+ factory presets then user presets
+    juce::PopupMenu menu;
+    menu.addSectionHeader(source == PresetMorph::A ? "Morph Source A" : "Morph Source B");
+    menu.addItem(1, "Store Current Sound");
+    menu.addItem(2, "Clear", audioProcessor.hasMorphSource(source));
+
+    juce::PopupMenu factoryMenu, userMenu;
+    int itemId = 100;
+    for (const auto& preset : factoryPresets)
+        factoryMenu.addItem(itemId++, preset.category + " / " + preset.name);
+    for (const auto& preset : userPresets)
+        userMenu.addItem(itemId++, preset.name);
+
+    menu.addSeparator();
+    menu.addSubMenu("Factory Presets", factoryMenu, !factoryPresets.isEmpty());
+    menu.addSubMenu("User Presets", userMenu, !userPresets.isEmpty());
+
+    auto* target = source == PresetMorph::A ? &morphAButton : &morphBButton;
+    juce::Component::SafePointer<NanoStuttAudioProcessorEditor> safeThis(this);
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(target),
+                       [safeThis, source, factoryPresets, userPresets](int result)
+    {
+        // Editor closed while the menu was open, or dismissed
+        if (safeThis == nullptr || result == 0)
+            return;
+
+        auto& processor = safeThis->audioProcessor;
+        if (result == 1)
+        {
+            processor.setMorphSource(source, processor.getParameterTable().capture());
+        }
+        else if (result == 2)
+        {
+            processor.clearMorphSource(source);
+        }
+        else if (result >= 100)
+        {
+            int index = result - 100;
+            const auto& preset = index < factoryPresets.size() ? factoryPresets.getReference(index)
+                                                               : userPresets.getReference(index - factoryPresets.size());
+
+            std::vector<float> values;
+            if (processor.getPresetManager().readPresetValues(preset, processor.getParameterTable(), values))
+                processor.setMorphSource(source, values);
+            else
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Load Error",
+                                                       "Failed to read preset: " + preset.name, "OK");
+        }
+
+        safeThis->updateMorphButtons();
+    });
+}
+
+void NanoStuttAudioProcessorEditor::updateMorphButtons()
+{
+    // Lit = source assigned; the slider only does something once both are
+    morphAButton.setToggleState(audioProcessor.hasMorphSource(PresetMorph::A), juce::dontSendNotification);
+    morphBButton.setToggleState(audioProcessor.hasMorphSource(PresetMorph::B), juce::dontSendNotification);
+    morphSlider.setEnabled(audioProcessor.hasMorphSource(PresetMorph::A) && audioProcessor.hasMorphSource(PresetMorph::B));
+}
+
+void NanoStuttAudioProcessorEditor::onPresetHovered(const PresetInfo& preset, bool highlighted)
+{
+    auto isHovered = [this](const PresetInfo& other)
+    {
+        return hoveredPreset.has_value() && hoveredPreset->name == other.name
+            && hoveredPreset->category == other.category && hoveredPreset->filePath == other.filePath;
+    };
+
+    if (highlighted && presetPreviewsEnabled)
+    {
+        hoveredPreset = preset;
+        updatePreviewSampleRate();
+        if (auto preview = presetPreviews->getPreview(preset))
+        {
+            audioProcessor.startPresetPreview(*preview);
+        }
+        else
+        {
+            // Played from changeListenerCallback once rendered (or read from the disk cache)
+            audioProcessor.stopPresetPreview();
+            presetPreviews->request(preset);
+        }
+    }
+    else if (!highlighted && isHovered(preset))
+    {
+        // The next item may already have taken over; only the hovered preset stops playback
+        hoveredPreset.reset();
+        audioProcessor.stopPresetPreview();
+    }
+}
+
+void NanoStuttAudioProcessorEditor::onPreviewMenuSelected(int itemId)
+{
+    presetPreviewsEnabled = itemId != PREVIEW_OFF_ID;
+
+    if (itemId == PREVIEW_TRACK_INPUT_ID)
+    {
+        juce::AudioBuffer<float> captured;
+        if (audioProcessor.copyPreviewInput(captured))
+        {
+            presetPreviews->setInput(PresetPreviewRenderer::InputSource::CapturedInput, audioProcessor.getSampleRate(), &captured);
+        }
+        else
+        {
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon, "Preview on Hover",
+                                                   "Play the track for a few seconds with the plugin window open, "
+                                                   "then choose Track Input again.", "OK");
+        }
+    }
+    else if (itemId == PREVIEW_TEST_LOOP_ID)
+    {
+        presetPreviews->setInput(PresetPreviewRenderer::InputSource::TestLoop, audioProcessor.getSampleRate());
+    }
+    else
+    {
+        hoveredPreset.reset();
+        audioProcessor.stopPresetPreview();
+    }
+
+    updatePresetMenu();  // Ticks, and queues previews over the new input
+}
+
+void NanoStuttAudioProcessorEditor::updatePreviewSampleRate()
+{
+    // Previews play at the live rate, which is only known after prepareToPlay and can change;
+    // a captured input was recorded at the old rate, so a new rate starts over from the test loop
+    double sampleRate = audioProcessor.getSampleRate();
+    if (sampleRate > 0.0 && sampleRate != presetPreviews->getSampleRate())
+    {
+        presetPreviews->setInput(PresetPreviewRenderer::InputSource::TestLoop, sampleRate);
+        audioProcessor.stopPresetPreview();
+    }
+}
+
+void NanoStuttAudioProcessorEditor::onStateSlotClicked(int slot)
+{
+    auto mods = juce::ModifierKeys::getCurrentModifiers();
+
+    if (mods.isAltDown())
+        audioProcessor.clearStateSlot(slot);
+    else if (mods.isShiftDown() || !audioProcessor.hasStateSlot(slot))
+        audioProcessor.storeStateSlot(slot);
+    else
+        audioProcessor.recallStateSlot(slot);  // Applied by the audio thread at the next event boundary
+
+    shownActiveStateSlot = audioProcessor.getActiveStateSlot();
+    updateStateSlotButtons();
+}
+
+void NanoStuttAudioProcessorEditor::updateStateSlotButtons()
+{
+    // Lit = stored; the last stored or recalled slot gets the accent text colour
+    for (int i = 0; i < StateSlots::NUM_SLOTS; ++i)
+    {
+        auto& button = stateSlotButtons[(size_t) i];
+        button.setToggleState(audioProcessor.hasStateSlot(i), juce::dontSendNotification);
+        auto textColour = i == shownActiveStateSlot ? ColorPalette::accentCyan : juce::Colours::white;
+        button.setColour(juce::TextButton::textColourOnId, textColour);
+        button.setColour(juce::TextButton::textColourOffId, textColour.withAlpha(0.6f));
+    }
+}
+
 void NanoStuttAudioProcessorEditor::onPresetSelected()
 {
     int selectedId = presetMenu.getSelectedId();
 
+    if (selectedId == SEARCH_PRESETS_ID)
+    {
+        presetMenu.setSelectedId(0, juce::dontSendNotification);
+        showPresetSearch();
+        return;
+    }
+
+    if (selectedId >= PREVIEW_OFF_ID)
+    {
+        onPreviewMenuSelected(selectedId);
+        return;
+    }
+
     if (selectedId == 1) // "No Preset"
     {
         audioProcessor.getPresetManager().clearCurrentPreset();
@@ -2379,23 +2899,208 @@ void NanoStuttAudioProcessorEditor::onPresetSelected()
     int presetIndex = selectedId - 2;
 
     if (presetIndex >= 0 && presetIndex < allPresets.size())
+        loadPresetWithFeedback(allPresets[presetIndex]);
+}
+
+void NanoStuttAudioProcessorEditor::loadPresetWithFeedback(const PresetInfo& preset)
+{
+    bool success = audioProcessor.getPresetManager().loadPreset(preset);
+
+    if (success)
     {
-        const auto& preset = allPresets[presetIndex];
-        bool success = presetManager.loadPreset(preset);
+        updatePresetNameLabel();
+    }
+    else
+    {
+        juce::AlertWindow::showMessageBoxAsync(
+            juce::AlertWindow::WarningIcon,
+            "Load Error",
+            "Failed to load preset: " + preset.name,
+            "OK");
+    }
+}
+
+void NanoStuttAudioProcessorEditor::showPresetSearch()
+{
+    auto* window = new juce::AlertWindow("Search Presets",
+                                         "Find user presets by name, category, author or tag:",
+                                         juce::AlertWindow::QuestionIcon);
 
-        if (success)
+    window->addTextEditor("query", "", "Search:");
+    window->addButton("Search", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    window->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    juce::Component::SafePointer<NanoStuttAudioProcessorEditor> safeThis(this);
+    window->enterModalState(true, juce::ModalCallbackFunction::create([safeThis, window](int result)
+    {
+        if (safeThis == nullptr || result != 1)
+            return;
+
+        auto query = window->getTextEditorContents("query").trim();
+        auto matches = safeThis->audioProcessor.getPresetManager().searchUserPresets(query);
+
+        if (matches.isEmpty())
         {
-            updatePresetNameLabel();
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon, "Search Presets",
+                                                   "No user presets match \"" + query + "\".", "OK");
+            return;
         }
-        else
+
+        // Results list as a menu under the preset box; choosing one loads it
+        juce::PopupMenu results;
+        for (int i = 0; i < matches.size(); ++i)
+            results.addItem(i + 1, matches[i].name + "  (" + matches[i].category + ")");
+
+        results.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&safeThis->presetMenu),
+                              [safeThis, matches](int chosen)
         {
-            juce::AlertWindow::showMessageBoxAsync(
-                juce::AlertWindow::WarningIcon,
-                "Load Error",
-                "Failed to load preset: " + preset.name,
-                "OK");
-        }
+            if (safeThis == nullptr || chosen == 0)
+                return;
+
+            safeThis->loadPresetWithFeedback(matches[chosen - 1]);
+        });
+    }), true);
+}
+
+void NanoStuttAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
+{
+    if (!event.mods.isPopupMenu())
+        return;
+
+    if (event.eventComponent == &repeatRatesLabel)
+        showRateTransitionMenu();
+    else if (event.eventComponent == &chanceLabel)
+        showOccurrenceMenu();
+}
+
+void NanoStuttAudioProcessorEditor::showOccurrenceMenu()
+{
+    auto& params = audioProcessor.getParameters();
+    int mode = static_cast<int>(params.getRawParameterValue("occurrenceMode")->load());
+    int hits = static_cast<int>(params.getRawParameterValue("euclidHits")->load());
+    int steps = static_cast<int>(params.getRawParameterValue("euclidSteps")->load());
+    int rotation = static_cast<int>(params.getRawParameterValue("euclidRotation")->load());
+    bool euclidean = mode != 0;
+
+    // Item ID ranges: 1-3 mode, 100+ hits, 200+ steps, 300+ rotation
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Occurrence");
+    menu.addItem(1, "Chance", true, mode == 0);
+    menu.addItem(2, "Euclidean", true, mode == 1);
+    menu.addItem(3, "Euclidean + Chance", true, mode == 2);
+    menu.addSeparator();
+
+    // Every step count the parameter allows
+    int maxSteps = static_cast<int>(params.getParameterRange("euclidSteps").end);
+
+    juce::PopupMenu hitsMenu, stepsMenu, rotationMenu;
+    for (int i = 1; i <= maxSteps; ++i)
+    {
+        hitsMenu.addItem(100 + i, juce::String(i), i <= steps, i == hits);
+        stepsMenu.addItem(200 + i, juce::String(i), true, i == steps);
     }
+    for (int i = 0; i < steps; ++i)
+        rotationMenu.addItem(300 + i, juce::String(i), true, i == rotation);
+
+    menu.addSubMenu("Hits (" + juce::String(hits) + ")", hitsMenu, euclidean);
+    menu.addSubMenu("Steps (" + juce::String(steps) + ")", stepsMenu, euclidean);
+    menu.addSubMenu("Rotation (" + juce::String(rotation) + ")", rotationMenu, euclidean);
+    menu.addSeparator();
+    menu.addItem(4, "Pattern Script...");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&chanceLabel),
+                       [this](int result)
+    {
+        auto& params = audioProcessor.getParameters();
+        auto setValue = [&params](const juce::String& id, float value)
+        {
+            auto* param = params.getParameter(id);
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        };
+
+        if (result >= 1 && result <= 3)
+            setValue("occurrenceMode", static_cast<float>(result - 1));
+        else if (result == 4)
+            juce::CallOutBox::launchAsynchronously(std::make_unique<PatternScriptEditor>(audioProcessor),
+                                                   getLocalArea(&chanceLabel, chanceLabel.getLocalBounds()), this);
+        else if (result > 100 && result < 200)
+            setValue("euclidHits", static_cast<float>(result - 100));
+        else if (result > 200 && result < 300)
+            setValue("euclidSteps", static_cast<float>(result - 200));
+        else if (result >= 300)
+            setValue("euclidRotation", static_cast<float>(result - 300));
+    });
+}
+
+void NanoStuttAudioProcessorEditor::showRateTransitionMenu()
+{
+    auto& params = audioProcessor.getParameters();
+    bool markovMode = params.getRawParameterValue("rateSelectionMode")->load() > 0.5f;
+    float strength = params.getRawParameterValue("markovStrength")->load();
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Rate Selection");
+    menu.addItem(1, "Independent", true, !markovMode);
+    menu.addItem(2, "Markov Transitions", true, markovMode);
+
+    juce::PopupMenu strengthMenu;
+    static const std::array<float, 4> strengthSteps = { 0.25f, 0.5f, 0.75f, 1.0f };
+    for (int i = 0; i < (int)strengthSteps.size(); ++i)
+        strengthMenu.addItem(10 + i, juce::String(juce::roundToInt(strengthSteps[i] * 100.0f)) + "%",
+                             markovMode, std::abs(strength - strengthSteps[i]) < 0.01f);
+    menu.addSubMenu("Transition Strength", strengthMenu, markovMode);
+
+    menu.addSeparator();
+    menu.addItem(3, "Learn Transitions from MIDI File...");
+    menu.addItem(4, "Reset Transitions");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&repeatRatesLabel),
+                       [this](int result)
+    {
+        auto& params = audioProcessor.getParameters();
+
+        if (result == 1 || result == 2)
+        {
+            params.getParameter("rateSelectionMode")->setValueNotifyingHost(result == 2 ? 1.0f : 0.0f);
+        }
+        else if (result >= 10 && result < 14)
+        {
+            static const std::array<float, 4> strengthSteps = { 0.25f, 0.5f, 0.75f, 1.0f };
+            params.getParameter("markovStrength")->setValueNotifyingHost(strengthSteps[result - 10]);
+        }
+        else if (result == 3)
+        {
+            rateTransitionFileChooser = std::make_unique<juce::FileChooser>("Learn rate transitions from MIDI file",
+                                                                            juce::File(), "*.mid;*.midi");
+            rateTransitionFileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                                   [this](const juce::FileChooser& chooser)
+            {
+                auto file = chooser.getResult();
+                if (file == juce::File())
+                    return;
+
+                if (audioProcessor.learnRateTransitionsFromMidiFile(file))
+                {
+                    // Learned transitions only take effect in Markov mode
+                    audioProcessor.getParameters().getParameter("rateSelectionMode")->setValueNotifyingHost(1.0f);
+                    updatePresetNameLabel();
+                }
+                else
+                {
+                    juce::AlertWindow::showMessageBoxAsync(
+                        juce::AlertWindow::WarningIcon,
+                        "Learn Error",
+                        "No usable note pattern found in: " + file.getFileName(),
+                        "OK");
+                }
+            });
+        }
+        else if (result == 4)
+        {
+            audioProcessor.resetRateTransitions();
+            updatePresetNameLabel();
+        }
+    });
 }
 
 void NanoStuttAudioProcessorEditor::onSavePresetClicked()
@@ -2484,13 +3189,48 @@ void NanoStuttAudioProcessorEditor::onSavePresetClicked()
     }), true);
 }
 
-void NanoStuttAudioProcessorEditor::timerCallback()
+void NanoStuttAudioProcessorEditor::refresh(const DisplayState& state)
 {
-    // Update preset name label to reflect modification state
-    updatePresetNameLabel();
+    // Update preset name label only when name or modification state changed
+    auto& presetManager = audioProcessor.getPresetManager();
+    if (presetManager.getCurrentPresetName() != shownPresetName || presetManager.isModified() != shownPresetModified)
+    {
+        shownPresetName = presetManager.getCurrentPresetName();
+        shownPresetModified = presetManager.isModified();
+        updatePresetNameLabel();
+    }
+
+    // A slot recall or a linked instance's tuning change landed on the audio thread: ratio displays follow once
+    if (state.stateSlotRecalls != shownStateSlotRecalls || state.linkedTuningUpdates != shownLinkedTuningUpdates)
+    {
+        shownStateSlotRecalls = state.stateSlotRecalls;
+        shownLinkedTuningUpdates = state.linkedTuningUpdates;
+        refreshComboBoxesAndRatios();
+    }
+    // Quiet parameter writes (morph, slot recall, linked instances) since the last frame
+    auto quietWrites = audioProcessor.getQuietWriteCounter();
+    if (quietWrites != shownQuietWrites)
+    {
+        shownQuietWrites = quietWrites;
+        audioProcessor.takeQuietParameterWrites([this](int index)
+        {
+            if (index < (int) quietWriteFollowers.size() && quietWriteFollowers[(size_t) index] != nullptr)
+                quietWriteFollowers[(size_t) index]();
+        });
+    }
+
+    // Morph sources can change without the editor (session restore)
+    if (morphAButton.getToggleState() != audioProcessor.hasMorphSource(PresetMorph::A)
+        || morphBButton.getToggleState() != audioProcessor.hasMorphSource(PresetMorph::B))
+        updateMorphButtons();
+
+    if (state.activeStateSlot != shownActiveStateSlot)
+    {
+        shownActiveStateSlot = state.activeStateSlot;
+        updateStateSlotButtons();
+    }
 
     // Check if tuning system has changed
-    auto* tuningSystemParam = audioProcessor.getParameters().getRawParameterValue("tuningSystem");
     if (tuningSystemParam != nullptr)
     {
         int currentTuningIndex = static_cast<int>(tuningSystemParam->load());
@@ -2501,112 +3241,70 @@ void NanoStuttAudioProcessorEditor::timerCallback()
         }
     }
 
-    // Check if scale has changed (affects visibility in simple view)
-    auto* scaleParam = audioProcessor.getParameters().getRawParameterValue("scale");
+    // The simple view only lays out active sliders: relayout once when the scale or any active
+    // flag changed outside the editor (host automation, presets, slot recall, linked instances)
+    bool needsLayout = readActiveFlagMask() != laidOutActiveMask;
     if (scaleParam != nullptr)
     {
         int currentScaleIndex = static_cast<int>(scaleParam->load());
         if (currentScaleIndex != lastScaleIndex)
         {
             lastScaleIndex = currentScaleIndex;
-            resized();  // Trigger layout update for new visibility states
+            needsLayout = true;
         }
     }
+    if (needsLayout)
+        resized();  // Also records the mask it laid out
 
-    // Update nano label glow effects and colors based on active/playing state
-    int currentPlayingIndex = audioProcessor.getCurrentPlayingNanoRateIndex();
-
-    for (int i = 0; i < nanoIntervalLabels.size(); ++i)
+    // Next scheduled event (decided one quant unit ahead) gets a "next up" glow
+    int nextNanoIndex = -1;
+    int nextRegularIndex = -1;
+    if (auto* nextEvent = eventTimeline.getNextEvent())
     {
-        // Check if this nano rate is enabled
-        bool isEnabled = audioProcessor.getParameters()
-            .getRawParameterValue("nanoActive_" + juce::String(i))->load() > 0.5f;
-
-        // Check if this is the currently playing rate
-        bool isPlaying = (currentPlayingIndex == i);
-
-        // Set border color based on enabled state (independent of playing glow)
-        if (isEnabled) {
-            nanoIntervalLabels[i]->setBorderColour(ColorPalette::nanoPurple);  // Bright purple for enabled
-        } else {
-            nanoIntervalLabels[i]->setBorderColour(ColorPalette::nanoPurple.darker(0.6f));  // Dimmed purple for disabled
-        }
-
-        // Set glow intensity based on playing state
-        float glowIntensity = 0.0f;
-        if (isPlaying) {
-            glowIntensity = 1.0f;  // Brightest glow for currently playing rate
-        } else if (isEnabled) {
-            glowIntensity = 0.3f;  // Subtle glow for enabled rates
-        }
-        // else: 0.0f (no glow for disabled rates)
-
-        nanoIntervalLabels[i]->setGlowIntensity(glowIntensity);
+        if (nextEvent->rateSlot >= 0 && RateMarkovChain::isNanoSlot(nextEvent->rateSlot))
+            nextNanoIndex = RateMarkovChain::toSystemIndex(nextEvent->rateSlot);
+        else if (nextEvent->rateSlot >= 0)
+            nextRegularIndex = nextEvent->rateSlot;
     }
 
-    // Update repeat rate label glow effects and colors based on active/playing state
-    int currentPlayingRegularIndex = audioProcessor.getCurrentPlayingRegularRateIndex();
-
-    // Rate labels: "1", "1/2d", "1/2", "1/4d", "1/3", "1/4", "1/8d", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32"
-    auto rateLabels = juce::StringArray { "1", "1/2d", "1/2", "1/4d", "1/3", "1/4", "1/8d", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32" };
-
-    for (int i = 0; i < rateProbLabels.size(); ++i)
+    // Border colour follows the enabled state, glow intensity the playing state:
+    // playing=1.0, next up=0.6, enabled=0.3, disabled=0.0.
+    // Labels are only touched when their state differs from what was last applied.
+    auto applyLabelState = [](RomanNumeralLabel& label, LabelGlowState& shown, juce::Colour sectionColour,
+                              bool isEnabled, bool isPlaying, bool isNext)
     {
-        // Check if this rate is enabled
-        bool isEnabled = audioProcessor.getParameters()
-            .getRawParameterValue("rateActive_" + rateLabels[i])->load() > 0.5f;
+        float glowIntensity = isPlaying ? 1.0f : isNext ? 0.6f : isEnabled ? 0.3f : 0.0f;
 
-        // Check if this is the currently playing rate
-        bool isPlaying = (currentPlayingRegularIndex == i);
+        if (isEnabled != shown.enabled || shown.glow < 0.0f)
+            label.setBorderColour(isEnabled ? sectionColour : sectionColour.darker(0.6f));
+        if (glowIntensity != shown.glow)
+            label.setGlowIntensity(glowIntensity);
 
-        // Set border color based on enabled state
-        if (isEnabled) {
-            rateProbLabels[i]->setBorderColour(ColorPalette::rhythmicOrange);
-        } else {
-            rateProbLabels[i]->setBorderColour(ColorPalette::rhythmicOrange.darker(0.6f));
-        }
-
-        // Set glow intensity: playing=1.0, enabled=0.3, disabled=0.0
-        float glowIntensity = 0.0f;
-        if (isPlaying) {
-            glowIntensity = 1.0f;
-        } else if (isEnabled) {
-            glowIntensity = 0.3f;
-        }
+        shown.enabled = isEnabled;
+        shown.glow = glowIntensity;
+    };
 
-        rateProbLabels[i]->setGlowIntensity(glowIntensity);
+    // Nano interval labels
+    for (int i = 0; i < nanoIntervalLabels.size() && i < (int) nanoActiveParams.size(); ++i)
+    {
+        bool isEnabled = nanoActiveParams[(size_t) i] != nullptr && nanoActiveParams[(size_t) i]->load() > 0.5f;
+        applyLabelState(*nanoIntervalLabels[i], shownNanoLabelStates[(size_t) i], ColorPalette::nanoPurple,
+                        isEnabled, state.playingNanoIndex == i, nextNanoIndex == i);
     }
 
-    // Update quantization label glow effects
-    int currentActiveQuantIndex = audioProcessor.getCurrentQuantIndex();
-
-    // Quant labels: "4", "2", "1", "1/2", "1/4", "1/8d", "1/8", "1/16", "1/32"
-    auto quantLabels = juce::StringArray { "4", "2", "1", "1/2", "1/4", "1/8d", "1/8", "1/16", "1/32" };
-
-    for (int i = 0; i < quantProbLabels.size(); ++i)
+    // Repeat rate labels
+    for (int i = 0; i < rateProbLabels.size() && i < (int) rateActiveParams.size(); ++i)
     {
-        // Check if this quant unit is enabled
-        bool isEnabled = audioProcessor.getParameters()
-            .getRawParameterValue("quantActive_" + quantLabels[i])->load() > 0.5f;
-
-        // Check if this is the currently active quantization unit
-        bool isActive = (currentActiveQuantIndex == i);
-
-        // Set border color based on enabled state
-        if (isEnabled) {
-            quantProbLabels[i]->setBorderColour(ColorPalette::accentCyan);
-        } else {
-            quantProbLabels[i]->setBorderColour(ColorPalette::accentCyan.darker(0.6f));
-        }
-
-        // Set glow intensity: active=1.0, enabled=0.3, disabled=0.0
-        float glowIntensity = 0.0f;
-        if (isActive) {
-            glowIntensity = 1.0f;
-        } else if (isEnabled) {
-            glowIntensity = 0.3f;
-        }
+        bool isEnabled = rateActiveParams[(size_t) i] != nullptr && rateActiveParams[(size_t) i]->load() > 0.5f;
+        applyLabelState(*rateProbLabels[i], shownRateLabelStates[(size_t) i], ColorPalette::rhythmicOrange,
+                        isEnabled, state.playingRegularIndex == i, nextRegularIndex == i);
+    }
 
-        quantProbLabels[i]->setGlowIntensity(glowIntensity);
+    // Quantization labels (active = current quant unit, no "next up" state)
+    for (int i = 0; i < quantProbLabels.size() && i < (int) quantActiveParams.size(); ++i)
+    {
+        bool isEnabled = quantActiveParams[(size_t) i] != nullptr && quantActiveParams[(size_t) i]->load() > 0.5f;
+        applyLabelState(*quantProbLabels[i], shownQuantLabelStates[(size_t) i], ColorPalette::accentCyan,
+                        isEnabled, state.quantIndex == i, false);
     }
 }
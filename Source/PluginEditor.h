@@ -17,160 +17,284 @@
 #include "GlowEffect.h"
 #include "TextureGenerator.h"
 #include "RomanNumeralLabel.h"
+#include "PatternScriptEditor.h"
+#include "UpcomingEventsTimeline.h"
+#include "SpectrumAnalyzer.h"
+#include "SliceThumbnail.h"
+#include "RefreshCoordinator.h"
+#include "GlowSpriteCache.h"
+#include "BackgroundTextureCache.h"
+#include "PaintProfiler.h"
+#include "PresetPreview.h"
+#include <optional>
 
 //==============================================================================
 /**
 */
-class StutterVisualizer : public juce::Component, private juce::Timer
+class StutterVisualizer : public juce::Component, public RefreshClient
 {
 public:
     StutterVisualizer(NanoStuttAudioProcessor& p) : processor(p)
     {
-        startTimerHz(30); // update 30 times per second
+    }
+
+    // The output buffer only advances while audio is processed; idle visualizers never repaint
+    void refresh(const DisplayState& state) override
+    {
+        if (state.outputWritePos != shownWritePos || state.outputBufferSize != shownBufferSize)
+        {
+            shownWritePos = state.outputWritePos;
+            shownBufferSize = state.outputBufferSize;
+            repaint();
+        }
+    }
+
+    void resized() override
+    {
+        // Static layers and waveform image are re-rendered at the next paint
+        cachedScale = 0.0f;
     }
 
     void paint(juce::Graphics& g) override
     {
+        PaintProfiler::Scope profileScope(paintProfiler, g);
         auto bounds = getLocalBounds().toFloat();
         double currentTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
 
+        if (getWidth() <= 0 || getHeight() <= 0)
+            return;
+
         //==============================================================================
-        // LAYER 1: BACKGROUND GRADIENT
+        // CACHED LAYERS: rebuilt only on resize or display scale change
         //==============================================================================
-        juce::ColourGradient bgGradient(
-            juce::Colour(0xff000000),
-            bounds.getX(), bounds.getY(),
-            juce::Colour(0xff0a0a10),
-            bounds.getX(), bounds.getBottom(),
-            false
-        );
-        g.setGradientFill(bgGradient);
-        g.fillRect(bounds);
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (scale != cachedScale || backgroundImage.isNull())
+        {
+            cachedScale = scale;
+            renderStaticLayers();
+            waveformImage = juce::Image(juce::Image::ARGB, imageWidth(), imageHeight(), true);
+            lastRenderedWritePos = -1;  // Full waveform redraw
+        }
+
+        // LAYERS 1-2: BACKGROUND GRADIENT + GRID
+        g.drawImage(backgroundImage, bounds);
 
         //==============================================================================
-        // LAYER 2: GRID PATTERN (Oscilloscope style)
+        // LAYERS 3-4: WAVEFORM WITH GLOW + REFLECTION (incremental)
         //==============================================================================
-        g.setColour(juce::Colours::white.withAlpha(0.03f));
+        const auto& buffer = processor.getOutputBuffer();
+        const int bufferSize = shownBufferSize;
+        const int writePos = shownWritePos;
 
-        // Vertical grid lines (every 1/16 note)
-        int numVerticalLines = 16;
-        for (int i = 0; i <= numVerticalLines; i++)
+        if (bufferSize > 0 && bufferSize <= buffer.getNumSamples() && buffer.getNumChannels() > 0)
         {
-            float x = bounds.getX() + (i * bounds.getWidth() / numVerticalLines);
-            g.drawVerticalLine(static_cast<int>(x), bounds.getY(), bounds.getBottom());
+            updateWaveformImage(bufferSize, writePos);
+            g.drawImage(waveformImage, bounds);
+
+            //==============================================================================
+            // LAYER 5: PLAYHEAD INDICATOR (Gradient with glow)
+            //==============================================================================
+            float playheadX = bounds.getX() + (static_cast<float>(writePos) / bufferSize) * bounds.getWidth();
+
+            // Glow behind playhead: one cached glowing-line sprite, moved to the playhead
+            playheadGlow.drawLine(g, { 0.0f, bounds.getY() }, { 0.0f, bounds.getBottom() },
+                                  { juce::Colours::white, 2.0f, juce::Colours::white, 8.0f },
+                                  1.0f, { playheadX, 0.0f });
+
+            // Top triangle marker
+            juce::Path triangle;
+            triangle.addTriangle(playheadX, bounds.getY(),
+                                  playheadX - 5.0f, bounds.getY() + 8.0f,
+                                  playheadX + 5.0f, bounds.getY() + 8.0f);
+            g.setColour(juce::Colours::white);
+            g.fillPath(triangle);
         }
 
-        // Horizontal grid lines (amplitude markers)
-        int numHorizontalLines = 5;
-        for (int i = 0; i <= numHorizontalLines; i++)
+        //==============================================================================
+        // LAYER 6: SCROLLING SCANLINES
+        //==============================================================================
+        float scrollOffset = std::fmod(static_cast<float>(currentTime * 20.0), 8.0f); // Slow scroll
+        g.setColour(juce::Colours::white.withAlpha(0.05f));
+        for (int i = 0; i < 15; i++)
         {
-            float y = bounds.getY() + (i * bounds.getHeight() / numHorizontalLines);
-            g.drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
+            float y = bounds.getY() + (i * 8.0f) + scrollOffset;
+            if (y < bounds.getBottom())
+                g.drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
         }
 
-        // Brighter center line
-        g.setColour(juce::Colours::white.withAlpha(0.08f));
-        g.drawHorizontalLine(static_cast<int>(bounds.getCentreY()), bounds.getX(), bounds.getRight());
+        // LAYERS 7-8: HUD CORNER BRACKETS + OUTER FRAME
+        g.drawImage(overlayImage, bounds);
+    }
+
+private:
+    int imageWidth() const  { return juce::jmax(1, juce::roundToInt(getWidth() * cachedScale)); }
+    int imageHeight() const { return juce::jmax(1, juce::roundToInt(getHeight() * cachedScale)); }
+
+    // Graphics drawing into a cached image in component coordinates
+    std::unique_ptr<juce::Graphics> createImageGraphics(juce::Image& image) const
+    {
+        auto graphics = std::make_unique<juce::Graphics>(image);
+        graphics->addTransform(juce::AffineTransform::scale(cachedScale));
+        return graphics;
+    }
+
+    void renderStaticLayers()
+    {
+        auto bounds = getLocalBounds().toFloat();
 
         //==============================================================================
-        // LAYER 3: WAVEFORM WITH GLOW
+        // LAYER 1: BACKGROUND GRADIENT
+        //==============================================================================
+        backgroundImage = juce::Image(juce::Image::RGB, imageWidth(), imageHeight(), false);
+        {
+            auto g = createImageGraphics(backgroundImage);
+            juce::ColourGradient bgGradient(
+                juce::Colour(0xff000000),
+                bounds.getX(), bounds.getY(),
+                juce::Colour(0xff0a0a10),
+                bounds.getX(), bounds.getBottom(),
+                false
+            );
+            g->setGradientFill(bgGradient);
+            g->fillRect(bounds);
+
+            //==============================================================================
+            // LAYER 2: GRID PATTERN (Oscilloscope style)
+            //==============================================================================
+            g->setColour(juce::Colours::white.withAlpha(0.03f));
+
+            // Vertical grid lines (every 1/16 note)
+            int numVerticalLines = 16;
+            for (int i = 0; i <= numVerticalLines; i++)
+            {
+                float x = bounds.getX() + (i * bounds.getWidth() / numVerticalLines);
+                g->drawVerticalLine(static_cast<int>(x), bounds.getY(), bounds.getBottom());
+            }
+
+            // Horizontal grid lines (amplitude markers)
+            int numHorizontalLines = 5;
+            for (int i = 0; i <= numHorizontalLines; i++)
+            {
+                float y = bounds.getY() + (i * bounds.getHeight() / numHorizontalLines);
+                g->drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
+            }
+
+            // Brighter center line
+            g->setColour(juce::Colours::white.withAlpha(0.08f));
+            g->drawHorizontalLine(static_cast<int>(bounds.getCentreY()), bounds.getX(), bounds.getRight());
+        }
+
+        //==============================================================================
+        // LAYER 7: HUD CORNER BRACKETS
         //==============================================================================
+        overlayImage = juce::Image(juce::Image::ARGB, imageWidth(), imageHeight(), true);
+        {
+            auto g = createImageGraphics(overlayImage);
+            juce::Path brackets = TextureGenerator::createCornerBracket(bounds, 12, true, true, true, true);
+            g->setColour(ColorPalette::accentCyan.withAlpha(0.4f));
+            g->strokePath(brackets, juce::PathStrokeType(2.0f));
+
+            //==============================================================================
+            // LAYER 8: OUTER FRAME
+            //==============================================================================
+            g->setColour(ColorPalette::frameGrey);
+            g->drawRect(bounds, 1.0f);
+        }
+    }
+
+    // Redraws only the columns written since the last frame (whole image after a resize or BPM change)
+    void updateWaveformImage(int bufferSize, int writePos)
+    {
+        if (bufferSize != lastBufferSize)
+        {
+            lastBufferSize = bufferSize;
+            lastRenderedWritePos = -1;
+        }
+
+        if (lastRenderedWritePos < 0)
+        {
+            renderWaveformRange(0, bufferSize, bufferSize);
+        }
+        else if (writePos > lastRenderedWritePos)
+        {
+            renderWaveformRange(lastRenderedWritePos, writePos, bufferSize);
+        }
+        else if (writePos < lastRenderedWritePos)
+        {
+            // Ring buffer wrapped
+            renderWaveformRange(lastRenderedWritePos, bufferSize, bufferSize);
+            renderWaveformRange(0, writePos, bufferSize);
+        }
+
+        lastRenderedWritePos = writePos;
+    }
+
+    // Clears the strip for buffer range [startIndex, endIndex) and draws it again.
+    // Segments extend past the strip by the glow width so glow and lines join seamlessly.
+    // Outside full redraws, glow is only stroked for the dirty strip.
+    void renderWaveformRange(int startIndex, int endIndex, int bufferSize)
+    {
+        if (endIndex <= startIndex)
+            return;
+
         const auto& buffer = processor.getOutputBuffer();
         const auto& stateBuffer = processor.getStutterStateBuffer();
-        const int bufferSize = processor.getOutputBufferSize();
-        const int writePos = processor.getOutputBufferWritePos();
+        auto bounds = getLocalBounds().toFloat();
 
-        if (bufferSize > 0 && buffer.getNumChannels() > 0)
-        {
-            const int channel = 0; // Show left/mono
-            const float midY = bounds.getCentreY();
-            const float scaleY = bounds.getHeight() * 0.35f;
+        auto indexToX = [&](int index) { return bounds.getX() + (static_cast<float>(index) / bufferSize) * bounds.getWidth(); };
 
-            // Sample every N samples for efficiency
-            const int sampleStep = juce::jmax(1, bufferSize / (static_cast<int>(bounds.getWidth()) * 2));
+        // Sample every N samples for efficiency
+        const int sampleStep = juce::jmax(1, bufferSize / (static_cast<int>(bounds.getWidth()) * 2));
+        const int marginSamples = juce::roundToInt(GLOW_MARGIN_PIXELS / bounds.getWidth() * bufferSize) + sampleStep;
 
-            // Define modern colors
-            const juce::Colour colorNone = ColorPalette::activeGreen;
-            const juce::Colour colorRepeat = ColorPalette::rhythmicOrange;
-            const juce::Colour colorNano = ColorPalette::nanoPurple;
+        // Glow of the new samples also reaches back into the previously drawn strip
+        startIndex = juce::jmax(0, startIndex - marginSamples);
 
-            // Build colored segments
-            int currentState = -1;
-            juce::Path currentPath;
-            juce::Colour currentColor = colorNone;
+        const float x1 = std::floor(indexToX(startIndex));
+        const float x2 = std::ceil(indexToX(endIndex));
+        auto strip = juce::Rectangle<float>(x1, bounds.getY(), x2 - x1, bounds.getHeight());
 
-            for (int i = 0; i < bufferSize; i += sampleStep)
-            {
-                float sample = buffer.getSample(channel, i);
-                int state = stateBuffer[i];
+        {
+            // Clear in image pixels (the strip edges are snapped to physical pixels)
+            auto pixelStrip = (strip * cachedScale).getSmallestIntegerContainer();
+            waveformImage.clear(pixelStrip.getIntersection(waveformImage.getBounds()));
+        }
 
-                float x = bounds.getX() + (static_cast<float>(i) / bufferSize) * bounds.getWidth();
-                float y = midY - sample * scaleY;
+        auto g = createImageGraphics(waveformImage);
+        g->reduceClipRegion(strip.toNearestIntEdges());
 
-                if (state != currentState)
-                {
-                    // Draw previous segment with glow
-                    if (!currentPath.isEmpty())
-                    {
-                        // Outer glow (blur effect with multiple strokes)
-                        GlowEffect::drawStrokeWithGlow(g, currentPath,
-                                                        currentColor, 2.5f,
-                                                        currentColor.withSaturation(0.6f), 6.0f, 4);
-
-                        // Inner highlight
-                        g.setColour(juce::Colours::white.withAlpha(0.3f));
-                        g.strokePath(currentPath, juce::PathStrokeType(1.0f));
-                    }
-
-                    // Start new segment
-                    currentState = state;
-                    currentColor = (state == 0) ? colorNone : (state == 1) ? colorRepeat : colorNano;
-                    currentPath.clear();
-                    currentPath.startNewSubPath(x, y);
-                }
-                else
-                {
-                    currentPath.lineTo(x, y);
-                }
-            }
+        const int channel = 0; // Show left/mono
+        const float midY = bounds.getCentreY();
+        const float scaleY = bounds.getHeight() * 0.35f;
 
-            // Draw final segment with glow
-            if (!currentPath.isEmpty())
-            {
-                GlowEffect::drawStrokeWithGlow(g, currentPath,
-                                                currentColor, 2.5f,
-                                                currentColor.withSaturation(0.6f), 6.0f, 4);
+        const int firstIndex = juce::jmax(0, ((startIndex - marginSamples) / sampleStep) * sampleStep);
+        const int lastIndex = juce::jmin(bufferSize, endIndex + marginSamples);
 
-                g.setColour(juce::Colours::white.withAlpha(0.3f));
-                g.strokePath(currentPath, juce::PathStrokeType(1.0f));
-            }
+        // Define modern colors
+        const juce::Colour colorNone = ColorPalette::activeGreen;
+        const juce::Colour colorRepeat = ColorPalette::rhythmicOrange;
+        const juce::Colour colorNano = ColorPalette::nanoPurple;
 
-            //==============================================================================
-            // LAYER 4: REFLECTION (below waveform)
-            //==============================================================================
-            currentState = -1;
-            currentPath.clear();
-            currentColor = colorNone;
+        auto stateColour = [&](int state) { return (state == 0) ? colorNone : (state == 1) ? colorRepeat : colorNano; };
 
-            for (int i = 0; i < bufferSize; i += sampleStep)
-            {
-                float sample = buffer.getSample(channel, i);
-                int state = stateBuffer[i];
+        // Builds per-state segments and hands each finished one to drawSegment
+        auto traceSegments = [&](float yScale, auto&& drawSegment)
+        {
+            int currentState = -1;
+            juce::Path currentPath;
 
-                float x = bounds.getX() + (static_cast<float>(i) / bufferSize) * bounds.getWidth();
-                float y = midY + sample * scaleY * 0.3f; // Flipped and smaller
+            for (int i = firstIndex; i < lastIndex; i += sampleStep)
+            {
+                float x = indexToX(i);
+                float y = midY + buffer.getSample(channel, i) * yScale;
+                int state = stateBuffer[(size_t) i];
 
                 if (state != currentState)
                 {
                     if (!currentPath.isEmpty())
-                    {
-                        // Reflection with gradient fade
-                        g.setColour(currentColor.withAlpha(0.15f));
-                        g.strokePath(currentPath, juce::PathStrokeType(1.5f));
-                    }
+                        drawSegment(currentPath, stateColour(currentState));
 
                     currentState = state;
-                    currentColor = (state == 0) ? colorNone : (state == 1) ? colorRepeat : colorNano;
                     currentPath.clear();
                     currentPath.startNewSubPath(x, y);
                 }
@@ -181,104 +305,67 @@ public:
             }
 
             if (!currentPath.isEmpty())
-            {
-                g.setColour(currentColor.withAlpha(0.15f));
-                g.strokePath(currentPath, juce::PathStrokeType(1.5f));
-            }
-
-            //==============================================================================
-            // LAYER 5: PLAYHEAD INDICATOR (Gradient with glow)
-            //==============================================================================
-            if (bufferSize > 0)
-            {
-                float playheadX = bounds.getX() + (static_cast<float>(writePos) / bufferSize) * bounds.getWidth();
-                juce::Point<float> topPoint(playheadX, bounds.getY());
-                juce::Point<float> bottomPoint(playheadX, bounds.getBottom());
-
-                // Glow behind playhead
-                GlowEffect::drawGlowingLine(g, topPoint, bottomPoint,
-                                             juce::Colours::white, 2.0f,
-                                             juce::Colours::white, 8.0f);
-
-                // Top triangle marker
-                juce::Path triangle;
-                triangle.addTriangle(playheadX, bounds.getY(),
-                                      playheadX - 5.0f, bounds.getY() + 8.0f,
-                                      playheadX + 5.0f, bounds.getY() + 8.0f);
-                g.setColour(juce::Colours::white);
-                g.fillPath(triangle);
-            }
-        }
+                drawSegment(currentPath, stateColour(currentState));
+        };
 
         //==============================================================================
-        // LAYER 6: SCROLLING SCANLINES
+        // LAYER 3: WAVEFORM WITH GLOW
         //==============================================================================
-        float scrollOffset = std::fmod(static_cast<float>(currentTime * 20.0), 8.0f); // Slow scroll
-        for (int i = 0; i < 15; i++)
+        traceSegments(-scaleY, [&g](const juce::Path& path, juce::Colour colour)
         {
-            float y = bounds.getY() + (i * 8.0f) + scrollOffset;
-            if (y < bounds.getBottom())
-            {
-                g.setColour(juce::Colours::white.withAlpha(0.05f));
-                g.drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
-            }
-        }
+            // Outer glow (blur effect with multiple strokes)
+            GlowEffect::drawStrokeWithGlow(*g, path,
+                                            colour, 2.5f,
+                                            colour.withSaturation(0.6f), 6.0f, 4);
 
-        //==============================================================================
-        // LAYER 7: HUD CORNER BRACKETS
-        //==============================================================================
-        juce::Path brackets = TextureGenerator::createCornerBracket(bounds, 12, true, true, true, true);
-        g.setColour(ColorPalette::accentCyan.withAlpha(0.4f));
-        g.strokePath(brackets, juce::PathStrokeType(2.0f));
+            // Inner highlight
+            g->setColour(juce::Colours::white.withAlpha(0.3f));
+            g->strokePath(path, juce::PathStrokeType(1.0f));
+        });
 
         //==============================================================================
-        // LAYER 8: OUTER FRAME
+        // LAYER 4: REFLECTION (below waveform)
         //==============================================================================
-        g.setColour(ColorPalette::frameGrey);
-        g.drawRect(bounds, 1.0f);
+        traceSegments(scaleY * 0.3f, [&g](const juce::Path& path, juce::Colour colour)
+        {
+            // Reflection with gradient fade
+            g->setColour(colour.withAlpha(0.15f));
+            g->strokePath(path, juce::PathStrokeType(1.5f));
+        });
     }
 
-private:
-    void timerCallback() override { repaint(); }
+    static constexpr float GLOW_MARGIN_PIXELS = 8.0f;   // Glow radius plus stroke width
 
     NanoStuttAudioProcessor& processor;
+
+    juce::Image backgroundImage;        // Layers 1-2
+    juce::Image waveformImage;          // Layers 3-4, updated incrementally
+    juce::Image overlayImage;           // Layers 7-8
+    GlowSprite playheadGlow;            // Layer 5
+    PaintProfiler paintProfiler { "StutterVisualizer" };
+    float cachedScale = 0.0f;
+    int lastBufferSize = 0;
+    int lastRenderedWritePos = -1;
+    int shownWritePos = -1;
+    int shownBufferSize = -1;
 };
 
-class NanoPitchTuner : public juce::Component, private juce::Timer
+class NanoPitchTuner : public juce::Component, public RefreshClient
 {
 public:
     NanoPitchTuner(NanoStuttAudioProcessor& p) : processor(p)
     {
-        startTimerHz(30); // update 30 times per second
+        auto& apvts = processor.getParameters();
+        nanoTuneParam = apvts.getRawParameterValue("nanoTune");
+        nanoBaseParam = apvts.getRawParameterValue("nanoBase");
+        nanoOctaveParam = apvts.getRawParameterValue("NanoOctave");
     }
 
-    void paint(juce::Graphics& g) override
+    // Works out the note readout; repaints only when text or colour changed
+    void refresh(const DisplayState& state) override
     {
-        auto bounds = getLocalBounds().toFloat();
-
-        //==============================================================================
-        // BACKGROUND - Recessed panel with gradient
-        //==============================================================================
-        juce::ColourGradient bgGradient = ColorPalette::createDepthGradient(bounds, ColorPalette::recessedPanel);
-        g.setGradientFill(bgGradient);
-        g.fillRect(bounds);
-
-        // Get current BPM from playhead
-        auto playHead = processor.getPlayHead();
-        double bpm = 120.0;
-        if (playHead != nullptr)
-        {
-            if (auto posInfo = playHead->getPosition())
-            {
-                if (posInfo->getBpm())
-                    bpm = *posInfo->getBpm();
-            }
-        }
-
-        // Get nano base and tuning parameters with null checks
-        auto* nanoTuneParam = processor.getParameters().getRawParameterValue("nanoTune");
-        auto* nanoBaseParam = processor.getParameters().getRawParameterValue("nanoBase");
-        auto* nanoOctaveParam = processor.getParameters().getRawParameterValue("NanoOctave");
+        // BPM of the last processed block (the GUI never queries the host playhead)
+        double bpm = state.playheadBpm;
 
         juce::String displayText = "--";
         juce::Colour textColor = ColorPalette::textInactive;
@@ -292,8 +379,8 @@ public:
             float octaveMultiplier = std::pow(2.0f, nanoOctave);
 
             float frequency;
-            bool isActive = processor.isUsingNanoRate();
-            float storedFrequency = processor.getNanoFrequency();
+            bool isActive = state.usingNanoRate;
+            float storedFrequency = state.nanoFrequency;
 
             // Use stored frequency only if it's valid and we're in active mode
             if (isActive && storedFrequency > 0.0f && std::isfinite(storedFrequency))
@@ -343,6 +430,28 @@ public:
             }
         }
 
+        if (displayText != shownText || textColor != shownColour)
+        {
+            shownText = displayText;
+            shownColour = textColor;
+            repaint();
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        PaintProfiler::Scope profileScope(paintProfiler, g);
+        auto bounds = getLocalBounds().toFloat();
+        const auto& displayText = shownText;
+        const auto& textColor = shownColour;
+
+        //==============================================================================
+        // BACKGROUND - Recessed panel with gradient
+        //==============================================================================
+        juce::ColourGradient bgGradient = ColorPalette::createDepthGradient(bounds, ColorPalette::recessedPanel);
+        g.setGradientFill(bgGradient);
+        g.fillRect(bounds);
+
         //==============================================================================
         // TEXT - Glowing technical font
         //==============================================================================
@@ -375,9 +484,7 @@ public:
         if (textColor == ColorPalette::activeGreen)
         {
             // Glowing green border when active
-            GlowEffect::drawStrokeWithGlow(g, framePath,
-                                            ColorPalette::activeGreen, 1.5f,
-                                            ColorPalette::activeGlow, 3.0f);
+            frameGlow.draw(g, framePath, { ColorPalette::activeGreen, 1.5f, ColorPalette::activeGlow, 3.0f });
         }
         else
         {
@@ -388,13 +495,22 @@ public:
     }
 
 private:
-    void timerCallback() override { repaint(); }
-
     NanoStuttAudioProcessor& processor;
+
+    // Parameters polled by refresh(), resolved once in the constructor
+    std::atomic<float>* nanoTuneParam = nullptr;
+    std::atomic<float>* nanoBaseParam = nullptr;
+    std::atomic<float>* nanoOctaveParam = nullptr;
+
+    juce::String shownText { "--" };
+    juce::Colour shownColour { ColorPalette::textInactive };
+    GlowSprite frameGlow;
+    PaintProfiler paintProfiler { "NanoPitchTuner" };
 };
 
 class NanoStuttAudioProcessorEditor  : public juce::AudioProcessorEditor,
-                                       private juce::Timer
+                                       private RefreshClient,
+                                       private juce::ChangeListener
 {
 public:
     NanoStuttAudioProcessorEditor (NanoStuttAudioProcessor&);
@@ -416,6 +532,15 @@ public:
     juce::Slider timingOffsetSlider;
     juce::Slider fadeLengthSlider;
 
+    // Parameter writes from the morph, slot recalls and linked instances are quiet: attachments never
+    // hear of them, so every attached control is also listed here (by parameter table index) and
+    // refresh() shows the new values
+    std::vector<std::function<void()>> quietWriteFollowers;
+    juce::uint32 shownQuietWrites = 0;
+    template <typename AttachmentType, typename ControlType>
+    std::unique_ptr<AttachmentType> attach(const juce::String& parameterID, ControlType& control);
+    void followQuietWrites(const juce::String& parameterID, std::function<void()> update);
+
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> nanoGateAttachment, nanoShapeAttachment, nanoSmoothAttachment, nanoEmaAttachment, nanoCycleCrossfadeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> nanoGateRandomAttachment, nanoShapeRandomAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> nanoOctaveAttachment, nanoOctaveRandomAttachment;
@@ -440,11 +565,11 @@ public:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverseChanceAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> autoStutterQuantAttachment;
     juce::OwnedArray<juce::Slider> rateProbSliders;
-    juce::OwnedArray<juce::Label> rateProbLabels;
+    juce::OwnedArray<RomanNumeralLabel> rateProbLabels;
     std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> rateProbAttachments;
     
     juce::OwnedArray<juce::Slider> quantProbSliders;
-    juce::OwnedArray<juce::Label> quantProbLabels;
+    juce::OwnedArray<RomanNumeralLabel> quantProbLabels;
     std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> quantProbAttachments;
 
     // Visibility toggle buttons (eye icons)
@@ -485,9 +610,46 @@ public:
 
     juce::ToggleButton advancedViewToggle;
     bool showAdvancedView = false;
+
+    // Advanced view: ratio editors are built on first show, attachments only exist while shown
+    void createAdvancedComponents();
+    void attachAdvancedControls();
+    void detachAdvancedControls();
+    bool advancedComponentsCreated = false;
+    bool attachingAdvancedControls = false;     // Toggle clicks from attaching skip their relayout
+
+    // Active flags the current layout was built for (the simple view only shows active sliders)
+    juce::uint64 readActiveFlagMask() const;
+    juce::uint64 laidOutActiveMask = 0;
+
+    // Editor open latency (reported to the processor on first paint)
+    double constructedAtMs = 0.0;
+    bool firstPaintReported = false;
     int lastTuningSystemIndex = -1;  // Track tuning system changes for UI updates
     int lastScaleIndex = -1;  // Track scale changes for layout updates
 
+    // Parameters polled by refresh(), resolved once in the constructor
+    std::atomic<float>* tuningSystemParam = nullptr;
+    std::atomic<float>* scaleParam = nullptr;
+    std::array<std::atomic<float>*, 13> rateActiveParams {};
+    std::array<std::atomic<float>*, 12> nanoActiveParams {};
+    std::array<std::atomic<float>*, 9> quantActiveParams {};
+
+    // State last applied by refresh(), so unchanged labels are left alone
+    struct LabelGlowState
+    {
+        bool enabled = false;
+        float glow = -1.0f;     // -1 = never applied
+    };
+    std::array<LabelGlowState, 13> shownRateLabelStates;
+    std::array<LabelGlowState, 12> shownNanoLabelStates;
+    std::array<LabelGlowState, 9> shownQuantLabelStates;
+    juce::String shownPresetName;
+    bool shownPresetModified = false;
+    int shownActiveStateSlot = -1;
+    juce::uint32 shownStateSlotRecalls = 0;
+    juce::uint32 shownLinkedTuningUpdates = 0;
+
     juce::Label nanoBlendLabel;
     
     juce::Slider nanoTuneSlider;
@@ -517,6 +679,24 @@ public:
     juce::ComboBox presetMenu;
     juce::Label presetNameLabel;
 
+    // Preset morph: sources A and B, and the morph amount between them
+    juce::TextButton morphAButton;
+    juce::TextButton morphBButton;
+    juce::Slider morphSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> morphAttachment;
+
+    // Preset previews: hovering a preset in the menu plays its background-rendered preview
+    static constexpr int PREVIEW_OFF_ID = 100000;           // "Preview on Hover" items in the preset menu
+    static constexpr int PREVIEW_TEST_LOOP_ID = 100001;
+    static constexpr int PREVIEW_TRACK_INPUT_ID = 100002;
+    static constexpr int SEARCH_PRESETS_ID = 99999;         // "Search User Presets..." item
+    std::unique_ptr<PresetPreviewRenderer> presetPreviews;
+    std::optional<PresetInfo> hoveredPreset;
+    bool presetPreviewsEnabled = true;
+
+    // In-memory state slots (compare A/B/C/D, shown as 1-4 next to the morph sources)
+    std::array<juce::TextButton, StateSlots::NUM_SLOTS> stateSlotButtons;
+
     // Window type selection for nanoSmooth (advanced view only)
     std::unique_ptr<juce::Label> windowTypeLabel;
     juce::ComboBox windowTypeMenu;
@@ -526,6 +706,11 @@ public:
     juce::Label fadeLengthLabel;
 
     StutterVisualizer visualizer;
+    UpcomingEventsTimeline eventTimeline;
+    SpectrumAnalyzer spectrumAnalyzer;      // Shares the visualizer area, toggled by spectrumToggle
+    juce::TextButton spectrumToggle;
+    SliceThumbnail sliceThumbnail;          // Shares the visualizer area, toggled by sliceToggle
+    juce::TextButton sliceToggle;
     NanoPitchTuner tuner;
 
     //==============================================================================
@@ -541,8 +726,23 @@ public:
     void updatePresetMenu();
     void updatePresetNameLabel();
     void onPresetSelected();
+    void loadPresetWithFeedback(const PresetInfo& preset);
+    void showPresetSearch();
+    void onPresetHovered(const PresetInfo& preset, bool highlighted);
+    void onPreviewMenuSelected(int itemId);
+    void updatePreviewSampleRate();
     void onSavePresetClicked();
-    void timerCallback() override;
+    void showMorphSourceMenu(PresetMorph::Source source);
+    void updateMorphButtons();
+    void onStateSlotClicked(int slot);
+    void updateStateSlotButtons();
+    void refresh(const DisplayState& state) override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;  // Background texture ready, preset library changed
+
+    // Rate transition (Markov) menu, opened by right-clicking the Repeat Rates label
+    void mouseDown(const juce::MouseEvent& event) override;
+    void showRateTransitionMenu();
+    void showOccurrenceMenu();  // Opened by right-clicking the Chance label
 
 private:
     // Stored bounds for drawing colored borders
@@ -550,6 +750,11 @@ private:
     juce::Rectangle<int> nanoSlidersBounds;
     juce::Rectangle<int> quantizationSlidersBounds;
 
+    // Cached glowing section borders
+    GlowSprite quantBorderGlow;
+    GlowSprite rhythmicBorderGlow;
+    GlowSprite nanoBorderGlow;
+
     // SVG panel backgrounds
     std::unique_ptr<juce::Drawable> quantPanelSVG;
     std::unique_ptr<juce::Drawable> rhythmicPanelSVG;
@@ -562,6 +767,7 @@ private:
     void layoutQuantizationControls(juce::Rectangle<int> bounds);
     void layoutRightPanel(juce::Rectangle<int> bounds);
     void layoutVisualizer(juce::Rectangle<int> bounds);
+    void updateVisualizerView();
     std::vector<std::unique_ptr<juce::TextButton>> manualStutterButtons;
     std::vector<double> manualStutterRates { 1.0, 4.0/3.0, 2.0, 3.0, 4.0, 6.0, 16.0/3.0, 8.0, 12.0, 16.0, 24.0, 32.0 }; // Denominators
 
@@ -573,12 +779,23 @@ private:
     juce::TextButton resetQuantProbButton;
     juce::TextButton randomizeQuantProbButton;
 
+    // File chooser for learning rate transitions from MIDI (kept alive while open)
+    std::unique_ptr<juce::FileChooser> rateTransitionFileChooser;
+
     // Modern LookAndFeel for futuristic/technical UI styling
     ModernLookAndFeel modernLookAndFeel;
 
+    PaintProfiler paintProfiler { "Editor" };
+
+    // Neumorphic noise texture, generated once per size/scale and shared by all editors
+    juce::SharedResourcePointer<BackgroundTextureCache> backgroundTextures;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     NanoStuttAudioProcessor& audioProcessor;
 
+    // Drives all periodic UI updates from vblank (declared last so it stops first)
+    RefreshCoordinator refreshCoordinator;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NanoStuttAudioProcessorEditor)
 };
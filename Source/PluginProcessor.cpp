@@ -8,6 +8,15 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "BinaryState.h"
+
+namespace
+{
+    // The processor whose parameter batch is running on this thread, if any. Batches run on the
+    // audio thread (morph, slot recall, linked state) and on the message thread (state restore,
+    // presets) at the same time, so each thread only ever sees and clears its own
+    thread_local const NanoStuttAudioProcessor* threadParameterBatch = nullptr;
+}
 
 //==============================================================================
 NanoStuttAudioProcessor::NanoStuttAudioProcessor()
@@ -15,15 +24,35 @@ NanoStuttAudioProcessor::NanoStuttAudioProcessor()
                       .withInput ("Input",  juce::AudioChannelSet::stereo(), true)
                       .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       parameters(*this, nullptr, "PARAMETERS", createParameterLayout()),
-      presetManager(parameters)
+      presetManager(parameters),
+      parameterTable(*this)
 {
+    presetMorph.prepare(parameterTable, PresetManager::getSessionParameterIDs());
+    stateSlots.prepare(parameterTable, PresetManager::getSessionParameterIDs());
+    linkMember.prepare(parameterTable, PresetManager::getSessionParameterIDs());
+    presetMorphAmount = parameters.getRawParameterValue("presetMorph");
+    stateLinkChannel = parameters.getRawParameterValue("stateLink");
+    linkExcludeMix = parameters.getRawParameterValue("linkExcludeMix");
+    linkExcludeTuning = parameters.getRawParameterValue("linkExcludeTuning");
+
+    // Presets load through the same batched path as session state
+    presetManager.setStateApplier(parameterTable, [this](const std::vector<float>& values, const juce::ValueTree& children)
+    {
+        applyParameterState(values, children);
+    });
+
+    cacheParameterPointers();
     initializeParameterListeners();
     updateNanoRatiosFromTuning();     // Initialize ratios from default tuning system
     updateNanoVisibilityFromScale();  // Initialize scale slider visibility
+
+    // Reload the rate transition matrix whenever the state is replaced (session or preset load)
+    parameters.state.addListener(this);
 }
 
 NanoStuttAudioProcessor::~NanoStuttAudioProcessor()
 {
+    parameters.state.removeListener(this);
 }
 
 //==============================================================================
@@ -104,6 +133,9 @@ void NanoStuttAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
     maxStutterLenSamples = static_cast<int>(sampleRate * MAX_STUTTER_BUFFER_SECONDS);
     stutterBuffer.setSize(getTotalNumOutputChannels(), maxStutterLenSamples, false, true, true);
 
+    previewInput.prepare(sampleRate, getTotalNumOutputChannels());
+    previewPlayer.prepare(sampleRate, getTotalNumOutputChannels());
+
     float fadeLengthMs = parameters.getRawParameterValue("FadeLength")->load();
     fadeLengthInSamples = static_cast<int>(sampleRate * (fadeLengthMs / 1000.0));
 
@@ -202,6 +234,26 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     auto numSamples             = buffer.getNumSamples();
     auto sampleRate             = getSampleRate();
 
+    // A hovered preset's preview replaces the output (faded), whichever way the block ends, but only
+    // while the transport is stopped and never in an offline render, so it cannot end up in the mix
+    bool previewAudible = !isNonRealtime();
+    const juce::ScopeGuard playPreview { [this, &buffer, &previewAudible] { previewPlayer.process(buffer, previewAudible); } };
+
+    // Preset morph: one pass over the A/B plan, only when the amount (or a source) changed
+    if (presetMorph.isActive())
+        applyPresetMorph(presetMorphAmount->load());
+
+    // State slot recall: right away while no event plays, otherwise where the next event samples its parameters
+    if (stateSlots.hasPendingRecall() && !autoStutterActive)
+        applyStateSlotRecall();
+
+    // Linked instances: send this instance's edits, then apply the channel's (after the morph and
+    // recall, so those are sent too)
+    applyLinkedState();
+
+    // Derived tables for whatever changed since the last block, from any thread
+    refreshCachedParameters();
+
     // Update fade length based on current parameter value
     float fadeLengthMs = parameters.getRawParameterValue("FadeLength")->load();
     fadeLengthInSamples = static_cast<int>(sampleRate * (fadeLengthMs / 1000.0));
@@ -215,6 +267,7 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
 
     auto position = playHead->getPosition();
     bool isPlaying = position && position->getIsPlaying();
+    previewAudible = previewAudible && !isPlaying;
     double currentPpqPosition = position ? position->getPpqPosition().orFallback(0.0) : 0.0;
 
     // Get parameters early for transport reset logic
@@ -226,6 +279,31 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     auto cachedNanoWeights = nanoRateWeights;
     auto cachedQuantWeights = quantUnitWeights;
     float cachedNanoBlend = nanoBlend;
+    bool useMarkovRates = params.getRawParameterValue("rateSelectionMode")->load() > 0.5f;
+    auto cachedOccurrenceMode = occurrenceMode;
+    auto cachedEuclideanMask = euclideanMask;
+    int cachedEuclideanSteps = euclideanSteps;
+    bool usePatternScript = params.getRawParameterValue("patternScriptEnabled")->load() > 0.5f;
+
+    // Cross-instance group sync: leaders publish decisions, followers apply them
+    int syncGroup = static_cast<int>(params.getRawParameterValue("syncGroup")->load());
+    bool isGroupFollower = syncGroup > 0 && params.getRawParameterValue("syncRole")->load() > 0.5f;
+    bool isGroupLeader = syncGroup > 0 && !isGroupFollower;
+    bool followGroupRates = params.getRawParameterValue("syncFollowRates")->load() > 0.5f;
+    groupTransportPosition = static_cast<int>(std::floor(currentPpqPosition / THIRTY_SECOND_NOTE_PPQ));
+    if (isGroupLeader)
+        groupRegistry->touchLeader(syncGroup, groupTransportPosition);
+    if (!isGroupFollower)
+        groupDecisionPending = false;
+
+    // UI telemetry (visualizer buffer, tuner and rate-glow atomics) is only produced while an editor is open
+    const bool uiTelemetry = editorAttached.load(std::memory_order_relaxed);
+    if (!uiTelemetry)
+        lastOutputWriteIndex = -1;  // No gap fill across the unwritten stretch once an editor opens
+    else
+        previewInput.push(buffer, numSamples);  // Source for previews over the track's own input
+
+    uiState.transportPlaying = isPlaying;
 
     // TRANSPORT STATE DETECTION AND STOP FADE
     bool transportJustStopped = wasPlaying && !isPlaying;
@@ -260,10 +338,13 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         heldNanoShapeRandomOffset = 0.0f;
         heldNanoEmaRandomOffset = 0.0f;
         heldCycleCrossfadeRandomOffset = 0.0f;
-        currentlyUsingNanoRate.store(false);
-        currentNanoFrequency.store(0.0f);
-        currentPlayingNanoRateIndex.store(-1);
-        currentPlayingRegularRateIndex.store(-1);
+        currentlyUsingNanoRate = false;
+        currentNanoFrequency = 0.0f;
+        currentPlayingNanoRateIndex = -1;
+        currentPlayingRegularRateIndex = -1;
+        sliceBuilder.cancel();
+        if (uiTelemetry)
+            publishUiSnapshot();
         return;
     }
 
@@ -272,6 +353,9 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     bool positionJumped = wasPlaying && std::abs(currentPpqPosition - lastPpqPosition) > THIRTY_SECOND_NOTE_PPQ; // Allow small timing variations
 
     if (transportJustStarted || positionJumped) {
+        // Previously announced events will not play at their announced position
+        upcomingEvents.invalidate();
+
         // Clear buffers on transport start to prevent stale audio clicks
         if (transportJustStarted) {
             stutterBuffer.clear();
@@ -291,6 +375,9 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
             // Reset stop fade state
             isFadingToStopTransport = false;
             stopFadeRemainingSamples = 0;
+
+            // Markov chain starts from the base distribution again
+            lastMarkovSlot = RateMarkovChain::NO_PREVIOUS_SLOT;
         }
 
         // Set flag to handle first sample after position jump carefully
@@ -312,7 +399,7 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
             THIRTY_SECOND_NOTE_PPQ,        // 1/16
             THIRTY_SECOND_NOTE_PPQ / 2.0   // 1/32
         };
-        static const std::array<int, 9> quantToNewBeatValues = {128, 64, 32, 16, 8, 6, 4, 2, 1}; // 1/32nds per unit
+        const auto& quantToNewBeatValues = QUANT_UNIT_THIRTY_SECONDS; // 1/32nds per unit
 
         // Find smallest active quantization unit (highest frequency)
         double activeQuantUnit = THIRTY_SECOND_NOTE_PPQ * 2.0; // Default to 1/8th
@@ -407,6 +494,10 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
 
     double ppqPerSample = (bpm / SECONDS_PER_MINUTE) / sampleRate;
 
+    // Playhead for the editor (same PPQ space as the scheduler)
+    uiState.playheadPpq = ppqAtStartOfBlock;
+    uiState.playheadBpm = bpm;
+
     // True stereo buffer capture - preserve stereo separation with circular buffer handling
     if (maxStutterLenSamples > 0 && numSamples > 0) {
         for (int ch = 0; ch < totalNumOutputChannels && ch < stutterBuffer.getNumChannels(); ++ch) {
@@ -432,6 +523,7 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
             }
         }
     }
+    sliceBuilder.addCaptured(numSamples);
 
     // =================================================================================
     // MAIN PROCESSING LOOP - THREE DECISION POINT ARCHITECTURE
@@ -533,10 +625,10 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                 heldNanoShapeRandomOffset = 0.0f;
                 heldNanoEmaRandomOffset = 0.0f;
                 heldCycleCrossfadeRandomOffset = 0.0f;
-                currentlyUsingNanoRate.store(false);
-                currentNanoFrequency.store(0.0f);
-                currentPlayingNanoRateIndex.store(-1);
-                currentPlayingRegularRateIndex.store(-1);
+                currentlyUsingNanoRate = false;
+                currentNanoFrequency = 0.0f;
+                currentPlayingNanoRateIndex = -1;
+                currentPlayingRegularRateIndex = -1;
             }
 
             // Skip remaining processing for this sample
@@ -576,10 +668,10 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
             heldCycleCrossfadeRandomOffset = 0.0f;
 
             // Reset nano rate tracking
-            currentlyUsingNanoRate.store(false);
-            currentNanoFrequency.store(0.0f);
-            currentPlayingNanoRateIndex.store(-1);
-            currentPlayingRegularRateIndex.store(-1);
+            currentlyUsingNanoRate = false;
+            currentNanoFrequency = 0.0f;
+            currentPlayingNanoRateIndex = -1;
+            currentPlayingRegularRateIndex = -1;
 
             // Add post-stutter silence if macro gate < 1.0
             // Use CURRENT parameters (the event that just ended)
@@ -589,6 +681,10 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         }
 
 
+        // GROUP SYNC: followers pick up the leader's decision as soon as it is published
+        if (groupDecisionPending)
+            applyGroupDecision(syncGroup, followGroupRates, autoStutter);
+
         // =============================================================================
         // DECISION POINT 1: START OF STUTTER EVENT
         // At the start of a stutter event:
@@ -606,15 +702,21 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
 
             if (quantCount >= quantToNewBeat){
                 if (postStutterSilence > 0) postStutterSilence = 0;
+
+                // GROUP SYNC: no decision from the leader for this unit - stay silent and
+                // fall back to the 1/32 grid so the next unit the leader publishes is caught
+                if (groupDecisionPending) {
+                    groupDecisionPending = false;
+                    stutterIsScheduled = false;
+                    nextQuantIndex = 8;
+                }
                 
                 // Update quantization from previous decision
                 if (currentQuantIndex != nextQuantIndex) {
                     currentQuantIndex = nextQuantIndex;
 
                     // Use lookup table for quantToNewBeat values (matches quantization system)
-                    // Array order: 4bar, 2bar, 1bar, 1/2, 1/4, d1/8, 1/8, 1/16, 1/32
-                    static const std::array<int, 9> quantToNewBeatValues = {128, 64, 32, 16, 8, 6, 4, 2, 1};
-                    quantToNewBeat = quantToNewBeatValues[currentQuantIndex];
+                    quantToNewBeat = QUANT_UNIT_THIRTY_SECONDS[currentQuantIndex];
 
                     // Debug output
                     static const std::array<const char*, 9> quantLabels = {"4bar", "2bar", "1bar", "1/2", "1/4", "d1/8", "1/8", "1/16", "1/32"};
@@ -631,7 +733,7 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                 quantCount = totalThirtySeconds - currentBoundary;
                 
                 // Calculate stutter event duration for this quantization unit
-                float gateScale = params.getRawParameterValue("autoStutterGate")->load();
+                float gateScale = pendingGateScale >= 0.0f ? pendingGateScale : params.getRawParameterValue("autoStutterGate")->load();
                 double quantDurationSeconds = (WHOLE_NOTE_SECONDS_MULTIPLIER / bpm) * staticQuantUnit * (quantToNewBeat-quantCount);
                 double gateDurationSeconds = juce::jlimit(quantDurationSeconds / 8.0, quantDurationSeconds, quantDurationSeconds * gateScale);
                 stutterEventLengthSamples = static_cast<int>(sampleRate * gateDurationSeconds);
@@ -644,54 +746,52 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                     autoStutterActive = true;
                     secondsPerWholeNote = WHOLE_NOTE_SECONDS_MULTIPLIER / bpm;
 
-                    // DECISION: Whether this stutter event should be reversed
+                    // DECISION: Whether this stutter event should be reversed (pattern script or group leader may force it)
                     float reverseChance = parameters.getRawParameterValue("reverseChance")->load();
                     currentStutterIsReversed = juce::Random::getSystemRandom().nextFloat() < reverseChance;
+                    if (pendingReverse >= 0)
+                        currentStutterIsReversed = pendingReverse > 0;
                     firstRepeatCyclePlayed = false;
                     cycleCompletionCounter = 0; // Reset cycle counter for new stutter event
                     lastLoopPos = -1; // Reset cycle detection for new stutter event
 
 
                     // DECISION: Nano vs Rhythmical system selection
-                    bool useNano = juce::Random::getSystemRandom().nextFloat() < cachedNanoBlend;
-                    int selectedIndex = useNano ? selectWeightedIndex(cachedNanoWeights, 0) : selectWeightedIndex(cachedRegularWeights, 0);
+                    // Normally decided one unit ahead when scheduling; only group followers
+                    // that pick their own rates draw it here
+                    int rateSlot = pendingRateSlot >= 0
+                        ? pendingRateSlot
+                        : drawRateSlot(useMarkovRates, cachedRegularWeights, cachedNanoWeights, cachedNanoBlend);
+
+                    bool useNano = RateMarkovChain::isNanoSlot(rateSlot);
+                    int selectedIndex = RateMarkovChain::toSystemIndex(rateSlot);
+                    lastMarkovSlot = rateSlot;
                     
                     // DECISION: Rate selection from chosen system
                     if (useNano) {
-                        double currentNanoTune = params.getRawParameterValue("nanoTune")->load();
-                        double octaveMultiplier = std::pow(2.0, currentNanoOctaveParam);
-
-                        double nanoBase;
-                        if (currentNanoBase == NanoTuning::NanoBase::BPMSynced) {
-                            // Original BPM-synced calculation
-                            nanoBase = ((SECONDS_PER_MINUTE / bpm) / 16.0) / currentNanoTune / octaveMultiplier;
-                        } else {
-                            // Note-based frequency calculation
-                            float noteFreq = NanoTuning::getNoteFrequency(currentNanoBase);
-                            if (noteFreq > 0.0f) {
-                                nanoBase = (1.0 / noteFreq) / currentNanoTune / octaveMultiplier;
-                            } else {
-                                // Fallback to BPM-synced if something goes wrong
-                                nanoBase = ((SECONDS_PER_MINUTE / bpm) / 16.0) / currentNanoTune / octaveMultiplier;
-                            }
-                        }
-
+                        double nanoBase = getNanoBasePeriod(bpm, currentNanoOctaveParam);
                         double sliceDuration = nanoBase / runtimeNanoRatios[selectedIndex];
                         chosenDenominator = WHOLE_NOTE_SECONDS_MULTIPLIER / (bpm * sliceDuration);
 
                         // Update nano rate tracking for tuner and UI
-                        currentlyUsingNanoRate.store(true);
-                        currentNanoFrequency.store(static_cast<float>(1.0 / sliceDuration));
-                        currentPlayingNanoRateIndex.store(selectedIndex);  // Store which nano rate is playing
-                        currentPlayingRegularRateIndex.store(-1);  // No regular rate playing when nano is active
+                        if (uiTelemetry)
+                        {
+                            currentlyUsingNanoRate = true;
+                            currentNanoFrequency = static_cast<float>(1.0 / sliceDuration);
+                            currentPlayingNanoRateIndex = selectedIndex;  // Store which nano rate is playing
+                            currentPlayingRegularRateIndex = -1;  // No regular rate playing when nano is active
+                        }
                     } else {
                         chosenDenominator = regularDenominators[selectedIndex];
 
                         // Using regular rate - track for UI glow effects
-                        currentlyUsingNanoRate.store(false);
-                        currentNanoFrequency.store(0.0f);
-                        currentPlayingNanoRateIndex.store(-1);  // No nano rate playing
-                        currentPlayingRegularRateIndex.store(selectedIndex);  // Store which regular rate is playing (0-12)
+                        if (uiTelemetry)
+                        {
+                            currentlyUsingNanoRate = false;
+                            currentNanoFrequency = 0.0f;
+                            currentPlayingNanoRateIndex = -1;  // No nano rate playing
+                            currentPlayingRegularRateIndex = selectedIndex;  // Store which regular rate is playing (0-12)
+                        }
                     }
                     
                     autoStutterRemainingSamples = stutterEventLengthSamples;
@@ -745,6 +845,11 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                     int loopLen = std::clamp(static_cast<int>((secondsPerWholeNote / chosenDenominator) * sampleRate), 1, maxStutterLenSamples);
                     heldNanoEnvelopeLengthInSamples = std::max(1, static_cast<int>((float)loopLen * nanoGateMultiplier));
 
+                    // Slice thumbnail: summarise the region this event loops while it is being recorded
+                    ++sliceEventCounter;
+                    if (uiTelemetry && sliceThumbnailActive.load(std::memory_order_relaxed))
+                        sliceBuilder.start(sliceEventCounter, stutterWritePos, loopLen, numSamples - i);
+
                     // Transfer EMA state from crossfade to wet processing for seamless continuation
                     // Scale by first sample's envelope gain to prevent jumps when shape curve starts near zero
                     if (currentNanoEmaParam > 0.0f) {  // Only if EMA filtering is active
@@ -780,29 +885,111 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                     heldNanoEmaRandomOffset = 0.0f;
                     heldCycleCrossfadeRandomOffset = 0.0f;
                     // Reset rate indices when no stutter is active - clears playing glow
-                    currentPlayingNanoRateIndex.store(-1);
-                    currentPlayingRegularRateIndex.store(-1);
+                    currentPlayingNanoRateIndex = -1;
+                    currentPlayingRegularRateIndex = -1;
                 }
                 
                 // SCHEDULE NEXT STUTTER EVENT
-                float randomValue = juce::Random::getSystemRandom().nextFloat();
-                if (autoStutter && randomValue < chance) {
-                    stutterIsScheduled = true;
+                int nextUnitStart = currentBoundary + quantToNewBeat;   // In 1/32 notes
+                pendingRateSlot = -1;
+                pendingReverse = -1;
+                pendingGateScale = -1.0f;
+
+                if (isGroupFollower) {
+                    // GROUP SYNC: the leader decides this unit, applied once it is published
+                    stutterIsScheduled = false;
+                    groupDecisionPending = true;
+                    pendingGroupUnitStart = nextUnitStart;
                 } else {
-                    stutterIsScheduled = false; // Explicitly set to false when not scheduling
-                }
+                    // DECIDE NEXT QUANTIZATION UNIT of the scheduled event (it starts at nextUnitStart)
+                    // Default to 1/8th (index 6, not 1!) when all weights are 0
+                    nextQuantIndex = selectWeightedIndex(cachedQuantWeights, 6);
 
-                // DECIDE NEXT QUANTIZATION UNIT for future events
-                // Default to 1/8th (index 6, not 1!) when all weights are 0
-                nextQuantIndex = selectWeightedIndex(cachedQuantWeights, 6);
+                    // Debug output for quant selection
+                    static const std::array<const char*, 9> quantLabels = {"4bar", "2bar", "1bar", "1/2", "1/4", "d1/8", "1/8", "1/16", "1/32"};
+                    DBG("[QUANT SELECT] Index: " << nextQuantIndex << " (" << quantLabels[nextQuantIndex] << ") | "
+                        << "Weights: [" << cachedQuantWeights[0] << "," << cachedQuantWeights[1] << ","
+                        << cachedQuantWeights[2] << "," << cachedQuantWeights[3] << "," << cachedQuantWeights[4] << ","
+                        << cachedQuantWeights[5] << "," << cachedQuantWeights[6] << "," << cachedQuantWeights[7] << ","
+                        << cachedQuantWeights[8] << "]");
+
+                    // Index of the scheduled unit in its own unit size, counted from the start of the song
+                    // (a quant change re-phases the count onto the new unit, so patterns stay bar-locked)
+                    int scheduledUnitLength = QUANT_UNIT_THIRTY_SECONDS[(size_t) nextQuantIndex];
+                    int nextUnitIndex = static_cast<int>(std::floor(static_cast<double>(nextUnitStart) / scheduledUnitLength));
+
+                    // Euclidean modes: the scheduled unit may only fire on a pattern hit
+                    bool patternAllows = true;
+                    if (cachedOccurrenceMode != OccurrenceMode::Chance)
+                        patternAllows = isEuclideanHit(cachedEuclideanMask, cachedEuclideanSteps, nextUnitIndex);
+
+                    float randomValue = juce::Random::getSystemRandom().nextFloat();
+                    bool chanceAllows = (cachedOccurrenceMode == OccurrenceMode::Euclidean) || randomValue < chance;
+                    bool shouldFire = patternAllows && chanceAllows;
+
+                    // PATTERN SCRIPT: runs once per unit with the built-in decision as its default
+                    if (usePatternScript) {
+                        double nextUnitPpq = nextUnitStart * THIRTY_SECOND_NOTE_PPQ;
+
+                        std::fill(scriptRegisters.begin(), scriptRegisters.end(), 0.0f);
+                        scriptRegisters[PatternScript::Bar] = static_cast<float>(std::floor(nextUnitPpq / WHOLE_NOTE_QUARTERS));
+                        scriptRegisters[PatternScript::Beat] = static_cast<float>(nextUnitPpq - std::floor(nextUnitPpq / WHOLE_NOTE_QUARTERS) * WHOLE_NOTE_QUARTERS);
+                        scriptRegisters[PatternScript::Unit] = static_cast<float>(nextUnitIndex);
+                        scriptRegisters[PatternScript::Quant] = static_cast<float>(currentQuantIndex);
+                        scriptRegisters[PatternScript::Last] = static_cast<float>(lastMarkovSlot);
+                        scriptRegisters[PatternScript::Chance] = chance;
+                        scriptRegisters[PatternScript::RevChance] = params.getRawParameterValue("reverseChance")->load();
+                        scriptRegisters[PatternScript::Blend] = cachedNanoBlend;
+                        scriptRegisters[PatternScript::Fire] = shouldFire ? 1.0f : 0.0f;
+                        scriptRegisters[PatternScript::Rate] = -1.0f;
+                        scriptRegisters[PatternScript::Reverse] = -1.0f;
+
+                        // Faulted or over-budget scripts leave the built-in decision untouched
+                        if (patternScript.run(scriptRegisters, juce::Random::getSystemRandom())) {
+                            shouldFire = scriptRegisters[PatternScript::Fire] != 0.0f;
+
+                            // Slots switched off (or hidden by the scale) fall back to the weighted draw
+                            float rate = scriptRegisters[PatternScript::Rate];
+                            if (rate >= 0.0f && rate < RateMarkovChain::NUM_SLOTS && isRateSlotActive(static_cast<int>(rate)))
+                                pendingRateSlot = static_cast<int>(rate);
+
+                            float reverse = scriptRegisters[PatternScript::Reverse];
+                            if (reverse >= 0.0f)
+                                pendingReverse = reverse > 0.0f ? 1 : 0;
+                        }
+                    }
 
-                // Debug output for quant selection
-                static const std::array<const char*, 9> quantLabels = {"4bar", "2bar", "1bar", "1/2", "1/4", "d1/8", "1/8", "1/16", "1/32"};
-                DBG("[QUANT SELECT] Index: " << nextQuantIndex << " (" << quantLabels[nextQuantIndex] << ") | "
-                    << "Weights: [" << cachedQuantWeights[0] << "," << cachedQuantWeights[1] << ","
-                    << cachedQuantWeights[2] << "," << cachedQuantWeights[3] << "," << cachedQuantWeights[4] << ","
-                    << cachedQuantWeights[5] << "," << cachedQuantWeights[6] << "," << cachedQuantWeights[7] << ","
-                    << cachedQuantWeights[8] << "]");
+                    if (autoStutter && shouldFire) {
+                        stutterIsScheduled = true;
+                    } else {
+                        stutterIsScheduled = false; // Explicitly set to false when not scheduling
+                    }
+
+                    // DECIDE AHEAD: rate, reverse and gate of the scheduled event are fixed now, one unit
+                    // before it starts, so the editor can preview it and the event start only applies them
+                    if (stutterIsScheduled) {
+                        if (pendingRateSlot < 0)
+                            pendingRateSlot = drawRateSlot(useMarkovRates, cachedRegularWeights, cachedNanoWeights, cachedNanoBlend);
+                        if (pendingReverse < 0)
+                            pendingReverse = juce::Random::getSystemRandom().nextFloat() < params.getRawParameterValue("reverseChance")->load() ? 1 : 0;
+                    }
+                    pendingGateScale = params.getRawParameterValue("autoStutterGate")->load();
+
+                    // GROUP SYNC: the leader publishes the decision, so every member plays the same event
+                    if (isGroupLeader) {
+                        StutterGroupRegistry::Decision decision;
+                        decision.unitStart = nextUnitStart;
+                        decision.fire = stutterIsScheduled;
+                        decision.rateSlot = pendingRateSlot;
+                        decision.reverse = pendingReverse;
+                        decision.quantIndex = nextQuantIndex;
+                        decision.gate = pendingGateScale;
+                        groupRegistry->publish(syncGroup, decision);
+                    }
+
+                    if (stutterIsScheduled)
+                        announceUpcomingEvent(nextUnitStart);
+                }
 
 
             }
@@ -824,6 +1011,13 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
 
         if (stutterStartingSoon) {
             if (!parametersSampledForUpcomingEvent) {
+                // A pending slot recall lands here, so the upcoming event starts with the recalled sound
+                if (stateSlots.hasPendingRecall())
+                {
+                    applyStateSlotRecall();
+                    refreshCachedParameters();
+                }
+
                 // Sample ALL macro envelope parameters into NEXT event parameters
                 // These will be swapped to current when the new event starts
                 // This prevents automation bleeding - new values only apply to upcoming events
@@ -1800,8 +1994,8 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
 
             buffer.setSample(ch, i, outputSample);
 
-            // Copy final output to visualization buffer (only once per sample, not per channel)
-            if (ch == 0 && outputBufferMaxSamples > 0)
+            // Copy final output to visualization buffer (only once per sample, not per channel, only with an editor open)
+            if (uiTelemetry && ch == 0 && outputBufferMaxSamples > 0)
             {
                 // Calculate write position directly from PPQ (modulo 1.0 gives position within quarter note)
                 double currentPpqForSample = ppqAtStartOfBlock + (i * ppqPerSample);
@@ -1812,7 +2006,7 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
                 int currentState = 0;
                 if (autoStutterActive)
                 {
-                    currentState = currentlyUsingNanoRate.load() ? 2 : 1;
+                    currentState = currentlyUsingNanoRate ? 2 : 1;
                 }
 
                 // Fill gaps between last write and current write to avoid aliasing
@@ -1840,7 +2034,7 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
 
                 // Update tracking for next iteration
                 lastOutputWriteIndex = writeIndex;
-                outputBufferWritePos.store(writeIndex);
+                outputBufferWritePos = writeIndex;
             }
         }
 
@@ -1888,8 +2082,8 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     // Safety check: Ensure nano flags are always reset when not actively stuttering
     // This prevents the tuner from getting stuck showing stale frequency data
     if (!autoStutterActive) {
-        currentlyUsingNanoRate.store(false);
-        currentNanoFrequency.store(0.0f);
+        currentlyUsingNanoRate = false;
+        currentNanoFrequency = 0.0f;
     }
 
     writePos = (writePos + numSamples) % maxStutterLenSamples;
@@ -1909,6 +2103,74 @@ void NanoStuttAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         auto context = juce::dsp::ProcessContextReplacing<float>(audioBlock);
         waveshaperChain.process(context);
     }
+
+    // Spectrum analyzer: one push of the final output per block, only while it is shown
+    if (uiTelemetry && analyzerActive.load(std::memory_order_relaxed) && buffer.getNumChannels() > 0)
+        analyzerFifo.push(buffer.getReadPointer(0), numSamples);
+
+    // Slice thumbnail: a bounded part of the summary per block
+    if (uiTelemetry && sliceBuilder.process(stutterBuffer))
+        sliceSummaries.push(sliceBuilder.getSummary());
+
+    if (uiTelemetry)
+        publishUiSnapshot();
+}
+
+double NanoStuttAudioProcessor::getNanoBasePeriod(double bpm, double octave) const
+{
+    double currentNanoTune = parameters.getRawParameterValue("nanoTune")->load();
+    double octaveMultiplier = std::pow(2.0, octave);
+
+    if (currentNanoBase != NanoTuning::NanoBase::BPMSynced)
+    {
+        // Note-based frequency calculation
+        float noteFreq = NanoTuning::getNoteFrequency(currentNanoBase);
+        if (noteFreq > 0.0f)
+            return (1.0 / noteFreq) / currentNanoTune / octaveMultiplier;
+    }
+
+    // BPM-synced (also the fallback if the note frequency is invalid)
+    return ((SECONDS_PER_MINUTE / bpm) / 16.0) / currentNanoTune / octaveMultiplier;
+}
+
+void NanoStuttAudioProcessor::publishUiSnapshot()
+{
+    uiState.autoStutterActive = autoStutterActive;
+    uiState.usingNanoRate = currentlyUsingNanoRate;
+    uiState.nanoFrequency = currentNanoFrequency;
+    uiState.playingNanoIndex = currentPlayingNanoRateIndex;
+    uiState.playingRegularIndex = currentPlayingRegularRateIndex;
+    uiState.quantIndex = currentQuantIndex;
+    uiState.outputWritePos = outputBufferWritePos;
+    uiState.outputBufferSize = outputBufferMaxSamples;
+    uiState.sampleRate = getSampleRate();
+    uiState.activeStateSlot = stateSlots.getActiveSlot();
+    uiState.stateSlotRecalls = stateSlotRecallCounter;
+    uiState.linkedTuningUpdates = linkedTuningUpdateCounter;
+
+    // Nano slot frequencies at the un-randomized octave (spectrum overlay)
+    double basePeriod = getNanoBasePeriod(uiState.playheadBpm, parameters.getRawParameterValue("NanoOctave")->load());
+    for (size_t i = 0; i < uiState.nanoSlotFrequencies.size(); ++i)
+        uiState.nanoSlotFrequencies[i] = static_cast<float>(runtimeNanoRatios[i] / basePeriod);
+
+    // Slice thumbnail markers, in the order the slice was captured
+    uiState.sliceEventId = sliceEventCounter;
+    if (autoStutterActive && maxStutterLenSamples > 0)
+    {
+        int loopLen = std::clamp(static_cast<int>((secondsPerWholeNote / chosenDenominator) * getSampleRate()), 1, maxStutterLenSamples);
+        int loopPos = stutterPlayCounter % loopLen;
+        bool playingReversed = currentStutterIsReversed && firstRepeatCyclePlayed;
+
+        float cycleCrossfade = juce::jlimit(0.01f, 1.0f, parameters.getRawParameterValue("CycleCrossfade")->load() + heldCycleCrossfadeRandomOffset);
+        int crossfadeLen = std::clamp(static_cast<int>(cycleCrossfade * loopLen * CYCLE_CROSSFADE_MAX_PERCENT), 1, std::max(1, loopLen / 2));
+
+        uiState.slicePosition = static_cast<float>(playingReversed ? loopLen - 1 - loopPos : loopPos) / loopLen;
+        uiState.sliceGate = juce::jmin(1.0f, static_cast<float>(heldNanoEnvelopeLengthInSamples) / loopLen);
+        uiState.sliceCrossfade = static_cast<float>(crossfadeLen) / loopLen;
+        uiState.sliceReversed = playingReversed;
+    }
+
+    uiSnapshots.publish(uiState);
 }
 
 void NanoStuttAudioProcessor::updateWaveshaperFunction(int algorithm, float drive, bool gainCompensation)
@@ -2004,26 +2266,128 @@ bool NanoStuttAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* NanoStuttAudioProcessor::createEditor()
 {
+    editorOpenStartMs = juce::Time::getMillisecondCounterHiRes();
+    setEditorAttached(true);
     return new NanoStuttAudioProcessorEditor (*this);
 }
 
+void NanoStuttAudioProcessor::reportEditorFirstPaint(double constructedAtMs)
+{
+    double nowMs = juce::Time::getMillisecondCounterHiRes();
+    lastEditorOpenLatencyMs.store(nowMs - editorOpenStartMs);
+
+    DBG("Editor open: " + juce::String(constructedAtMs - editorOpenStartMs, 1) + " ms to construct, "
+        + juce::String(nowMs - editorOpenStartMs, 1) + " ms to first paint");
+}
+
 //==============================================================================
 void NanoStuttAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // Serialize all parameters using AudioProcessorValueTreeState's built-in serialization
+    // Compact binary state (see BinaryState.h); presets stay XML
     auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+
+    // Morph sources are session state only, so they are added here rather than kept in the APVTS tree
+    auto morphSources = morphSourcesToValueTree();
+    if (morphSources.getNumChildren() > 0)
+        state.appendChild(morphSources, nullptr);
+
+    BinaryState::write(parameterTable, state, destData);
 }
 
 void NanoStuttAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // Restore all parameters from saved state
+    if (BinaryState::isBinaryState(data, sizeInBytes))
+    {
+        BinaryState::State restored;
+        if (!BinaryState::read(data, sizeInBytes, restored))
+        {
+            DBG("Failed to read binary plugin state");
+            return;
+        }
+
+        // Parameters missing from the state (added since it was saved) fall back to their defaults
+        auto values = parameterTable.getDefaults();
+        for (int i = 0; i < restored.parameterIDs.size(); ++i)
+        {
+            int index = parameterTable.indexOf(restored.parameterIDs[i]);
+            if (index >= 0)
+                values[(size_t) index] = parameterTable.getParameter(index)->convertTo0to1(restored.values[(size_t) i]);
+        }
+
+        auto morphSources = restored.extra.getChildWithName(morphSourcesType);
+        restored.extra.removeChild(morphSources, nullptr);
+
+        applyParameterState(values, restored.extra);
+        restoreMorphSources(morphSources);  // A session without morph sources clears them
+        return;
+    }
+
+    // Sessions saved before the binary state: XML
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName(parameters.state.getType()))
         parameters.replaceState(juce::ValueTree::fromXml(*xml));
 }
 
+juce::ValueTree NanoStuttAudioProcessor::morphSourcesToValueTree() const
+{
+    // Per source: parameter IDs and denormalised values, like BinaryState, so sources
+    // saved by an older build still map after parameters were added or reordered
+    juce::ValueTree tree(morphSourcesType);
+
+    for (auto source : { PresetMorph::A, PresetMorph::B })
+    {
+        auto values = presetMorph.getSource(source);
+        if (values.empty())
+            continue;
+
+        juce::StringArray ids;
+        juce::MemoryOutputStream stream;
+        for (int i = 0; i < parameterTable.size(); ++i)
+        {
+            ids.add(parameterTable.getID(i));
+            stream.writeFloat(parameterTable.getParameter(i)->convertFrom0to1(values[(size_t) i]));
+        }
+
+        juce::ValueTree child("SOURCE");
+        child.setProperty("slot", static_cast<int>(source), nullptr);
+        child.setProperty("ids", ids.joinIntoString("\n"), nullptr);
+        child.setProperty("values", stream.getMemoryBlock(), nullptr);
+        tree.appendChild(child, nullptr);
+    }
+
+    return tree;
+}
+
+void NanoStuttAudioProcessor::restoreMorphSources(const juce::ValueTree& tree)
+{
+    for (auto source : { PresetMorph::A, PresetMorph::B })
+    {
+        auto child = tree.getChildWithProperty("slot", static_cast<int>(source));
+        auto ids = juce::StringArray::fromLines(child.getProperty("ids").toString());
+        auto* block = child.getProperty("values").getBinaryData();
+
+        if (!child.isValid() || block == nullptr || block->getSize() < (size_t) ids.size() * sizeof(float))
+        {
+            if (hasMorphSource(source))
+                clearMorphSource(source);
+            continue;
+        }
+
+        // Parameters missing from the saved source (added since) take their defaults
+        auto values = parameterTable.getDefaults();
+        juce::MemoryInputStream stream(*block, false);
+        for (const auto& id : ids)
+        {
+            float value = stream.readFloat();
+            int index = parameterTable.indexOf(id);
+            if (index >= 0)
+                values[(size_t) index] = parameterTable.getParameter(index)->convertTo0to1(value);
+        }
+
+        setMorphSource(source, values);
+    }
+}
+
 //==============================================================================
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
@@ -2201,39 +2565,125 @@ juce::AudioProcessorValueTreeState::ParameterLayout NanoStuttAudioProcessor::cre
         params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID(id, 1), id, defaultActive));
     }
 
+    // Parameters added after the original layout are appended below in the order they were added, so the
+    // host-facing indices of existing parameters never shift
+
+    // Rate selection: independent weighted draws, or Markov transitions conditioned on the previous rate
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("rateSelectionMode", 1), "Rate Selection Mode",
+        juce::StringArray { "Independent", "Markov" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("markovStrength", 1), "Markov Strength", 0.0f, 1.0f, 1.0f));
+
+    // Euclidean occurrence: k hits over n quant-unit steps, rotated
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("occurrenceMode", 1), "Occurrence Mode",
+        juce::StringArray { "Chance", "Euclidean", "Euclidean + Chance" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("euclidHits", 1), "Euclidean Hits",
+        juce::NormalisableRange<float>(0.0f, static_cast<float>(MAX_EUCLIDEAN_STEPS), 1.0f), 3.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("euclidSteps", 1), "Euclidean Steps",
+        juce::NormalisableRange<float>(1.0f, static_cast<float>(MAX_EUCLIDEAN_STEPS), 1.0f), 8.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("euclidRotation", 1), "Euclidean Rotation",
+        juce::NormalisableRange<float>(0.0f, static_cast<float>(MAX_EUCLIDEAN_STEPS - 1), 1.0f), 0.0f));
+
+    // Pattern script (source is stored in the state tree, see PatternScript.h)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID("patternScriptEnabled", 1), "Pattern Script Enabled", false));
+
+    // Cross-instance group sync (session setting, not stored in presets)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("syncGroup", 1), "Sync Group",
+        juce::StringArray { "Off", "A", "B", "C", "D", "E", "F", "G", "H" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("syncRole", 1), "Sync Role",
+        juce::StringArray { "Leader", "Follower" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID("syncFollowRates", 1), "Sync Follow Rates", true));
+
+    // Preset morph amount between sources A and B (session setting, not stored in presets)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("presetMorph", 1), "Preset Morph", 0.0f, 1.0f, 0.0f));
+
+    // Live parameter link between instances (session setting, not stored in presets)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("stateLink", 1), "State Link",
+        juce::StringArray { "Off", "A", "B", "C", "D", "E", "F", "G", "H" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID("linkExcludeMix", 1), "Link Excludes Mix", true));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID("linkExcludeTuning", 1), "Link Excludes Tuning", false));
+
     return { params.begin(), params.end() };
 }
 
-void NanoStuttAudioProcessor::updateCachedParameters()
+void NanoStuttAudioProcessor::cacheParameterPointers()
 {
+    rawParameterValues.resize((size_t) parameterTable.size());
+    for (int i = 0; i < parameterTable.size(); ++i)
+        rawParameterValues[(size_t) i] = parameters.getRawParameterValue(parameterTable.getID(i));
+    quietlyWritten = std::make_unique<std::atomic<bool>[]>((size_t) parameterTable.size());
+
     static const std::array<std::string, 13> regularLabels = { "1", "1/2d", "1/2", "1/4d", "1/3", "1/4", "1/8d", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32" };
     static const std::array<std::string, 9> quantLabels = { "4", "2", "1", "1/2", "1/4", "1/8d", "1/8", "1/16", "1/32" };
 
-    // Update regular rate weights, respecting active state
     for (size_t i = 0; i < regularLabels.size(); ++i)
     {
-        float weight = parameters.getRawParameterValue("rateProb_" + regularLabels[i])->load();
-        bool isActive = parameters.getRawParameterValue("rateActive_" + regularLabels[i])->load() > 0.5f;
-        regularRateWeights[i] = isActive ? weight : 0.0f;
+        regularWeightSources[i].weight = parameters.getRawParameterValue("rateProb_" + regularLabels[i]);
+        regularWeightSources[i].active = parameters.getRawParameterValue("rateActive_" + regularLabels[i]);
     }
 
-    // Update nano rate weights, respecting active state
     for (int i = 0; i < 12; ++i)
     {
-        float weight = parameters.getRawParameterValue("nanoProb_" + std::to_string(i))->load();
-        bool isActive = parameters.getRawParameterValue("nanoActive_" + std::to_string(i))->load() > 0.5f;
-        nanoRateWeights[i] = isActive ? weight : 0.0f;
+        nanoWeightSources[(size_t) i].weight = parameters.getRawParameterValue("nanoProb_" + std::to_string(i));
+        nanoWeightSources[(size_t) i].active = parameters.getRawParameterValue("nanoActive_" + std::to_string(i));
+        nanoRatioSources[(size_t) i] = parameters.getRawParameterValue("nanoRatio_" + std::to_string(i));
     }
 
-    // Update quantization weights, respecting active state
     for (size_t i = 0; i < quantLabels.size(); ++i)
     {
-        float weight = parameters.getRawParameterValue("quantProb_" + quantLabels[i])->load();
-        bool isActive = parameters.getRawParameterValue("quantActive_" + quantLabels[i])->load() > 0.5f;
-        quantUnitWeights[i] = isActive ? weight : 0.0f;
+        quantWeightSources[i].weight = parameters.getRawParameterValue("quantProb_" + quantLabels[i]);
+        quantWeightSources[i].active = parameters.getRawParameterValue("quantActive_" + quantLabels[i]);
     }
 
-    nanoBlend = parameters.getRawParameterValue("nanoBlend")->load();
+    nanoBlendParam = parameters.getRawParameterValue("nanoBlend");
+    occurrenceModeParam = parameters.getRawParameterValue("occurrenceMode");
+    euclidStepsParam = parameters.getRawParameterValue("euclidSteps");
+    euclidHitsParam = parameters.getRawParameterValue("euclidHits");
+    euclidRotationParam = parameters.getRawParameterValue("euclidRotation");
+    markovStrengthParam = parameters.getRawParameterValue("markovStrength");
+}
+
+void NanoStuttAudioProcessor::updateCachedParameters()
+{
+    // Update regular rate weights, respecting active state
+    for (size_t i = 0; i < regularWeightSources.size(); ++i)
+    {
+        bool isActive = regularWeightSources[i].active->load() > 0.5f;
+        regularRateWeights[i] = isActive ? regularWeightSources[i].weight->load() : 0.0f;
+    }
+
+    // Update nano rate weights, respecting active state
+    for (size_t i = 0; i < nanoWeightSources.size(); ++i)
+    {
+        bool isActive = nanoWeightSources[i].active->load() > 0.5f;
+        nanoRateWeights[i] = isActive ? nanoWeightSources[i].weight->load() : 0.0f;
+    }
+
+    // Update quantization weights, respecting active state
+    for (size_t i = 0; i < quantWeightSources.size(); ++i)
+    {
+        bool isActive = quantWeightSources[i].active->load() > 0.5f;
+        quantUnitWeights[i] = isActive ? quantWeightSources[i].weight->load() : 0.0f;
+    }
+
+    nanoBlend = nanoBlendParam->load();
+
+    // Precompute the Euclidean hit mask so the scheduler only does a bit test
+    occurrenceMode = static_cast<OccurrenceMode>(static_cast<int>(occurrenceModeParam->load()));
+    euclideanSteps = juce::jlimit(1, MAX_EUCLIDEAN_STEPS, static_cast<int>(euclidStepsParam->load()));
+    euclideanMask = computeEuclideanMask(static_cast<int>(euclidHitsParam->load()),
+                                         euclideanSteps,
+                                         static_cast<int>(euclidRotationParam->load()));
+
+    // Recompile transition alias tables against the new weights
+    rateMarkovChain.compile(regularRateWeights, nanoRateWeights, nanoBlend, markovStrengthParam->load());
 }
 
 void NanoStuttAudioProcessor::updateNanoRatiosFromTuning()
@@ -2265,15 +2715,7 @@ void NanoStuttAudioProcessor::updateNanoRatiosFromTuning()
     // Re-enable custom detection
     suppressCustomDetection = false;
 
-    // Notify editor to update UI after all parameters have been updated
-    // Only queue callback if one isn't already pending (debouncing)
-    if (!pendingUIUpdate.exchange(true)) {
-        juce::MessageManager::callAsync([this]() {
-            pendingUIUpdate = false;
-            if (auto* editor = dynamic_cast<NanoStuttAudioProcessorEditor*>(getActiveEditor()))
-                editor->refreshComboBoxesAndRatios();
-        });
-    }
+    scheduleEditorRatioRefresh();
 }
 
 void NanoStuttAudioProcessor::updateNanoVisibilityFromScale()
@@ -2302,15 +2744,7 @@ void NanoStuttAudioProcessor::updateNanoVisibilityFromScale()
     // Re-enable custom detection
     suppressCustomDetection = false;
 
-    // Notify editor to update UI after all parameters have been updated
-    // Only queue callback if one isn't already pending (debouncing)
-    if (!pendingUIUpdate.exchange(true)) {
-        juce::MessageManager::callAsync([this]() {
-            pendingUIUpdate = false;
-            if (auto* editor = dynamic_cast<NanoStuttAudioProcessorEditor*>(getActiveEditor()))
-                editor->refreshComboBoxesAndRatios();
-        });
-    }
+    scheduleEditorRatioRefresh();
 }
 
 void NanoStuttAudioProcessor::detectCustomTuning()
@@ -2415,6 +2849,11 @@ void NanoStuttAudioProcessor::initializeParameterListeners()
         parameters.addParameterListener("quantActive_" + label, this);
 
     parameters.addParameterListener("nanoBlend", this);
+    parameters.addParameterListener("markovStrength", this);
+    parameters.addParameterListener("occurrenceMode", this);
+    parameters.addParameterListener("euclidHits", this);
+    parameters.addParameterListener("euclidSteps", this);
+    parameters.addParameterListener("euclidRotation", this);
     parameters.addParameterListener("TimingOffset", this);
     parameters.addParameterListener("WaveshapeAlgorithm", this);
     parameters.addParameterListener("Drive", this);
@@ -2430,7 +2869,8 @@ void NanoStuttAudioProcessor::initializeParameterListeners()
 
 void NanoStuttAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
 {
-    updateCachedParameters();
+    // The audio thread rebuilds the cached tables before its next use of them (once per batch, too)
+    cachedParametersStale.store(true);
 
     // Mark preset as modified (unless it's autoStutterEnabled which isn't saved in presets)
     if (parameterID != "autoStutterEnabled")
@@ -2440,15 +2880,17 @@ void NanoStuttAudioProcessor::parameterChanged(const juce::String& parameterID,
     if (parameterID == "nanoBase")
     {
         currentNanoBase = static_cast<NanoTuning::NanoBase>(static_cast<int>(newValue));
-        updateNanoRatiosFromTuning();
+        if (!isApplyingParameterBatch())
+            updateNanoRatiosFromTuning();
     }
     // Handle tuning system changes
     else if (parameterID == "tuningSystem")
     {
         int tuningIndex = static_cast<int>(newValue);
         currentTuningSystem = static_cast<NanoTuning::TuningSystem>(tuningIndex);
-        // Only update ratios if not in a custom mode
-        if (tuningIndex != static_cast<int>(NanoTuning::TuningSystem::CustomFraction) &&
+        // Only update ratios if not in a custom mode (a batch writes the ratios itself)
+        if (!isApplyingParameterBatch() &&
+            tuningIndex != static_cast<int>(NanoTuning::TuningSystem::CustomFraction) &&
             tuningIndex != static_cast<int>(NanoTuning::TuningSystem::CustomDecimal))
         {
             updateNanoRatiosFromTuning();
@@ -2459,7 +2901,7 @@ void NanoStuttAudioProcessor::parameterChanged(const juce::String& parameterID,
     {
         int scaleIndex = static_cast<int>(newValue);
         currentScale = static_cast<NanoTuning::Scale>(scaleIndex);
-        if (scaleIndex != static_cast<int>(NanoTuning::Scale::Custom))
+        if (!isApplyingParameterBatch() && scaleIndex != static_cast<int>(NanoTuning::Scale::Custom))
         {
             updateNanoVisibilityFromScale();
         }
@@ -2467,14 +2909,12 @@ void NanoStuttAudioProcessor::parameterChanged(const juce::String& parameterID,
     // Detect custom tuning when ratio parameters change
     else if (parameterID.startsWith("nanoRatio_"))
     {
-        // ALWAYS update runtime ratios array (needed for audio thread)
-        for (int i = 0; i < 12; ++i)
-        {
-            runtimeNanoRatios[i] = parameters.getRawParameterValue("nanoRatio_" + juce::String(i))->load();
-        }
+        // ALWAYS update runtime ratios array (needed for audio thread; a batch does it once at its end)
+        if (!isApplyingParameterBatch())
+            updateRuntimeNanoRatios();
 
-        // ONLY skip detection if suppressed (during programmatic updates like variant selection)
-        if (!suppressCustomDetection)
+        // ONLY skip detection if suppressed (during programmatic updates like variant selection, or batches)
+        if (!suppressCustomDetection && !isApplyingParameterBatch())
         {
             detectCustomTuning();  // Only check tuning, not scale
         }
@@ -2482,7 +2922,189 @@ void NanoStuttAudioProcessor::parameterChanged(const juce::String& parameterID,
     // Detect custom scale when active state parameters change
     else if (parameterID.startsWith("nanoActive_"))
     {
-        detectCustomScale();  // Only check scale, not tuning
+        if (!isApplyingParameterBatch())
+            detectCustomScale();  // Only check scale, not tuning
+    }
+}
+
+void NanoStuttAudioProcessor::applyPresetMorph(float amount)
+{
+    // Written quietly: a performance macro must not record automation for every morphed parameter
+    bool wrote;
+    {
+        const juce::ScopedValueSetter<const NanoStuttAudioProcessor*> batch(threadParameterBatch, this);
+        wrote = presetMorph.process(amount, [this](int index, float value) { writeParameterQuietly(index, value); });
+    }
+
+    if (wrote)
+        finishParameterBatch();
+}
+
+void NanoStuttAudioProcessor::applyStateSlotRecall()
+{
+    // Same quiet write path as the morph (a recall is not automation): one diff pass over the slot,
+    // derived tables rebuilt once by the caller
+    bool wrote;
+    {
+        const juce::ScopedValueSetter<const NanoStuttAudioProcessor*> batch(threadParameterBatch, this);
+        wrote = stateSlots.processRecall([this](int index, float value) { writeParameterQuietly(index, value); });
+    }
+
+    if (wrote)
+    {
+        finishParameterBatch();
+        ++stateSlotRecallCounter;
+    }
+}
+
+void NanoStuttAudioProcessor::applyLinkedState()
+{
+    int channel = static_cast<int>(stateLinkChannel->load());
+    int exclusions = (linkExcludeMix->load() > 0.5f ? LinkedStateMember::ExcludeMix : 0)
+                   | (linkExcludeTuning->load() > 0.5f ? LinkedStateMember::ExcludeTuning : 0);
+
+    // Written quietly like the morph: no AudioProcessorListener (so not the host) hears of a linked
+    // edit, so mirroring it costs no automation traffic and records nothing on the follower's track
+    bool wrote;
+    bool tuningChanged = false;
+    {
+        const juce::ScopedValueSetter<const NanoStuttAudioProcessor*> batch(threadParameterBatch, this);
+        wrote = linkMember.process(*linkRegistry, channel, exclusions, [this, &tuningChanged](int index, float value)
+        {
+            writeParameterQuietly(index, value);
+            tuningChanged = tuningChanged || linkMember.isTuningParameter(index);
+        });
+    }
+
+    if (wrote)
+    {
+        finishParameterBatch();
+        if (tuningChanged)
+            ++linkedTuningUpdateCounter;
+    }
+}
+
+void NanoStuttAudioProcessor::applyParameterValues(const std::vector<float>& normalisedValues)
+{
+    jassert((int) normalisedValues.size() == parameterTable.size());
+
+    // Only parameters whose value differs are set (and notify their listeners)
+    {
+        const juce::ScopedValueSetter<const NanoStuttAudioProcessor*> batch(threadParameterBatch, this);
+        for (int i = 0; i < parameterTable.size(); ++i)
+        {
+            auto* parameter = parameterTable.getParameter(i);
+            if (parameter->getValue() != normalisedValues[(size_t) i])
+                parameter->setValueNotifyingHost(normalisedValues[(size_t) i]);
+        }
+    }
+
+    finishParameterBatch();
+    scheduleEditorRatioRefresh();
+}
+
+void NanoStuttAudioProcessor::applyParameterState(const std::vector<float>& normalisedValues, const juce::ValueTree& nonParameterChildren)
+{
+    // Non-parameter children (rate matrix, pattern script) are replaced as a whole, like
+    // replaceState would, but only reloaded if they differ (recompiling a script is not free)
+    bool childrenChanged = false;
+    int numCurrentChildren = 0;
+    for (const auto& child : parameters.state)
+    {
+        if (child.hasType(BinaryState::parameterType))
+            continue;
+        ++numCurrentChildren;
+        auto replacement = nonParameterChildren.getChildWithName(child.getType());
+        if (!replacement.isValid() || !replacement.isEquivalentTo(child))
+            childrenChanged = true;
+    }
+    if (numCurrentChildren != nonParameterChildren.getNumChildren())
+        childrenChanged = true;
+
+    if (childrenChanged)
+    {
+        for (int i = parameters.state.getNumChildren(); --i >= 0;)
+        {
+            if (!parameters.state.getChild(i).hasType(BinaryState::parameterType))
+                parameters.state.removeChild(i, nullptr);
+        }
+        for (const auto& child : nonParameterChildren)
+            parameters.state.appendChild(child.createCopy(), nullptr);
+
+        restoreNonParameterState(parameters.state);
+    }
+
+    applyParameterValues(normalisedValues);
+}
+
+bool NanoStuttAudioProcessor::isApplyingParameterBatch() const
+{
+    return threadParameterBatch == this;
+}
+
+// Catches up on what parameterChanged deferred during a batch (any thread, allocation free)
+void NanoStuttAudioProcessor::finishParameterBatch()
+{
+    cachedParametersStale.store(true);
+    updateRuntimeNanoRatios();
+}
+
+void NanoStuttAudioProcessor::writeParameterQuietly(int index, float normalisedValue)
+{
+    // setValue alone reaches neither the parameter's listeners (APVTS, attachments) nor the processor's
+    // (the plugin wrapper, i.e. the host); the raw value and parameterChanged are brought along here,
+    // the controls and the state tree by takeQuietParameterWrites on the message thread
+    auto* parameter = parameterTable.getParameter(index);
+    parameter->setValue(normalisedValue);
+
+    float value = parameter->convertFrom0to1(normalisedValue);
+    rawParameterValues[(size_t) index]->store(value);
+    quietlyWritten[(size_t) index].store(true, std::memory_order_release);
+    quietWriteCounter.fetch_add(1, std::memory_order_release);
+
+    parameterChanged(parameter->getParameterID(), value);
+}
+
+void NanoStuttAudioProcessor::takeQuietParameterWrites(const std::function<void(int)>& changed)
+{
+    static const juce::Identifier idProperty("id"), valueProperty("value");
+
+    for (int i = 0; i < parameterTable.size(); ++i)
+    {
+        if (!quietlyWritten[(size_t) i].exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        // The APVTS sees the value it already holds, so nothing is sent on to the host
+        auto* parameter = parameterTable.getParameter(i);
+        auto child = parameters.state.getChildWithProperty(idProperty, parameter->getParameterID());
+        if (child.isValid())
+            child.setProperty(valueProperty, parameter->convertFrom0to1(parameter->getValue()), nullptr);
+
+        if (changed != nullptr)
+            changed(i);
+    }
+}
+
+void NanoStuttAudioProcessor::updateRuntimeNanoRatios()
+{
+    for (size_t i = 0; i < nanoRatioSources.size(); ++i)
+        runtimeNanoRatios[i] = nanoRatioSources[i]->load();
+}
+
+void NanoStuttAudioProcessor::scheduleEditorRatioRefresh()
+{
+    // Nothing to refresh without an editor (this also keeps offline preview engines from queueing callbacks)
+    if (getActiveEditor() == nullptr)
+        return;
+
+    // Notify editor to update UI after all parameters have been updated
+    // Only queue callback if one isn't already pending (debouncing)
+    if (!pendingUIUpdate.exchange(true)) {
+        juce::MessageManager::callAsync([this]() {
+            pendingUIUpdate = false;
+            if (auto* editor = dynamic_cast<NanoStuttAudioProcessorEditor*>(getActiveEditor()))
+                editor->refreshComboBoxesAndRatios();
+        });
     }
 }
 
@@ -2503,8 +3125,133 @@ void NanoStuttAudioProcessor::resizeOutputBufferForBpm(double bpm, double sample
         outputBufferMaxSamples = newBufferSize;
         outputBuffer.setSize(getTotalNumOutputChannels(), outputBufferMaxSamples, false, true, true);
         stutterStateBuffer.resize(outputBufferMaxSamples, 0);
-        outputBufferWritePos.store(0);
+        outputBufferWritePos = 0;
         lastOutputWriteIndex = -1;  // Reset for new buffer
         lastKnownBpm = bpm;
     }
 }
+
+int NanoStuttAudioProcessor::drawRateSlot(bool useMarkov, const std::array<float, 13>& regularWeights,
+                                          const std::array<float, 12>& nanoWeights, float blend)
+{
+    // Markov mode draws system and rate together, conditioned on the previous event
+    if (useMarkov) {
+        int slot = rateMarkovChain.sampleNext(lastMarkovSlot, juce::Random::getSystemRandom());
+        if (slot != RateMarkovChain::NO_PREVIOUS_SLOT)
+            return slot;
+    }
+
+    bool useNano = juce::Random::getSystemRandom().nextFloat() < blend;
+    int index = useNano ? selectWeightedIndex(nanoWeights, 0) : selectWeightedIndex(regularWeights, 0);
+    return RateMarkovChain::toSlot(useNano, index);
+}
+
+bool NanoStuttAudioProcessor::isRateSlotActive(int slot) const
+{
+    const auto* sources = RateMarkovChain::isNanoSlot(slot) ? nanoWeightSources.data() : regularWeightSources.data();
+    return sources[RateMarkovChain::toSystemIndex(slot)].active->load() > 0.5f;
+}
+
+bool NanoStuttAudioProcessor::applyGroupDecision(int group, bool followRate, bool autoStutter)
+{
+    StutterGroupRegistry::Decision decision;
+    if (!groupRegistry->fetch(group, pendingGroupUnitStart, groupTransportPosition, decision))
+        return false;
+
+    groupDecisionPending = false;
+    stutterIsScheduled = autoStutter && decision.fire;
+    nextQuantIndex = juce::jlimit(0, 8, decision.quantIndex);
+    pendingRateSlot = followRate ? decision.rateSlot : -1;
+    pendingReverse = decision.reverse;
+    pendingGateScale = decision.gate;
+
+    if (stutterIsScheduled)
+        announceUpcomingEvent(pendingGroupUnitStart);
+    return true;
+}
+
+void NanoStuttAudioProcessor::announceUpcomingEvent(int unitStart)
+{
+    // Preview only matters to an open editor
+    if (!editorAttached.load(std::memory_order_relaxed))
+        return;
+
+    // Mirrors the event length calculation at the event start (unit may be shortened to realign)
+    int unitLength = QUANT_UNIT_THIRTY_SECONDS[(size_t) nextQuantIndex];
+    int remainingThirtySeconds = unitLength - ((unitStart % unitLength) + unitLength) % unitLength;
+    float gate = pendingGateScale >= 0.0f ? pendingGateScale : 1.0f;
+
+    UpcomingEvent event;
+    event.startPpq = unitStart * THIRTY_SECOND_NOTE_PPQ;
+    event.lengthPpq = remainingThirtySeconds * THIRTY_SECOND_NOTE_PPQ * juce::jlimit(0.125f, 1.0f, gate);
+    event.rateSlot = pendingRateSlot;
+    event.reversed = pendingReverse > 0;
+    event.quantIndex = nextQuantIndex;
+    upcomingEvents.push(event);
+}
+
+//==============================================================================
+bool NanoStuttAudioProcessor::learnRateTransitionsFromMidiFile(const juce::File& file)
+{
+    if (!rateMarkovChain.learnFromMidiFile(file, regularDenominators))
+        return false;
+
+    storeRateTransitionsInState();
+    cachedParametersStale.store(true);
+    presetManager.setModified(true);
+    return true;
+}
+
+void NanoStuttAudioProcessor::resetRateTransitions()
+{
+    rateMarkovChain.resetToUniform();
+    storeRateTransitionsInState();
+    cachedParametersStale.store(true);
+    presetManager.setModified(true);
+}
+
+void NanoStuttAudioProcessor::storeRateTransitionsInState()
+{
+    // Keep the matrix inside the APVTS state so getStateInformation and presets carry it
+    auto existing = parameters.state.getChildWithName(RateMarkovChain::stateType);
+    if (existing.isValid())
+        parameters.state.removeChild(existing, nullptr);
+    parameters.state.appendChild(rateMarkovChain.toValueTree(), nullptr);
+}
+
+juce::Result NanoStuttAudioProcessor::setPatternScriptSource(const juce::String& source)
+{
+    // A failing edit keeps the running program, so the state keeps its source too
+    auto result = patternScript.setSource(source);
+    if (result.wasOk())
+    {
+        storePatternScriptInState();
+        presetManager.setModified(true);
+    }
+    return result;
+}
+
+void NanoStuttAudioProcessor::storePatternScriptInState()
+{
+    auto existing = parameters.state.getChildWithName(PatternScript::Engine::stateType);
+    if (existing.isValid())
+        parameters.state.removeChild(existing, nullptr);
+    parameters.state.appendChild(patternScript.toValueTree(), nullptr);
+}
+
+void NanoStuttAudioProcessor::valueTreeRedirected(juce::ValueTree& treeWhichHasBeenChanged)
+{
+    restoreNonParameterState(treeWhichHasBeenChanged);
+    cachedParametersStale.store(true);
+}
+
+void NanoStuttAudioProcessor::restoreNonParameterState(const juce::ValueTree& state)
+{
+    // Older sessions and presets have no matrix child and fall back to neutral transitions
+    rateMarkovChain.fromValueTree(state.getChildWithName(RateMarkovChain::stateType));
+
+    // Scripts that fail to compile keep their source but are disabled (built-in decisions apply)
+    auto scriptResult = patternScript.fromValueTree(state.getChildWithName(PatternScript::Engine::stateType));
+    if (scriptResult.failed())
+        DBG("[PATTERN SCRIPT] Restored script failed to compile: " << scriptResult.getErrorMessage());
+}
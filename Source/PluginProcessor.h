@@ -12,12 +12,25 @@
 #include <juce_dsp/juce_dsp.h>
 #include "TuningSystem.h"
 #include "PresetManager.h"
+#include "RateMarkovChain.h"
+#include "PatternScript.h"
+#include "StutterGroupSync.h"
+#include "UpcomingEventQueue.h"
+#include "UiSnapshot.h"
+#include "SampleFifo.h"
+#include "SliceSummary.h"
+#include "PresetMorph.h"
+#include "StateSlots.h"
+#include "LinkedState.h"
+#include "PresetPreviewAudio.h"
+#include "BackgroundTextureCache.h"
 
 //==============================================================================
 /**
 */
 class NanoStuttAudioProcessor  : public juce::AudioProcessor,
-                                 public juce::AudioProcessorValueTreeState::Listener
+                                 public juce::AudioProcessorValueTreeState::Listener,
+                                 private juce::ValueTree::Listener
 
 {
 public:
@@ -65,26 +78,84 @@ public:
     // Output visualization accessors
     const juce::AudioBuffer<float>& getOutputBuffer() const { return outputBuffer; }
     const std::vector<int>& getStutterStateBuffer() const { return stutterStateBuffer; }
-    int getOutputBufferWritePos() const { return outputBufferWritePos.load(); }
-    int getOutputBufferSize() const { return outputBufferMaxSamples; }
 
     void setManualStutterRate(int rate) { manualStutterRateDenominator = rate; }
     void setManualStutterTriggered(bool triggered) { manualStutterTriggered = triggered; }
     void setAutoStutterActive(bool active) { autoStutterActive = active; }
 
-    bool isUsingNanoRate() const { return currentlyUsingNanoRate.load(); }
-    float getNanoFrequency() const { return currentNanoFrequency.load(); }
-    int getCurrentPlayingNanoRateIndex() const { return currentPlayingNanoRateIndex.load(); }
-    int getCurrentPlayingRegularRateIndex() const { return currentPlayingRegularRateIndex.load(); }
-    int getCurrentQuantIndex() const { return currentQuantIndex; }
-    bool isAutoStutterActive() const { return autoStutterActive; }
+    // Audio-to-UI state of the last processed block (message thread only, see UiSnapshot.h)
+    const UiSnapshot& getUiSnapshot() { return uiSnapshots.read(); }
 
     // Preset management accessor
     PresetManager& getPresetManager() { return presetManager; }
 
+    // Flat parameter view (message thread), see ParameterTable.h
+    const ParameterTable& getParameterTable() const { return parameterTable; }
+
+    // Preset morph sources (message thread); the "presetMorph" parameter moves between them
+    void setMorphSource(PresetMorph::Source source, const std::vector<float>& normalisedValues) { presetMorph.setSource(source, normalisedValues); }
+    void clearMorphSource(PresetMorph::Source source) { presetMorph.clearSource(source); }
+    bool hasMorphSource(PresetMorph::Source source) const { return presetMorph.hasSource(source); }
+
+    // Morph sources travel with the session (EXTRA tree), never with presets
+    static inline const juce::Identifier morphSourcesType { "MORPH_SOURCES" };
+    juce::ValueTree morphSourcesToValueTree() const;
+    void restoreMorphSources(const juce::ValueTree& tree);
+
+    // A/B/C/D state slots (message thread); a recall lands at the next event boundary, see StateSlots.h
+    void storeStateSlot(int slot) { stateSlots.store(slot, parameterTable.capture()); }
+    void recallStateSlot(int slot) { stateSlots.requestRecall(slot); }
+    void clearStateSlot(int slot) { stateSlots.clear(slot); }
+    bool hasStateSlot(int slot) const { return stateSlots.hasSlot(slot); }
+    int getActiveStateSlot() const { return stateSlots.getActiveSlot(); }
+
+    // Applies a full parameter set (table order) in one batch; used by the offline preview engine
+    void applyParameterValues(const std::vector<float>& normalisedValues);
+
+    /**
+        Message thread: calls changed(parameterIndex) for every parameter written
+        quietly (morph, slot recall, linked state) since the last call, and brings
+        those values into the state tree. Controls refresh themselves from here,
+        since their attachments never hear of quiet writes.
+    */
+    void takeQuietParameterWrites(const std::function<void(int)>& changed);
+    juce::uint32 getQuietWriteCounter() const { return quietWriteCounter.load(std::memory_order_acquire); }
+
+    // Preset previews (message thread), see PresetPreview.h
+    bool copyPreviewInput(juce::AudioBuffer<float>& dest) { return previewInput.copyTo(dest); }
+    void startPresetPreview(const juce::AudioBuffer<float>& preview) { previewPlayer.play(preview); }
+    void stopPresetPreview() { previewPlayer.stop(); }
+
     // Custom tuning detection control (for programmatic updates)
     void setSuppressCustomDetection(bool suppress) { suppressCustomDetection = suppress; }
 
+    // Markov rate transitions (message thread)
+    RateMarkovChain& getRateMarkovChain() { return rateMarkovChain; }
+    bool learnRateTransitionsFromMidiFile(const juce::File& file);
+    void resetRateTransitions();
+
+    // Pattern script (message thread); a failed compile keeps the previous program running
+    juce::Result setPatternScriptSource(const juce::String& source);
+    const juce::String& getPatternScriptSource() const { return patternScript.getSource(); }
+
+    // Upcoming-event preview: events are decided one quant unit ahead and queued for the editor
+    UpcomingEventQueue& getUpcomingEventQueue() { return upcomingEvents; }
+
+    // Spectrum analyzer feed: output samples are pushed only while the analyzer is active
+    SampleFifo& getAnalyzerFifo() { return analyzerFifo; }
+    void setAnalyzerActive(bool active) { analyzerActive.store(active); }
+
+    // Slice thumbnail: summaries of the looped slice are built only while the thumbnail is active
+    SliceSummaryQueue& getSliceSummaryQueue() { return sliceSummaries; }
+    void setSliceThumbnailActive(bool active) { sliceThumbnailActive.store(active); }
+
+    // Set by createEditor() and cleared by the editor's destructor; gates UI telemetry in processBlock
+    void setEditorAttached(bool attached) { editorAttached.store(attached); }
+
+    // Editor open latency, measured from createEditor() to the editor's first paint (message thread)
+    void reportEditorFirstPaint(double constructedAtMs);
+    double getLastEditorOpenLatencyMs() const { return lastEditorOpenLatencyMs.load(); }
+
 private:
     // ==== Timing Constants ====
     static constexpr double NANO_FADE_OUT_MS = 0.5;
@@ -94,6 +165,9 @@ private:
     static constexpr double THIRTY_SECOND_NOTE_PPQ = 0.125;
     static constexpr double QUARTER_NOTE_PPQ = 1.0;
 
+    // Quant unit lengths in 1/32 notes (4bar, 2bar, 1bar, 1/2, 1/4, d1/8, 1/8, 1/16, 1/32)
+    static constexpr std::array<int, 9> QUANT_UNIT_THIRTY_SECONDS {{ 128, 64, 32, 16, 8, 6, 4, 2, 1 }};
+
     // Musical Constants
     static constexpr double SECONDS_PER_MINUTE = 60.0;
     static constexpr double WHOLE_NOTE_QUARTERS = 4.0;
@@ -146,11 +220,62 @@ private:
     juce::AudioBuffer<float> stutterBuffer;
     juce::AudioProcessorValueTreeState parameters;
     PresetManager presetManager;
+    ParameterTable parameterTable;
+
+    // ==== Preset morph ====
+    PresetMorph presetMorph;
+    std::atomic<float>* presetMorphAmount = nullptr;
+    void applyPresetMorph(float amount);
+
+    // ==== Editor background textures ====
+    // Editors hold the same shared cache; holding it here too keeps the textures across an editor
+    // being closed and reopened (the last editor closing would otherwise destroy them)
+    juce::SharedResourcePointer<BackgroundTextureCache> backgroundTextures;
+
+    // ==== Preset previews ====
+    PreviewInputHistory previewInput;       // Filled while an editor is open
+    PreviewPlayer previewPlayer;
+
+    // ==== State slots ====
+    StateSlots stateSlots;
+    juce::uint32 stateSlotRecallCounter = 0;   // Published so the editor refreshes ratio displays once per recall
+    void applyStateSlotRecall();
+
+    // ==== Linked state (see LinkedState.h) ====
+    juce::SharedResourcePointer<LinkedStateRegistry> linkRegistry;
+    LinkedStateMember linkMember;
+    std::atomic<float>* stateLinkChannel = nullptr;
+    std::atomic<float>* linkExcludeMix = nullptr;
+    std::atomic<float>* linkExcludeTuning = nullptr;
+    juce::uint32 linkedTuningUpdateCounter = 0;  // Published so the editor refreshes ratio displays when a link changed them
+    void applyLinkedState();
+
+    // ==== Batched parameter application (morph, slots, linked state, state restore) ====
+    // While a batch runs, parameterChanged calls on its thread defer the cached tables and skip
+    // tuning/scale side effects: a whole parameter set carries its own ratios and active flags
+    bool isApplyingParameterBatch() const;
+
+    // Audio thread: sets a parameter without notifying its listeners, so the host is not told (no
+    // automation is recorded) and no listener lock is taken; see takeQuietParameterWrites
+    void writeParameterQuietly(int index, float normalisedValue);
+    std::vector<std::atomic<float>*> rawParameterValues;        // APVTS raw values, in table order
+    std::unique_ptr<std::atomic<bool>[]> quietlyWritten;        // Per table index, until taken
+    std::atomic<juce::uint32> quietWriteCounter { 0 };
+
+    // The derived tables (rate/quant weights, Euclidean mask, Markov tables) belong to the audio thread:
+    // other threads only mark them stale and processBlock rebuilds them before use
+    std::atomic<bool> cachedParametersStale { false };
+    void refreshCachedParameters() { if (cachedParametersStale.exchange(false)) updateCachedParameters(); }
+
+    void applyParameterState(const std::vector<float>& normalisedValues, const juce::ValueTree& nonParameterChildren);
+    void finishParameterBatch();
+    void updateRuntimeNanoRatios();
+    void scheduleEditorRatioRefresh();
 
     // ==== Output visualization buffers ====
     juce::AudioBuffer<float> outputBuffer;              // Ring buffer for output visualization (sized to 1/4 note)
     std::vector<int> stutterStateBuffer;                // Stutter state per sample (0=none, 1=repeat, 2=nano)
-    std::atomic<int> outputBufferWritePos {0};          // Current write position in output buffer
+    int outputBufferWritePos = 0;                       // Current write position in output buffer
     int outputBufferMaxSamples = 0;                     // Current size of output buffer (1/4 note at current BPM)
     double lastKnownBpm = 120.0;                        // Track BPM for dynamic buffer resizing
     int lastOutputWriteIndex = -1;                      // Track last write position for gap filling
@@ -195,6 +320,65 @@ private:
     std::array<float, 9> quantUnitWeights {{ 0.0f }};
     float nanoBlend = 0.0f;
 
+    // Occurrence mode: how the scheduler decides whether the next grid position fires
+    enum class OccurrenceMode {
+        Chance = 0,             // Per-grid Bernoulli trial with autoStutterChance
+        Euclidean = 1,          // Fire only on Euclidean pattern hits
+        EuclideanChance = 2     // Euclidean hits, each gated by autoStutterChance
+    };
+    static constexpr int MAX_EUCLIDEAN_STEPS = 32;
+    OccurrenceMode occurrenceMode = OccurrenceMode::Chance;
+    juce::uint32 euclideanMask = 0;   // Bit i set = step i fires (precomputed in updateCachedParameters)
+    int euclideanSteps = 8;
+
+    // Decisions made ahead for the scheduled event by the pattern script or the sync group
+    // leader (-1 = not overridden, the built-in decision is made at event start)
+    PatternScript::Engine patternScript;
+    PatternScript::Registers scriptRegisters {};
+    int pendingRateSlot = -1;
+    int pendingReverse = -1;
+    float pendingGateScale = -1.0f;
+
+    // Cross-instance group sync (see StutterGroupSync.h)
+    enum class SyncRole {
+        Leader = 0,             // Decides and publishes to the group
+        Follower = 1            // Applies the leader's decisions instead of its own
+    };
+    juce::SharedResourcePointer<StutterGroupRegistry> groupRegistry;
+    bool groupDecisionPending = false;      // Follower: waiting for the leader's decision
+    int pendingGroupUnitStart = 0;          // Follower: unit start (1/32 notes) being waited for
+    int groupTransportPosition = 0;         // Host position (1/32 notes) at the start of this block
+
+    // Upcoming-event preview for the editor
+    UpcomingEventQueue upcomingEvents;
+
+    // Audio-to-UI snapshot: uiState is filled during the block, published at its end
+    UiSnapshot uiState;
+    UiSnapshotBuffer uiSnapshots;
+    void publishUiSnapshot();
+
+    // Spectrum analyzer feed
+    SampleFifo analyzerFifo;
+    std::atomic<bool> analyzerActive {false};
+
+    // Slice thumbnail feed
+    SliceSummaryBuilder sliceBuilder;
+    SliceSummaryQueue sliceSummaries;
+    std::atomic<bool> sliceThumbnailActive {false};
+    juce::uint32 sliceEventCounter = 0;
+
+    // Period of the nano base frequency in seconds (nanoTune, nano base and octave applied)
+    double getNanoBasePeriod(double bpm, double octave) const;
+
+    // Editor attachment and open latency
+    std::atomic<bool> editorAttached {false};
+    double editorOpenStartMs = 0.0;
+    std::atomic<double> lastEditorOpenLatencyMs {0.0};
+
+    // Markov-chain rate selection (slot of the last played rate, see RateMarkovChain)
+    RateMarkovChain rateMarkovChain;
+    int lastMarkovSlot = RateMarkovChain::NO_PREVIOUS_SLOT;
+
     // Sample-and-hold envelope parameters (sampled to keep event-locked behavior)
     // Current event parameters - used throughout the active stutter event
     float currentMacroGateParam = 1.0f;
@@ -263,10 +447,10 @@ private:
     std::atomic<float>* timingOffsetParam = nullptr;
 
     // Nano rate tracking for tuner display and UI state
-    std::atomic<bool> currentlyUsingNanoRate {false};
-    std::atomic<float> currentNanoFrequency {0.0f};
-    std::atomic<int> currentPlayingNanoRateIndex {-1};  // -1 = not playing, 0-11 = active nano rate index
-    std::atomic<int> currentPlayingRegularRateIndex {-1};  // -1 = not playing, 0-12 = active regular rate index
+    bool currentlyUsingNanoRate = false;
+    float currentNanoFrequency = 0.0f;
+    int currentPlayingNanoRateIndex = -1;  // -1 = not playing, 0-11 = active nano rate index
+    int currentPlayingRegularRateIndex = -1;  // -1 = not playing, 0-12 = active regular rate index
 
     // Smoothed envelope parameters (0.3ms ramp time for fast response, prevents bleeding across events)
     juce::LinearSmoothedValue<float> smoothedNanoGate;
@@ -325,10 +509,35 @@ private:
 
     // Param listeners
     void updateCachedParameters();
+    void cacheParameterPointers();
+
+    // Raw values behind the cached tables, looked up once so rebuilding them does no string work
+    struct WeightSource
+    {
+        std::atomic<float>* weight = nullptr;
+        std::atomic<float>* active = nullptr;
+    };
+    std::array<WeightSource, 13> regularWeightSources;
+    std::array<WeightSource, 12> nanoWeightSources;
+    std::array<WeightSource, 9> quantWeightSources;
+    std::array<std::atomic<float>*, 12> nanoRatioSources {};
+    std::atomic<float>* nanoBlendParam = nullptr;
+    std::atomic<float>* occurrenceModeParam = nullptr;
+    std::atomic<float>* euclidStepsParam = nullptr;
+    std::atomic<float>* euclidHitsParam = nullptr;
+    std::atomic<float>* euclidRotationParam = nullptr;
+    std::atomic<float>* markovStrengthParam = nullptr;
+
     void initializeParameterListeners();
     void parameterChanged(const juce::String& parameterID, float newValue) override;
     void updateWaveshaperFunction(int algorithm, float drive, bool gainCompensation);
 
+    // Rate transition matrix and pattern script persistence (stored as children of the APVTS state)
+    void storeRateTransitionsInState();
+    void storePatternScriptInState();
+    void valueTreeRedirected(juce::ValueTree& treeWhichHasBeenChanged) override;
+    void restoreNonParameterState(const juce::ValueTree& state);
+
     // Nano tuning system methods
     void updateNanoRatiosFromTuning();
     void updateNanoVisibilityFromScale();
@@ -338,6 +547,17 @@ private:
     // Output buffer management
     void resizeOutputBufferForBpm(double bpm, double sampleRate);
 
+    // Rate slot drawn from the rate weights (or the Markov chain), see RateMarkovChain
+    int drawRateSlot(bool useMarkov, const std::array<float, 13>& regularWeights,
+                     const std::array<float, 12>& nanoWeights, float blend);
+    bool isRateSlotActive(int slot) const;
+
+    // Follower: applies the leader's decision for the pending unit once it has been published
+    bool applyGroupDecision(int group, bool followRate, bool autoStutter);
+
+    // Queues the scheduled event (pending decisions, nextQuantIndex) for the editor preview
+    void announceUpcomingEvent(int unitStart);
+
     // Weighted probability selection utility
     template<typename Container>
     static int selectWeightedIndex(const Container& weights, int defaultIndex = 0)
@@ -358,6 +578,28 @@ private:
         return idx;
     }
 
+    // Euclidean rhythm utility: k hits spread as evenly as possible over n steps, rotated right
+    static juce::uint32 computeEuclideanMask(int hits, int steps, int rotation)
+    {
+        steps = juce::jlimit(1, MAX_EUCLIDEAN_STEPS, steps);
+        hits = juce::jlimit(0, steps, hits);
+        rotation = ((rotation % steps) + steps) % steps;
+
+        juce::uint32 mask = 0;
+        for (int i = 0; i < steps; ++i) {
+            // Bresenham form of Bjorklund's algorithm (first step is always a hit)
+            if ((i * hits) % steps < hits)
+                mask |= 1u << ((i + rotation) % steps);
+        }
+        return mask;
+    }
+
+    static inline bool isEuclideanHit(juce::uint32 mask, int steps, int unitIndex)
+    {
+        int step = ((unitIndex % steps) + steps) % steps;
+        return (mask >> step) & 1u;
+    }
+
     // Envelope gain calculation utility
     static inline float calculateEnvelopeGain(float progress, float shapeParam)
     {
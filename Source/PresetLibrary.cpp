@@ -0,0 +1,384 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetLibrary.h"
+
+namespace
+{
+    constexpr int INDEX_MAGIC = 0x4950534e;     // "NSPI"
+    constexpr int INDEX_VERSION = 1;
+
+    // Lower-case words of the searchable metadata
+    juce::StringArray getWords(const PresetIndexEntry& entry)
+    {
+        juce::String text = entry.name + " " + entry.category + " " + entry.author + " " + entry.tags.joinIntoString(" ");
+
+        juce::StringArray words;
+        words.addTokens(text.toLowerCase(), " _-.,;:/()[]", "");
+        words.removeEmptyStrings();
+        words.removeDuplicates(false);
+        return words;
+    }
+}
+
+//==============================================================================
+PresetLibrary::PresetLibrary()
+    : juce::Thread("NanoStutt Preset Library"),
+      presetDirectory(getUserPresetsDirectory()),
+      snapshot(std::make_shared<Snapshot>())
+{
+    // Without a usable index the library starts empty: build it once now
+    scanRequested = !loadIndex();
+    startThread(juce::Thread::Priority::low);
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    stopThread(4000);
+}
+
+//==============================================================================
+juce::File PresetLibrary::getUserPresetsDirectory()
+{
+    // Get user's application data directory
+    // macOS: ~/Library/Audio/Presets/NanoStutt/
+    // Windows: %APPDATA%\NanoStutt\Presets\
+
+    juce::File presetDir;
+
+#if JUCE_MAC
+    presetDir = juce::File::getSpecialLocation(juce::File::userMusicDirectory)
+                    .getChildFile("Audio")
+                    .getChildFile("Presets")
+                    .getChildFile("NanoStutt");
+#elif JUCE_WINDOWS
+    presetDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                    .getChildFile("NanoStutt")
+                    .getChildFile("Presets");
+#else
+    presetDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                    .getChildFile(".nanostutt")
+                    .getChildFile("presets");
+#endif
+
+    // Create directory if it doesn't exist
+    if (!presetDir.exists())
+        presetDir.createDirectory();
+
+    return presetDir;
+}
+
+std::shared_ptr<const PresetLibrary::Snapshot> PresetLibrary::getSnapshot() const
+{
+    const juce::ScopedLock lock(snapshotLock);
+    return snapshot;
+}
+
+juce::Array<int> PresetLibrary::search(const Snapshot& snapshot, const juce::String& query)
+{
+    juce::StringArray queryWords;
+    queryWords.addTokens(query.toLowerCase(), " _-.,;:/()[]", "");
+    queryWords.removeEmptyStrings();
+
+    juce::Array<int> result;
+    if (queryWords.isEmpty())
+    {
+        for (int i = 0; i < (int) snapshot.entries.size(); ++i)
+            result.add(i);
+        return result;
+    }
+
+    for (int q = 0; q < queryWords.size(); ++q)
+    {
+        // Union of all entries with a word starting with this query word (an entry
+        // can have several such words), as a sorted set
+        juce::Array<int> matches;
+        for (auto it = snapshot.words.lower_bound(queryWords[q]);
+             it != snapshot.words.end() && it->first.startsWith(queryWords[q]); ++it)
+        {
+            for (int index : it->second)
+                matches.add(index);
+        }
+        matches.sort();
+        matches.removeLast((int) (matches.end() - std::unique(matches.begin(), matches.end())));
+
+        if (q == 0)
+        {
+            result = matches;
+        }
+        else
+        {
+            // Every query word has to match
+            juce::DefaultElementComparator<int> comparator;
+            result.removeIf([&](int index) { return matches.indexOfSorted(comparator, index) < 0; });
+        }
+
+        if (result.isEmpty())
+            break;
+    }
+
+    return result;
+}
+
+void PresetLibrary::updateFile(const juce::File& file)
+{
+    const juce::ScopedLock lock(scanLock);
+
+    auto current = getSnapshot();
+    std::vector<PresetIndexEntry> entries;
+    entries.reserve(current->entries.size() + 1);
+    for (const auto& entry : current->entries)
+    {
+        if (entry.file != file)
+            entries.push_back(entry);
+    }
+
+    PresetIndexEntry updated;
+    if (file.existsAsFile()
+        && file.isAChildOf(presetDirectory)
+        && parseEntry(file, updated))
+    {
+        entries.push_back(updated);
+    }
+
+    publish(std::move(entries));
+    indexNeedsSaving = true;
+    rescan();   // Saves the index
+    sendChangeMessage();
+}
+
+void PresetLibrary::beginWatching()
+{
+    ++numWatchers;
+    rescan();
+}
+
+void PresetLibrary::endWatching()
+{
+    jassert(numWatchers > 0);
+    --numWatchers;
+}
+
+//==============================================================================
+void PresetLibrary::run()
+{
+    while (!threadShouldExit())
+    {
+        if (scanRequested.exchange(false) || numWatchers > 0)
+            scan();
+
+        // Nobody is watching: sleep until a rescan is requested
+        wait(numWatchers > 0 ? RESCAN_INTERVAL_MS : -1);
+    }
+}
+
+void PresetLibrary::scan()
+{
+    auto current = getSnapshot();
+
+    std::map<juce::String, const PresetIndexEntry*> known;
+    for (const auto& entry : current->entries)
+        known[entry.file.getFullPathName()] = &entry;
+
+    std::vector<PresetIndexEntry> entries;
+    entries.reserve(current->entries.size());
+    size_t numKnownSeen = 0;
+    bool changed = false;
+
+    // Directory entries carry modification time and size, so unchanged files are never opened
+    for (const auto& item : juce::RangedDirectoryIterator(presetDirectory, true, "*.xml", juce::File::findFiles))
+    {
+        if (threadShouldExit())
+            return;
+
+        auto file = item.getFile();
+        auto path = file.getFullPathName();
+        juce::int64 modificationTime = item.getModificationTime().toMilliseconds();
+        juce::int64 fileSize = item.getFileSize();
+
+        auto it = known.find(path);
+        if (it != known.end())
+        {
+            ++numKnownSeen;
+            if (it->second->modificationTime == modificationTime && it->second->fileSize == fileSize)
+            {
+                entries.push_back(*it->second);
+                continue;
+            }
+            changed = true;  // Modified (or no longer a valid preset)
+        }
+        else if (rejectedFiles.count(path) != 0 && rejectedFiles[path] == modificationTime)
+        {
+            continue;        // Unchanged file that is not a preset
+        }
+
+        PresetIndexEntry entry;
+        if (parseEntry(file, entry))
+        {
+            entry.modificationTime = modificationTime;
+            entry.fileSize = fileSize;
+            entries.push_back(entry);
+            rejectedFiles.erase(path);
+            changed = true;
+        }
+        else
+        {
+            rejectedFiles[path] = modificationTime;
+        }
+    }
+
+    // Deleted files
+    if (numKnownSeen != current->entries.size())
+        changed = true;
+
+    // updateFile() published meanwhile: scan again against its result instead of overwriting it
+    const juce::ScopedLock lock(scanLock);
+    if (getSnapshot() != current)
+    {
+        rescan();
+        return;
+    }
+
+    if (changed)
+    {
+        DBG("Preset library: " + juce::String((int) entries.size()) + " presets indexed");
+        publish(std::move(entries));
+        sendChangeMessage();
+    }
+
+    if (changed || indexNeedsSaving)
+    {
+        saveIndex();
+        indexNeedsSaving = false;
+    }
+}
+
+bool PresetLibrary::parseEntry(const juce::File& file, PresetIndexEntry& entry)
+{
+    std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(file));
+
+    if (xml == nullptr || !xml->hasTagName("NANOSTUTT_PRESET"))
+        return false;
+
+    // Extract metadata
+    auto* metadata = xml->getChildByName("METADATA");
+    if (metadata == nullptr)
+        return false;
+
+    entry.file = file;
+    entry.name = metadata->getStringAttribute("name", "Untitled");
+    entry.category = metadata->getStringAttribute("category", "Uncategorized");
+    entry.author = metadata->getStringAttribute("author", "Unknown");
+    entry.creationDate = metadata->getStringAttribute("creationDate", "");
+    entry.description = metadata->getStringAttribute("description", "");
+    entry.tags = juce::StringArray::fromTokens(metadata->getStringAttribute("tags", ""), ",", "");
+    entry.tags.trim();
+    entry.tags.removeEmptyStrings();
+    entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+    entry.fileSize = file.getSize();
+
+    return true;
+}
+
+void PresetLibrary::publish(std::vector<PresetIndexEntry> entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const PresetIndexEntry& a, const PresetIndexEntry& b)
+    {
+        int categoryOrder = a.category.compareIgnoreCase(b.category);
+        return categoryOrder != 0 ? categoryOrder < 0 : a.name.compareIgnoreCase(b.name) < 0;
+    });
+
+    auto newSnapshot = std::make_shared<Snapshot>();
+    newSnapshot->entries = std::move(entries);
+
+    for (int i = 0; i < (int) newSnapshot->entries.size(); ++i)
+    {
+        for (const auto& word : getWords(newSnapshot->entries[(size_t) i]))
+            newSnapshot->words[word].push_back(i);
+    }
+
+    const juce::ScopedLock lock(snapshotLock);
+    snapshot = std::move(newSnapshot);
+}
+
+//==============================================================================
+juce::File PresetLibrary::getIndexFile() const
+{
+    return presetDirectory.getChildFile(".preset_index");
+}
+
+bool PresetLibrary::loadIndex()
+{
+    juce::FileInputStream input(getIndexFile());
+    if (!input.openedOk())
+        return false;
+
+    if (input.readInt() != INDEX_MAGIC || input.readInt() != INDEX_VERSION)
+    {
+        DBG("Preset library: ignoring index with unknown format");
+        return false;
+    }
+
+    int numEntries = input.readInt();
+    if (numEntries < 0)
+        return false;
+
+    std::vector<PresetIndexEntry> entries;
+    entries.reserve((size_t) numEntries);
+
+    for (int i = 0; i < numEntries && !input.isExhausted(); ++i)
+    {
+        PresetIndexEntry entry;
+        entry.file = presetDirectory.getChildFile(input.readString());
+        entry.modificationTime = input.readInt64();
+        entry.fileSize = input.readInt64();
+        entry.name = input.readString();
+        entry.category = input.readString();
+        entry.author = input.readString();
+        entry.creationDate = input.readString();
+        entry.description = input.readString();
+        entry.tags = juce::StringArray::fromLines(input.readString());
+        entry.tags.removeEmptyStrings();
+        entries.push_back(entry);
+    }
+
+    publish(std::move(entries));
+    return true;
+}
+
+void PresetLibrary::saveIndex()
+{
+    auto current = getSnapshot();
+
+    juce::TemporaryFile temp(getIndexFile());
+    {
+        juce::FileOutputStream output(temp.getFile());
+        if (!output.openedOk())
+            return;
+
+        output.writeInt(INDEX_MAGIC);
+        output.writeInt(INDEX_VERSION);
+        output.writeInt((int) current->entries.size());
+
+        for (const auto& entry : current->entries)
+        {
+            output.writeString(entry.file.getRelativePathFrom(presetDirectory));
+            output.writeInt64(entry.modificationTime);
+            output.writeInt64(entry.fileSize);
+            output.writeString(entry.name);
+            output.writeString(entry.category);
+            output.writeString(entry.author);
+            output.writeString(entry.creationDate);
+            output.writeString(entry.description);
+            output.writeString(entry.tags.joinIntoString("\n"));
+        }
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+        DBG("Preset library: failed to write " + getIndexFile().getFullPathName());
+}
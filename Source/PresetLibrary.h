@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+    Indexed, process-wide cache of the user preset library
+
+    Listing presets used to parse every preset file on the message thread.
+    The library instead keeps an index of the metadata (name, category,
+    author, tags, modification time and size) that is:
+
+    - loaded from an on-disk index file at startup, without touching the
+      preset files themselves
+    - kept current by a background thread that rescans the preset directory
+      on request, and polls it only while someone is watching (an editor is
+      open); a scan reparses only files whose modification time or size changed
+    - shared by every plugin instance in the process (SharedResourcePointer)
+    - searchable by name, category, author and tags through an in-memory
+      inverted index (word prefix search)
+
+    Readers get an immutable Snapshot; the scanner publishes a new one and
+    sends a change message whenever the library changed.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    Metadata of one user preset file, as stored in the index.
+*/
+struct PresetIndexEntry
+{
+    juce::File file;
+    juce::String name;
+    juce::String category;
+    juce::String author;
+    juce::String creationDate;
+    juce::String description;
+    juce::StringArray tags;
+    juce::int64 modificationTime = 0;   // Milliseconds since the epoch
+    juce::int64 fileSize = 0;
+};
+
+//==============================================================================
+class PresetLibrary : public juce::ChangeBroadcaster,
+                      private juce::Thread
+{
+public:
+    static constexpr int RESCAN_INTERVAL_MS = 2000;     // Polling interval while watched
+
+    struct Snapshot
+    {
+        std::vector<PresetIndexEntry> entries;              // Sorted by category, then name
+        std::map<juce::String, std::vector<int>> words;     // Lower-case word -> entry indices
+    };
+
+    PresetLibrary();
+    ~PresetLibrary() override;
+
+    /**
+        Gets the user presets directory, creating it if it doesn't exist.
+    */
+    static juce::File getUserPresetsDirectory();
+
+    /**
+        Returns the current index (any thread, never blocks on file I/O).
+    */
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+
+    /**
+        Returns the indices of the entries in snapshot that match every word of the
+        query as a word prefix (case-insensitive). An empty query matches everything.
+    */
+    static juce::Array<int> search(const Snapshot& snapshot, const juce::String& query);
+
+    /**
+        Updates the index for one file right away (after it was saved or deleted),
+        instead of waiting for the next background scan.
+    */
+    void updateFile(const juce::File& file);
+
+    /**
+        Asks the background thread to rescan now.
+    */
+    void rescan()
+    {
+        scanRequested = true;
+        notify();
+    }
+
+    /**
+        Message thread: the directory is polled for changes only between matching
+        begin/end calls (e.g. while an editor is open). Beginning also rescans.
+    */
+    void beginWatching();
+    void endWatching();
+
+private:
+    //==========================================================================
+    void run() override;
+
+    // Compares the directory with the index and reparses changed files (scanner thread)
+    void scan();
+
+    // Reads the metadata of one preset file; false if it is not a NanoStutt preset
+    static bool parseEntry(const juce::File& file, PresetIndexEntry& entry);
+
+    // Sorts the entries, builds the word index and makes it the current snapshot
+    void publish(std::vector<PresetIndexEntry> entries);
+
+    juce::File getIndexFile() const;
+    bool loadIndex();
+    void saveIndex();
+
+    //==========================================================================
+    juce::File presetDirectory;
+
+    mutable juce::CriticalSection snapshotLock;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    juce::CriticalSection scanLock;         // Serializes publishing from scan() and updateFile()
+    bool indexNeedsSaving = false;
+    std::atomic<bool> scanRequested { false };
+    std::atomic<int> numWatchers { 0 };
+    std::map<juce::String, juce::int64> rejectedFiles;     // Scanner thread: path -> mtime of files that are not presets
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
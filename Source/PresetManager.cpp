@@ -13,11 +13,8 @@
 //==============================================================================
 PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts)
     : parameters(apvts),
-      isStateModified(false),
-      lastScanTime(0)
+      isStateModified(false)
 {
-    // Ensure user presets directory exists
-    getUserPresetsDirectory();
 }
 
 PresetManager::~PresetManager()
@@ -73,19 +70,19 @@ bool PresetManager::savePreset(const juce::String& presetName,
     auto state = parameters.copyState();
     auto stateXml = state.createXml();
 
-    // Exclude autoStutterEnabled parameter from preset
+    // Exclude session parameters (auto stutter enable, group sync) from preset
     if (stateXml != nullptr)
     {
-        // Remove autoStutterEnabled from state
+        juce::Array<juce::XmlElement*> sessionChildren;
         for (auto* child : stateXml->getChildIterator())
         {
-            if (child->hasAttribute("id") && child->getStringAttribute("id") == "autoStutterEnabled")
-            {
-                stateXml->removeChildElement(child, true);
-                break;
-            }
+            if (child->hasAttribute("id") && sessionParameterIDs.contains(child->getStringAttribute("id")))
+                sessionChildren.add(child);
         }
 
+        for (auto* child : sessionChildren)
+            stateXml->removeChildElement(child, true);
+
         root.addChildElement(stateXml.release());
     }
 
@@ -98,9 +95,8 @@ bool PresetManager::savePreset(const juce::String& presetName,
         currentPresetName = presetName;
         isStateModified = false;
 
-        // Clear cached presets to force rescan
-        cachedUserPresets.clear();
-        lastScanTime = 0;
+        // Index the new file now so menus show it right away
+        library->updateFile(presetFile);
 
         DBG("Preset saved successfully: " + presetFile.getFullPathName());
     }
@@ -122,136 +118,171 @@ bool PresetManager::loadPreset(const juce::File& filePath)
 
     // Parse XML file
     std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(filePath));
+    if (!applyPresetXml(xml.get()))
+        return false;
 
-    if (xml == nullptr || !xml->hasTagName("NANOSTUTT_PRESET"))
+    currentPresetFile = filePath;
+    isStateModified = false;
+
+    DBG("Preset loaded successfully: " + filePath.getFullPathName());
+    return true;
+}
+
+bool PresetManager::loadPreset(const PresetInfo& info)
+{
+    if (info.isFactory)
     {
-        DBG("Invalid preset file format");
-        return false;
+        // Factory preset - decode its record from the embedded bank
+        if (!applyFactoryPreset(info.factoryIndex))
+            return false;
     }
-
-    // Extract metadata
-    auto* metadata = xml->getChildByName("METADATA");
-    if (metadata != nullptr)
+    else if (info.filePath.existsAsFile())
     {
-        currentPresetName = metadata->getStringAttribute("name", "Untitled");
+        // File-based preset - parse from file
+        std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(info.filePath));
+        if (!applyPresetXml(xml.get()))
+            return false;
+    }
+    else
+    {
+        DBG("Preset is neither a factory preset nor a valid file");
+        return false;
     }
 
-    // Find the state element (should be the second child, after METADATA)
-    juce::XmlElement* stateXml = nullptr;
-    for (auto* child : xml->getChildIterator())
+    currentPresetFile = info.filePath;
+    isStateModified = false;
+
+    DBG("Preset loaded successfully: " + info.name);
+    return true;
+}
+
+bool PresetManager::applyPresetXml(const juce::XmlElement* xml)
+{
+    jassert(stateTable != nullptr && stateApplier != nullptr);
+
+    if (xml == nullptr || !xml->hasTagName("NANOSTUTT_PRESET"))
     {
-        if (child->hasTagName(parameters.state.getType()))
-        {
-            stateXml = child;
-            break;
-        }
+        DBG("Invalid preset format");
+        return false;
     }
 
+    // Find the state element (should be the second child, after METADATA)
+    auto* stateXml = xml->getChildByName(parameters.state.getType());
     if (stateXml == nullptr)
     {
-        DBG("No state data found in preset file");
+        DBG("No state data found in preset");
         return false;
     }
 
-    // Store current autoStutterEnabled value
-    bool currentAutoStutterEnabled = parameters.getRawParameterValue("autoStutterEnabled")->load() > 0.5f;
+    // Extract metadata
+    if (auto* metadata = xml->getChildByName("METADATA"))
+        currentPresetName = metadata->getStringAttribute("name", "Untitled");
+
+    std::vector<float> values;
+    readStateValues(*stateXml, *stateTable, values);
 
-    // Create ValueTree from XML and restore state
-    juce::ValueTree newState = juce::ValueTree::fromXml(*stateXml);
-    if (newState.isValid())
+    // Rate matrix, pattern script
+    juce::ValueTree children(parameters.state.getType());
+    for (auto* child : stateXml->getChildIterator())
     {
-        parameters.replaceState(newState);
+        if (!child->hasTagName("PARAM"))
+            children.appendChild(juce::ValueTree::fromXml(*child), nullptr);
+    }
 
-        // Restore the autoStutterEnabled parameter (don't let preset override it)
-        auto* param = parameters.getParameter("autoStutterEnabled");
-        if (param != nullptr)
-            param->setValueNotifyingHost(currentAutoStutterEnabled ? 1.0f : 0.0f);
+    // Only values that differ from the current ones are set, derived tables are rebuilt once
+    stateApplier(values, children);
+    return true;
+}
 
-        currentPresetFile = filePath;
-        isStateModified = false;
+bool PresetManager::applyFactoryPreset(int factoryIndex)
+{
+    jassert(stateTable != nullptr && stateApplier != nullptr);
 
-        DBG("Preset loaded successfully: " + filePath.getFullPathName());
-        return true;
+    BinaryState::State state;
+    if (!factoryBank->decode(factoryIndex, state))
+    {
+        DBG("Invalid factory preset " + juce::String(factoryIndex));
+        return false;
     }
 
-    DBG("Failed to create ValueTree from preset state");
-    return false;
+    currentPresetName = factoryBank->getEntry(factoryIndex).name;
+
+    std::vector<float> values;
+    readStateValues(state, *stateTable, values);
+
+    // The EXTRA tree holds the rate matrix and pattern script, like a preset's state children
+    stateApplier(values, state.extra);
+    return true;
 }
 
-bool PresetManager::loadPreset(const PresetInfo& info)
+bool PresetManager::readPresetValues(const PresetInfo& info, const ParameterTable& table, std::vector<float>& normalisedValues)
 {
-    std::unique_ptr<juce::XmlElement> xml;
-
-    // Check if this is a BinaryData preset (has xmlContent) or file-based preset
-    if (info.xmlContent.isNotEmpty())
+    if (info.isFactory)
     {
-        // BinaryData preset - parse from string
-        xml = juce::XmlDocument::parse(info.xmlContent);
+        BinaryState::State state;
+        if (!factoryBank->decode(info.factoryIndex, state))
+            return false;
+
+        readStateValues(state, table, normalisedValues);
+        return true;
     }
-    else if (info.filePath.existsAsFile())
-    {
-        // File-based preset - parse from file
+
+    std::unique_ptr<juce::XmlElement> xml;
+    if (info.filePath.existsAsFile())
         xml = juce::XmlDocument::parse(info.filePath);
-    }
-    else
-    {
-        DBG("Preset has no valid xmlContent or filePath");
-        return false;
-    }
 
     if (xml == nullptr || !xml->hasTagName("NANOSTUTT_PRESET"))
-    {
-        DBG("Invalid preset format");
         return false;
-    }
 
-    // Extract metadata
-    auto* metadata = xml->getChildByName("METADATA");
-    if (metadata != nullptr)
-    {
-        currentPresetName = metadata->getStringAttribute("name", "Untitled");
-    }
+    auto* stateXml = xml->getChildByName(parameters.state.getType());
+    if (stateXml == nullptr)
+        return false;
 
-    // Find the state element (should be the second child, after METADATA)
-    juce::XmlElement* stateXml = nullptr;
-    for (auto* child : xml->getChildIterator())
+    readStateValues(*stateXml, table, normalisedValues);
+    return true;
+}
+
+void PresetManager::readStateValues(const juce::XmlElement& stateXml, const ParameterTable& table, std::vector<float>& normalisedValues)
+{
+    // Missing parameters fall back to their defaults (as replaceState would)
+    normalisedValues = table.getDefaults();
+
+    for (auto* child : stateXml.getChildWithTagNameIterator("PARAM"))
     {
-        if (child->hasTagName(parameters.state.getType()))
+        int index = table.indexOf(child->getStringAttribute("id"));
+        if (index >= 0 && child->hasAttribute("value"))
         {
-            stateXml = child;
-            break;
+            auto* param = table.getParameter(index);
+            normalisedValues[(size_t) index] = param->convertTo0to1((float) child->getDoubleAttribute("value"));
         }
     }
 
-    if (stateXml == nullptr)
-    {
-        DBG("No state data found in preset");
-        return false;
-    }
+    keepSessionValues(table, normalisedValues);
+}
 
-    // Store current autoStutterEnabled value
-    bool currentAutoStutterEnabled = parameters.getRawParameterValue("autoStutterEnabled")->load() > 0.5f;
+void PresetManager::readStateValues(const BinaryState::State& state, const ParameterTable& table, std::vector<float>& normalisedValues)
+{
+    normalisedValues = table.getDefaults();
 
-    // Create ValueTree from XML and restore state
-    juce::ValueTree newState = juce::ValueTree::fromXml(*stateXml);
-    if (newState.isValid())
+    for (int i = 0; i < state.parameterIDs.size(); ++i)
     {
-        parameters.replaceState(newState);
-
-        // Restore the autoStutterEnabled parameter (don't let preset override it)
-        auto* param = parameters.getParameter("autoStutterEnabled");
-        if (param != nullptr)
-            param->setValueNotifyingHost(currentAutoStutterEnabled ? 1.0f : 0.0f);
+        int index = table.indexOf(state.parameterIDs[i]);
+        if (index >= 0)
+            normalisedValues[(size_t) index] = table.getParameter(index)->convertTo0to1(state.values[(size_t) i]);
+    }
 
-        currentPresetFile = info.filePath;
-        isStateModified = false;
+    keepSessionValues(table, normalisedValues);
+}
 
-        DBG("Preset loaded successfully: " + info.name);
-        return true;
+void PresetManager::keepSessionValues(const ParameterTable& table, std::vector<float>& normalisedValues)
+{
+    // Session parameters keep their current value
+    for (auto& id : sessionParameterIDs)
+    {
+        int index = table.indexOf(id);
+        if (index >= 0)
+            normalisedValues[(size_t) index] = table.getParameter(index)->getValue();
     }
-
-    DBG("Failed to create ValueTree from preset state");
-    return false;
 }
 
 bool PresetManager::deletePreset(const juce::File& filePath)
@@ -271,9 +302,7 @@ bool PresetManager::deletePreset(const juce::File& filePath)
 
     if (success)
     {
-        // Clear cached presets to force rescan
-        cachedUserPresets.clear();
-        lastScanTime = 0;
+        library->updateFile(filePath);
 
         // Clear current preset if we just deleted it
         if (currentPresetFile == filePath)
@@ -288,73 +317,33 @@ bool PresetManager::deletePreset(const juce::File& filePath)
 //==============================================================================
 juce::Array<PresetInfo> PresetManager::getFactoryPresets()
 {
-    // Return cached results if available
-    if (!cachedFactoryPresets.isEmpty())
-        return cachedFactoryPresets;
-
     juce::Array<PresetInfo> presets;
-
-    // Load presets from BinaryData (embedded in the plugin binary)
-    for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
-    {
-        const char* resourceName = BinaryData::namedResourceList[i];
-        int dataSize = 0;
-        const char* xmlData = BinaryData::getNamedResource(resourceName, dataSize);
-
-        if (xmlData != nullptr && dataSize > 0)
-        {
-            // Convert to JUCE string
-            juce::String xmlString(xmlData, dataSize);
-
-            // Parse the XML
-            PresetInfo info;
-            info.isFactory = true;
-
-            if (parsePresetXml(xmlString, info))
-            {
-                presets.add(info);
-            }
-        }
-    }
-
-    // Cache results
-    cachedFactoryPresets = presets;
-
-    DBG("Loaded " + juce::String(presets.size()) + " factory presets from BinaryData");
+    presets.ensureStorageAllocated(factoryBank->size());
+    for (int i = 0; i < factoryBank->size(); ++i)
+        presets.add(toPresetInfo(factoryBank->getEntry(i), i));
 
     return presets;
 }
 
 juce::Array<PresetInfo> PresetManager::getUserPresets()
 {
-    juce::int64 currentTime = juce::Time::currentTimeMillis();
-
-    // Return cached results if less than 1 second old
-    if (!cachedUserPresets.isEmpty() && (currentTime - lastScanTime) < 1000)
-        return cachedUserPresets;
+    auto snapshot = library->getSnapshot();
 
     juce::Array<PresetInfo> presets;
-    juce::File userDir = getUserPresetsDirectory();
+    presets.ensureStorageAllocated((int) snapshot->entries.size());
+    for (const auto& entry : snapshot->entries)
+        presets.add(toPresetInfo(entry));
 
-    if (!userDir.exists())
-        return presets;
-
-    // Recursively find all .xml files
-    juce::Array<juce::File> presetFiles;
-    userDir.findChildFiles(presetFiles, juce::File::findFiles, true, "*.xml");
-
-    for (const auto& file : presetFiles)
-    {
-        PresetInfo info;
-        info.isFactory = false;
+    return presets;
+}
 
-        if (parsePresetFile(file, info))
-            presets.add(info);
-    }
+juce::Array<PresetInfo> PresetManager::searchUserPresets(const juce::String& query)
+{
+    auto snapshot = library->getSnapshot();
 
-    // Cache results
-    cachedUserPresets = presets;
-    lastScanTime = currentTime;
+    juce::Array<PresetInfo> presets;
+    for (int index : PresetLibrary::search(*snapshot, query))
+        presets.add(toPresetInfo(snapshot->entries[(size_t) index]));
 
     return presets;
 }
@@ -425,94 +414,35 @@ void PresetManager::clearCurrentPreset()
 //==============================================================================
 juce::File PresetManager::getUserPresetsDirectory()
 {
-    // Get user's application data directory
-    // macOS: ~/Library/Audio/Presets/NanoStutt/
-    // Windows: %APPDATA%\NanoStutt\Presets\
-
-    juce::File presetDir;
-
-#if JUCE_MAC
-    presetDir = juce::File::getSpecialLocation(juce::File::userMusicDirectory)
-                    .getChildFile("Audio")
-                    .getChildFile("Presets")
-                    .getChildFile("NanoStutt");
-#elif JUCE_WINDOWS
-    presetDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-                    .getChildFile("NanoStutt")
-                    .getChildFile("Presets");
-#else
-    presetDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-                    .getChildFile(".nanostutt")
-                    .getChildFile("presets");
-#endif
-
-    // Create directory if it doesn't exist
-    if (!presetDir.exists())
-        presetDir.createDirectory();
-
-    return presetDir;
+    return PresetLibrary::getUserPresetsDirectory();
 }
 
-juce::File PresetManager::getFactoryPresetsDirectory()
+PresetInfo PresetManager::toPresetInfo(const PresetIndexEntry& entry)
 {
-    // Factory presets are bundled with the plugin
-    // For now, return an empty directory (will be populated when we embed presets)
-    // In the future, this will use BinaryData to access embedded presets
-
-    // Placeholder: Check in the plugin bundle's Resources folder
-#if JUCE_MAC
-    juce::File bundleDir = juce::File::getSpecialLocation(juce::File::currentApplicationFile);
-    return bundleDir.getChildFile("Contents").getChildFile("Resources").getChildFile("Presets");
-#elif JUCE_WINDOWS
-    juce::File exeDir = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory();
-    return exeDir.getChildFile("Presets");
-#else
-    return juce::File();
-#endif
-}
-
-bool PresetManager::parsePresetFile(const juce::File& file, PresetInfo& info)
-{
-    std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(file));
-
-    if (xml == nullptr || !xml->hasTagName("NANOSTUTT_PRESET"))
-        return false;
-
-    // Extract metadata
-    auto* metadata = xml->getChildByName("METADATA");
-    if (metadata == nullptr)
-        return false;
-
-    info.name = metadata->getStringAttribute("name", "Untitled");
-    info.category = metadata->getStringAttribute("category", "Uncategorized");
-    info.author = metadata->getStringAttribute("author", "Unknown");
-    info.creationDate = metadata->getStringAttribute("creationDate", "");
-    info.description = metadata->getStringAttribute("description", "");
-    info.filePath = file;
-
-    return true;
+    PresetInfo info;
+    info.name = entry.name;
+    info.category = entry.category;
+    info.author = entry.author;
+    info.creationDate = entry.creationDate;
+    info.description = entry.description;
+    info.tags = entry.tags;
+    info.filePath = entry.file;
+    info.isFactory = false;
+    return info;
 }
 
-bool PresetManager::parsePresetXml(const juce::String& xmlString, PresetInfo& info)
+PresetInfo PresetManager::toPresetInfo(const FactoryPresetBank::Entry& entry, int factoryIndex)
 {
-    std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(xmlString));
-
-    if (xml == nullptr || !xml->hasTagName("NANOSTUTT_PRESET"))
-        return false;
-
-    // Extract metadata
-    auto* metadata = xml->getChildByName("METADATA");
-    if (metadata == nullptr)
-        return false;
-
-    info.name = metadata->getStringAttribute("name", "Untitled");
-    info.category = metadata->getStringAttribute("category", "Uncategorized");
-    info.author = metadata->getStringAttribute("author", "Unknown");
-    info.creationDate = metadata->getStringAttribute("creationDate", "");
-    info.description = metadata->getStringAttribute("description", "");
-    info.xmlContent = xmlString; // Store the XML for later loading
-
-    return true;
+    PresetInfo info;
+    info.name = entry.name;
+    info.category = entry.category;
+    info.author = entry.author;
+    info.creationDate = entry.creationDate;
+    info.description = entry.description;
+    info.tags = entry.tags;
+    info.factoryIndex = factoryIndex;
+    info.isFactory = true;
+    return info;
 }
 
 juce::String PresetManager::createValidFilename(const juce::String& presetName)
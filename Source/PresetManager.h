@@ -13,6 +13,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PresetLibrary.h"
+#include "ParameterTable.h"
+#include "FactoryPresetBank.h"
 
 //==============================================================================
 /**
@@ -25,13 +28,14 @@ struct PresetInfo
     juce::String author;
     juce::String creationDate;
     juce::String description;
+    juce::StringArray tags;
     juce::File filePath;
-    juce::String xmlContent;  // For BinaryData presets (stored as string)
+    int factoryIndex;         // For factory presets: entry in the FactoryPresetBank
     bool isFactory;
 
     PresetInfo()
         : name("Untitled"), category("User"), author(""),
-          creationDate(""), description(""), isFactory(false)
+          creationDate(""), description(""), factoryIndex(-1), isFactory(false)
     {}
 };
 
@@ -41,7 +45,8 @@ struct PresetInfo
 
     Features:
     - Save/load presets with metadata
-    - Scan factory and user preset directories
+    - List factory presets from the embedded FactoryPresetBank, user presets from
+      the shared PresetLibrary index
     - XML-based preset format
     - Automatic directory creation
 */
@@ -79,13 +84,46 @@ public:
     bool loadPreset(const juce::File& filePath);
 
     /**
-        Loads a preset from PresetInfo (supports both file-based and BinaryData presets).
+        Loads a preset from PresetInfo (supports both file-based and factory presets).
 
         @param info             PresetInfo containing preset data
         @return                 True if load was successful
     */
     bool loadPreset(const PresetInfo& info);
 
+    /**
+        Reads a preset's parameter values without applying them (e.g. as a morph source).
+        Parameters missing from the preset get their default value, session parameters
+        keep their current value.
+
+        @param info             Preset to read
+        @param table            Parameter order of the result
+        @param normalisedValues Filled with one normalised value per table entry
+        @return                 True if the preset could be read
+    */
+    bool readPresetValues(const PresetInfo& info, const ParameterTable& table, std::vector<float>& normalisedValues);
+
+    /**
+        Parameters that belong to the session rather than the sound.
+    */
+    static const juce::StringArray& getSessionParameterIDs() { return sessionParameterIDs; }
+
+    /**
+        Applies a parsed preset: one normalised value per parameter table entry,
+        plus the non-parameter children of the preset state.
+    */
+    using StateApplier = std::function<void(const std::vector<float>& normalisedValues, const juce::ValueTree& nonParameterChildren)>;
+
+    /**
+        Connects the processor's batched apply path; presets are applied through it
+        instead of replacing the whole state. Must be set before loading presets.
+    */
+    void setStateApplier(const ParameterTable& table, StateApplier applier)
+    {
+        stateTable = &table;
+        stateApplier = std::move(applier);
+    }
+
     /**
         Deletes a user preset file.
 
@@ -98,19 +136,34 @@ public:
     // Preset Discovery
 
     /**
-        Scans and returns all available factory presets.
+        Returns all factory presets from the embedded bank's index.
+        Never decodes preset data; that happens when a preset is loaded or read.
 
         @return     Array of PresetInfo for factory presets
     */
     juce::Array<PresetInfo> getFactoryPresets();
 
     /**
-        Scans and returns all user-created presets.
+        Returns all user-created presets from the shared preset library index.
+        Never parses preset files; the library updates in the background.
 
-        @return     Array of PresetInfo for user presets
+        @return     Array of PresetInfo for user presets, sorted by category and name
     */
     juce::Array<PresetInfo> getUserPresets();
 
+    /**
+        Searches user presets by name, category, author and tags (word prefixes).
+
+        @param query        Words to match, e.g. "glitch dark"
+        @return             Matching user presets
+    */
+    juce::Array<PresetInfo> searchUserPresets(const juce::String& query);
+
+    /**
+        The process-wide user preset index; broadcasts a change when it was updated.
+    */
+    PresetLibrary& getLibrary() { return *library; }
+
     /**
         Returns all presets organized by category.
 
@@ -168,30 +221,49 @@ private:
     //==========================================================================
     // Helper Methods
 
+    /**
+        Parameters that belong to the session rather than the sound.
+        They are never written to presets and keep their value when a preset loads.
+    */
+    static inline const juce::StringArray sessionParameterIDs { "autoStutterEnabled", "syncGroup", "syncRole", "syncFollowRates", "presetMorph",
+                                                                "stateLink", "linkExcludeMix", "linkExcludeTuning" };
+
     /**
         Gets the user presets directory, creating it if it doesn't exist.
     */
     juce::File getUserPresetsDirectory();
 
     /**
-        Gets the factory presets directory (bundled with plugin).
+        Validates a parsed preset and hands its values to the state applier.
     */
-    juce::File getFactoryPresetsDirectory();
+    bool applyPresetXml(const juce::XmlElement* xml);
 
     /**
-        Parses a preset XML file and extracts metadata.
+        Decodes a factory preset and hands its values to the state applier.
+    */
+    bool applyFactoryPreset(int factoryIndex);
 
-        @param file             Preset file to parse
-        @param info             PresetInfo structure to fill
-        @return                 True if parsing was successful
+    /**
+        Reads the PARAM values of a preset state in table order (defaults for
+        missing parameters, current values for session parameters).
+    */
+    static void readStateValues(const juce::XmlElement& stateXml, const ParameterTable& table, std::vector<float>& normalisedValues);
+    static void readStateValues(const BinaryState::State& state, const ParameterTable& table, std::vector<float>& normalisedValues);
+
+    /**
+        Puts the current values of the session parameters into normalisedValues.
+    */
+    static void keepSessionValues(const ParameterTable& table, std::vector<float>& normalisedValues);
+
+    /**
+        Converts a preset library index entry to a PresetInfo.
     */
-    bool parsePresetFile(const juce::File& file, PresetInfo& info);
+    static PresetInfo toPresetInfo(const PresetIndexEntry& entry);
 
     /**
-        Parses a preset XML string and extracts metadata.
-        Used for BinaryData presets stored as strings.
+        Converts a factory preset bank entry to a PresetInfo.
     */
-    bool parsePresetXml(const juce::String& xmlString, PresetInfo& info);
+    static PresetInfo toPresetInfo(const FactoryPresetBank::Entry& entry, int factoryIndex);
 
     /**
         Creates a valid filename from a preset name.
@@ -205,15 +277,16 @@ private:
     // Member Variables
 
     juce::AudioProcessorValueTreeState& parameters;
+    const ParameterTable* stateTable = nullptr;
+    StateApplier stateApplier;
 
     juce::File currentPresetFile;
     juce::String currentPresetName;
     bool isStateModified;
 
-    // Cached preset lists (updated when scanned)
-    juce::Array<PresetInfo> cachedFactoryPresets;
-    juce::Array<PresetInfo> cachedUserPresets;
-    juce::int64 lastScanTime;
+    // Both shared by every instance in the process
+    juce::SharedResourcePointer<FactoryPresetBank> factoryBank;
+    juce::SharedResourcePointer<PresetLibrary> library;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetManager)
 };
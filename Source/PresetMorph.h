@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    PresetMorph.h
+    Morphing between two parameter sets (A and B) as a live performance macro
+
+    When a source is assigned (message thread), the plan is rebuilt once:
+    only parameters that differ between A and B are kept, continuous ones as
+    base + difference, discrete ones as the two values to switch between at
+    SWITCH_THRESHOLD. Per block the audio thread evaluates
+    value = base + amount * difference in one pass over the flat arrays and
+    writes only values that actually moved.
+
+    Session parameters (and the morph amount itself) are never morphed.
+    The sources belong to the session: the processor stores them in its
+    session state (not in presets), see getSource().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <vector>
+#include "ParameterTable.h"
+
+class PresetMorph
+{
+public:
+    static constexpr float SWITCH_THRESHOLD = 0.5f;
+    static constexpr float MIN_CHANGE = 1.0e-5f;    // Normalised; smaller moves are not written
+
+    enum Source { A = 0, B = 1 };
+
+    /**
+        Message thread, before use: sizes the plan for the table so assigning
+        sources never allocates while the audio thread may be reading.
+
+        @param excluded     Parameter IDs that are never morphed
+    */
+    void prepare(const ParameterTable& tableToUse, const juce::StringArray& excluded)
+    {
+        table = &tableToUse;
+        auto size = (size_t) table->size();
+
+        morphable.assign(size, true);
+        for (int i = 0; i < table->size(); ++i)
+            morphable[(size_t) i] = !excluded.contains(table->getID(i));
+
+        for (auto& values : sources)
+            values.clear();
+
+        const juce::SpinLock::ScopedLockType lock(planLock);
+        continuousIndices.assign(size, 0);
+        base.assign(size, 0.0f);
+        difference.assign(size, 0.0f);
+        morphed.assign(size, 0.0f);
+        discreteIndices.assign(size, 0);
+        discreteA.assign(size, 0.0f);
+        discreteB.assign(size, 0.0f);
+        numContinuous = 0;
+        numDiscrete = 0;
+        planChanged = true;
+    }
+
+    // Message thread: assigns A or B (normalised values in table order) and rebuilds the plan
+    void setSource(Source source, const std::vector<float>& normalisedValues)
+    {
+        jassert(table != nullptr && (int) normalisedValues.size() == table->size());
+        {
+            const juce::ScopedLock lock(sourceLock);
+            sources[source] = normalisedValues;
+        }
+        rebuildPlan();
+    }
+
+    void clearSource(Source source)
+    {
+        {
+            const juce::ScopedLock lock(sourceLock);
+            sources[source].clear();
+        }
+        rebuildPlan();
+    }
+
+    bool hasSource(Source source) const { return !sources[source].empty(); }
+
+    // Any thread (the host may save its session from any thread): a copy of the source, empty if unassigned
+    std::vector<float> getSource(Source source) const
+    {
+        const juce::ScopedLock lock(sourceLock);
+        return sources[source];
+    }
+
+    // Morph is active once both sources are assigned
+    bool isActive() const { return active.load(std::memory_order_relaxed); }
+
+    /**
+        Audio thread: evaluates the plan at amount (0 = A, 1 = B) and calls
+        write(parameterIndex, normalisedValue) for every parameter that moved.
+        Does nothing if the amount and plan are unchanged, or the plan is
+        being rebuilt right now (the next block picks it up).
+
+        @return     True if any parameter was written
+    */
+    template <typename WriteFunction>
+    bool process(float amount, WriteFunction&& write)
+    {
+        const juce::SpinLock::ScopedTryLockType lock(planLock);
+        if (!lock.isLocked() || (numContinuous == 0 && numDiscrete == 0))
+            return false;
+
+        if (amount == lastAmount && !planChanged)
+            return false;
+        lastAmount = amount;
+        planChanged = false;
+
+        for (int k = 0; k < numContinuous; ++k)
+            morphed[(size_t) k] = std::fma(amount, difference[(size_t) k], base[(size_t) k]);
+
+        bool wrote = false;
+
+        // Discrete switches first, then the continuous pass
+        for (int k = 0; k < numDiscrete; ++k)
+        {
+            int index = discreteIndices[(size_t) k];
+            float value = amount >= SWITCH_THRESHOLD ? discreteB[(size_t) k] : discreteA[(size_t) k];
+            if (table->getParameter(index)->getValue() != value)
+            {
+                write(index, value);
+                wrote = true;
+            }
+        }
+
+        for (int k = 0; k < numContinuous; ++k)
+        {
+            int index = continuousIndices[(size_t) k];
+            if (std::abs(table->getParameter(index)->getValue() - morphed[(size_t) k]) > MIN_CHANGE)
+            {
+                write(index, morphed[(size_t) k]);
+                wrote = true;
+            }
+        }
+
+        return wrote;
+    }
+
+private:
+    void rebuildPlan()
+    {
+        bool bothAssigned = hasSource(A) && hasSource(B);
+
+        const juce::SpinLock::ScopedLockType lock(planLock);
+        numContinuous = 0;
+        numDiscrete = 0;
+        planChanged = true;
+
+        if (bothAssigned)
+        {
+            const auto& a = sources[A];
+            const auto& b = sources[B];
+
+            for (int i = 0; i < table->size(); ++i)
+            {
+                if (!morphable[(size_t) i] || a[(size_t) i] == b[(size_t) i])
+                    continue;
+
+                if (table->isContinuous(i))
+                {
+                    continuousIndices[(size_t) numContinuous] = i;
+                    base[(size_t) numContinuous] = a[(size_t) i];
+                    difference[(size_t) numContinuous] = b[(size_t) i] - a[(size_t) i];
+                    ++numContinuous;
+                }
+                else
+                {
+                    discreteIndices[(size_t) numDiscrete] = i;
+                    discreteA[(size_t) numDiscrete] = a[(size_t) i];
+                    discreteB[(size_t) numDiscrete] = b[(size_t) i];
+                    ++numDiscrete;
+                }
+            }
+        }
+
+        active.store(bothAssigned, std::memory_order_relaxed);
+    }
+
+    const ParameterTable* table = nullptr;
+    std::vector<bool> morphable;
+    std::vector<float> sources[2];          // Written on the message thread under sourceLock
+    juce::CriticalSection sourceLock;
+
+    // Plan (message thread writes under the lock, audio thread try-locks)
+    juce::SpinLock planLock;
+    std::vector<int> continuousIndices;
+    std::vector<float> base, difference, morphed;
+    std::vector<int> discreteIndices;
+    std::vector<float> discreteA, discreteB;
+    int numContinuous = 0;
+    int numDiscrete = 0;
+    bool planChanged = true;
+    float lastAmount = -1.0f;
+
+    std::atomic<bool> active { false };
+};
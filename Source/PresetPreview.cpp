@@ -0,0 +1,492 @@
+/*
+  ==============================================================================
+
+    PresetPreview.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetPreview.h"
+#include "PluginProcessor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr int PREVIEW_MAGIC = 0x5650534e;   // "NSPV"
+    constexpr int PREVIEW_VERSION = 2;          // 2: mono 16-bit
+
+    // Bump when the engine's sound changes, so old cached previews are not used
+    constexpr juce::uint64 ENGINE_VERSION = 1;
+
+    // 64-bit FNV-1a
+    juce::uint64 hashBytes(const void* data, size_t numBytes, juce::uint64 hash = 0xcbf29ce484222325ull)
+    {
+        auto* bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    juce::String toHex(juce::uint64 value)
+    {
+        return juce::String::toHexString((juce::int64) value);
+    }
+
+    // Previews are auditioned, not mixed: a mono sum halves what is kept in memory
+    std::shared_ptr<juce::AudioBuffer<float>> toMono(const juce::AudioBuffer<float>& source)
+    {
+        int numSamples = source.getNumSamples();
+        auto mono = std::make_shared<juce::AudioBuffer<float>>(1, numSamples);
+        mono->clear();
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+            mono->addFrom(0, 0, source, ch, 0, numSamples, 1.0f / static_cast<float>(source.getNumChannels()));
+        return mono;
+    }
+
+    // Steady transport for the offline engine
+    struct PreviewPlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setIsPlaying(true);
+            info.setBpm(PresetPreviewRenderer::PREVIEW_BPM);
+            info.setTimeSignature(juce::AudioPlayHead::TimeSignature { 4, 4 });
+            info.setTimeInSamples(samplePosition);
+            info.setPpqPosition(static_cast<double>(samplePosition) / sampleRate * PresetPreviewRenderer::PREVIEW_BPM / 60.0);
+            return info;
+        }
+
+        double sampleRate = 44100.0;
+        juce::int64 samplePosition = 0;
+    };
+}
+
+//==============================================================================
+PresetPreviewRenderer::PresetPreviewRenderer(double sampleRate)
+    : juce::Thread("NanoStutt Preset Previews"),
+      cacheDirectory(PresetLibrary::getUserPresetsDirectory().getChildFile(".previews"))
+{
+    if (!cacheDirectory.exists())
+        cacheDirectory.createDirectory();
+
+    setInput(InputSource::TestLoop, sampleRate);
+    startThread(juce::Thread::Priority::low);
+}
+
+PresetPreviewRenderer::~PresetPreviewRenderer()
+{
+    stopThread(4000);
+}
+
+//==============================================================================
+void PresetPreviewRenderer::setInput(InputSource source, double sampleRate, const juce::AudioBuffer<float>* capturedInput)
+{
+    // Before prepareToPlay there is no rate to render at; queued jobs wait for one
+    if (sampleRate <= 0.0)
+    {
+        inputSource = InputSource::TestLoop;
+        inputSampleRate = 0.0;
+        const juce::ScopedLock sl(lock);
+        currentInput = nullptr;
+        return;
+    }
+
+    auto input = std::make_shared<Input>();
+    input->sampleRate = sampleRate;
+    int numSamples = static_cast<int>(sampleRate * PREVIEW_SECONDS);
+
+    if (source == InputSource::CapturedInput && capturedInput != nullptr && capturedInput->getNumSamples() >= numSamples)
+    {
+        // The last PREVIEW_SECONDS of the capture
+        int offset = capturedInput->getNumSamples() - numSamples;
+        input->audio.setSize(capturedInput->getNumChannels(), numSamples);
+        for (int ch = 0; ch < capturedInput->getNumChannels(); ++ch)
+            input->audio.copyFrom(ch, 0, *capturedInput, ch, offset, numSamples);
+    }
+    else
+    {
+        jassert(source == InputSource::TestLoop);
+        source = InputSource::TestLoop;
+        createTestLoop(input->audio, sampleRate);
+    }
+
+    input->hash = getAudioHash(input->audio, sampleRate);
+    inputSource = source;
+    inputSampleRate = sampleRate;
+
+    const juce::ScopedLock sl(lock);
+    currentInput = std::move(input);
+    notify();
+}
+
+void PresetPreviewRenderer::queueInBackground(const juce::Array<PresetInfo>& presets)
+{
+    const juce::ScopedLock sl(lock);
+
+    // The menu queues every preset each time it is rebuilt; a preset is only ever queued once
+    for (const auto& preset : presets)
+    {
+        auto identity = getPresetIdentity(preset);
+        if (queuedIdentities.insert(identity).second)
+            jobs.push_back({ preset, identity, false });
+    }
+
+    notify();
+}
+
+void PresetPreviewRenderer::request(const PresetInfo& preset)
+{
+    const juce::ScopedLock sl(lock);
+
+    // Only the latest request matters (the pointer moved on); earlier ones become background work
+    for (auto& job : jobs)
+        job.requested = false;
+
+    // A queued job of the same preset moves to the front
+    auto identity = getPresetIdentity(preset);
+    if (!queuedIdentities.insert(identity).second)
+        jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [&identity](const Job& job) { return job.identity == identity; }),
+                   jobs.end());
+
+    jobs.push_front({ preset, identity, true });
+    notify();
+}
+
+std::shared_ptr<const juce::AudioBuffer<float>> PresetPreviewRenderer::getPreview(const PresetInfo& preset)
+{
+    const juce::ScopedLock sl(lock);
+    auto identity = getPresetIdentity(preset);
+    auto it = memoryCache.find(identity);
+    if (it == memoryCache.end() || currentInput == nullptr || it->second.inputHash != currentInput->hash)
+        return nullptr;
+
+    // Most recently used last
+    memoryOrder.erase(std::remove(memoryOrder.begin(), memoryOrder.end(), identity), memoryOrder.end());
+    memoryOrder.push_back(identity);
+    return it->second.audio;
+}
+
+//==============================================================================
+void PresetPreviewRenderer::run()
+{
+    while (!threadShouldExit())
+    {
+        Job job;
+        std::shared_ptr<const Input> input;
+        {
+            const juce::ScopedLock sl(lock);
+            if (!jobs.empty() && currentInput != nullptr)
+            {
+                job = jobs.front();
+                jobs.pop_front();
+                queuedIdentities.erase(job.identity);
+                input = currentInput;
+            }
+        }
+
+        if (input == nullptr)
+            wait(-1);
+        else
+            process(job, input);
+    }
+
+    engine.reset();
+}
+
+void PresetPreviewRenderer::process(const Job& job, const std::shared_ptr<const Input>& input)
+{
+    if (job.requested && getPreview(job.preset) != nullptr)
+    {
+        sendChangeMessage();
+        return;
+    }
+
+    auto presetHash = getPresetHash(job.preset);
+    auto file = getCacheFile(job.identity, presetHash, input->hash);
+    if (!job.requested && file.existsAsFile())
+        return;
+
+    std::shared_ptr<juce::AudioBuffer<float>> preview = std::make_shared<juce::AudioBuffer<float>>();
+    if (readPreview(file, *preview))
+    {
+        file.setLastModificationTime(juce::Time::getCurrentTime());     // Recently used, for pruneDiskCache
+    }
+    else
+    {
+        auto rendered = render(job.preset, *input);
+        if (rendered == nullptr)
+            return;
+
+        preview = toMono(*rendered);
+
+        // A preview that could not be cached is still played; it is rendered again next time
+        if (writePreview(file, *preview))
+            pruneDiskCache(job.identity, presetHash);
+    }
+
+    if (!job.requested)
+        return;
+
+    keepInMemory(job.identity, input->hash, std::move(preview));
+    sendChangeMessage();
+}
+
+void PresetPreviewRenderer::keepInMemory(const juce::String& identity, juce::uint64 inputHash,
+                                         std::shared_ptr<const juce::AudioBuffer<float>> preview)
+{
+    const juce::ScopedLock sl(lock);
+    memoryCache[identity] = { inputHash, std::move(preview) };
+    memoryOrder.erase(std::remove(memoryOrder.begin(), memoryOrder.end(), identity), memoryOrder.end());
+    memoryOrder.push_back(identity);
+
+    while ((int) memoryOrder.size() > MAX_CACHED_IN_MEMORY)
+    {
+        memoryCache.erase(memoryOrder.front());
+        memoryOrder.pop_front();
+    }
+}
+
+std::unique_ptr<juce::AudioBuffer<float>> PresetPreviewRenderer::render(const PresetInfo& preset, const Input& input)
+{
+    if (engine == nullptr)
+        engine = std::make_unique<NanoStuttAudioProcessor>();
+
+    std::vector<float> values;
+    if (!engine->getPresetManager().readPresetValues(preset, engine->getParameterTable(), values))
+        return nullptr;
+
+    // Session parameters keep the engine's defaults, except that the preset has to stutter
+    int autoStutterIndex = engine->getParameterTable().indexOf("autoStutterEnabled");
+    if (autoStutterIndex >= 0)
+        values[(size_t) autoStutterIndex] = 1.0f;
+
+    PreviewPlayHead playHead;
+    playHead.sampleRate = input.sampleRate;
+
+    engine->setNonRealtime(true);
+    engine->setPlayHead(&playHead);
+    engine->setRateAndBufferSizeDetails(input.sampleRate, RENDER_BLOCK_SIZE);
+    engine->prepareToPlay(input.sampleRate, RENDER_BLOCK_SIZE);
+    engine->applyParameterValues(values);
+
+    int numChannels = engine->getTotalNumOutputChannels();
+    int numSamples = input.audio.getNumSamples();
+    auto output = std::make_unique<juce::AudioBuffer<float>>(numChannels, numSamples);
+    juce::AudioBuffer<float> block(numChannels, RENDER_BLOCK_SIZE);
+    juce::MidiBuffer midi;
+
+    for (int pos = 0; pos < numSamples; pos += RENDER_BLOCK_SIZE)
+    {
+        if (threadShouldExit())
+        {
+            output = nullptr;
+            break;
+        }
+
+        int blockSize = juce::jmin(RENDER_BLOCK_SIZE, numSamples - pos);
+        block.setSize(numChannels, blockSize, false, false, true);
+        for (int ch = 0; ch < numChannels; ++ch)
+            block.copyFrom(ch, 0, input.audio, juce::jmin(ch, input.audio.getNumChannels() - 1), pos, blockSize);
+
+        playHead.samplePosition = pos;
+        engine->processBlock(block, midi);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            output->copyFrom(ch, pos, block, ch, 0, blockSize);
+    }
+
+    engine->releaseResources();
+    engine->setPlayHead(nullptr);
+    return output;
+}
+
+//==============================================================================
+juce::String PresetPreviewRenderer::getPresetIdentity(const PresetInfo& preset)
+{
+    if (preset.filePath != juce::File())
+        return preset.filePath.getFullPathName();
+    return "factory:" + preset.category + "/" + preset.name;
+}
+
+juce::uint64 PresetPreviewRenderer::getPresetHash(const PresetInfo& preset)
+{
+    auto hash = hashBytes(&ENGINE_VERSION, sizeof(ENGINE_VERSION));
+
+    if (preset.isFactory)
+    {
+        // The packed record holds everything a render depends on
+        juce::SharedResourcePointer<FactoryPresetBank> factoryBank;
+        int recordSize = 0;
+        auto* record = factoryBank->getRecord(preset.factoryIndex, recordSize);
+        return hashBytes(record, (size_t) recordSize, hash);
+    }
+
+    auto text = preset.filePath.loadFileAsString();
+    auto utf8 = text.toRawUTF8();
+    return hashBytes(utf8, std::strlen(utf8), hash);
+}
+
+juce::uint64 PresetPreviewRenderer::getAudioHash(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    auto hash = hashBytes(&sampleRate, sizeof(sampleRate));
+    for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+        hash = hashBytes(audio.getReadPointer(ch), sizeof(float) * (size_t) audio.getNumSamples(), hash);
+    return hash;
+}
+
+void PresetPreviewRenderer::createTestLoop(juce::AudioBuffer<float>& dest, double sampleRate)
+{
+    // Two bars of kick (1, 3), snare (2, 4) and eighth-note hats; seeded so the hash is stable
+    int numSamples = static_cast<int>(sampleRate * PREVIEW_SECONDS);
+    int eighthLength = static_cast<int>(sampleRate * 30.0 / PREVIEW_BPM);
+    dest.setSize(2, numSamples);
+    dest.clear();
+
+    juce::Random random(0x4e53);
+    auto* left = dest.getWritePointer(0);
+
+    for (int eighth = 0; eighth * eighthLength < numSamples; ++eighth)
+    {
+        int start = eighth * eighthLength;
+        int length = juce::jmin(eighthLength, numSamples - start);
+        bool kick = eighth % 4 == 0;
+        bool snare = eighth % 4 == 2;
+        double phase = 0.0;
+        float previousNoise = 0.0f;
+
+        for (int i = 0; i < length; ++i)
+        {
+            double t = i / sampleRate;
+            float noise = random.nextFloat() * 2.0f - 1.0f;
+            float sample = 0.25f * (noise - previousNoise) * static_cast<float>(std::exp(-t / 0.03));  // Hat
+            previousNoise = noise;
+
+            if (kick)
+            {
+                double frequency = 45.0 + 75.0 * std::exp(-t / 0.04);
+                phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+                sample += 0.8f * static_cast<float>(std::sin(phase) * std::exp(-t / 0.25));
+            }
+            else if (snare)
+            {
+                double body = std::sin(juce::MathConstants<double>::twoPi * 180.0 * t);
+                sample += static_cast<float>((0.3 * body + 0.4 * noise) * std::exp(-t / 0.12));
+            }
+
+            left[start + i] = 0.6f * sample;
+        }
+    }
+
+    dest.copyFrom(1, 0, dest, 0, 0, numSamples);
+}
+
+//==============================================================================
+juce::File PresetPreviewRenderer::getCacheFile(const juce::String& identity, juce::uint64 presetHash, juce::uint64 inputHash) const
+{
+    auto identityHash = hashBytes(identity.toRawUTF8(), identity.getNumBytesAsUTF8());
+    return cacheDirectory.getChildFile(toHex(identityHash) + "_" + toHex(presetHash) + "_" + toHex(inputHash) + ".nspv");
+}
+
+void PresetPreviewRenderer::pruneDiskCache(const juce::String& identity, juce::uint64 presetHash)
+{
+    // Previews of an older version of this preset (and files from before the current naming) are stale
+    auto prefix = getCacheFile(identity, presetHash, 0).getFileName().upToLastOccurrenceOf("_", true, false);
+    auto identityPrefix = prefix.upToFirstOccurrenceOf("_", true, false);
+
+    std::vector<juce::File> kept;
+    juce::int64 totalBytes = 0;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(cacheDirectory, false, "*.nspv"))
+    {
+        auto file = entry.getFile();
+        auto name = file.getFileName();
+        bool stale = juce::StringArray::fromTokens(file.getFileNameWithoutExtension(), "_", "").size() != 3
+                     || (name.startsWith(identityPrefix) && !name.startsWith(prefix));
+
+        if (stale)
+        {
+            file.deleteFile();
+        }
+        else
+        {
+            kept.push_back(file);
+            totalBytes += entry.getFileSize();
+        }
+    }
+
+    if (totalBytes <= MAX_DISK_CACHE_BYTES)
+        return;
+
+    // Least recently used first (reads touch their file)
+    std::sort(kept.begin(), kept.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    for (const auto& file : kept)
+    {
+        if (totalBytes <= MAX_DISK_CACHE_BYTES)
+            break;
+
+        totalBytes -= file.getSize();
+        file.deleteFile();
+    }
+}
+
+bool PresetPreviewRenderer::readPreview(const juce::File& file, juce::AudioBuffer<float>& dest)
+{
+    juce::FileInputStream input(file);
+    if (!input.openedOk())
+        return false;
+
+    if (input.readInt() != PREVIEW_MAGIC || input.readInt() != PREVIEW_VERSION)
+        return false;
+
+    int numSamples = input.readInt();
+    if (numSamples <= 0 || input.getNumBytesRemaining() != (juce::int64) (sizeof(juce::int16) * (size_t) numSamples))
+        return false;
+
+    // Native 16-bit layout: the cache never leaves this machine
+    juce::HeapBlock<juce::int16> samples((size_t) numSamples);
+    input.read(samples.get(), (int) (sizeof(juce::int16) * (size_t) numSamples));
+
+    dest.setSize(1, numSamples);
+    auto* data = dest.getWritePointer(0);
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = samples[i] / 32767.0f;
+
+    return true;
+}
+
+bool PresetPreviewRenderer::writePreview(const juce::File& file, const juce::AudioBuffer<float>& preview)
+{
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream output(temp.getFile());
+        if (!output.openedOk())
+            return false;
+
+        int numSamples = preview.getNumSamples();
+        juce::HeapBlock<juce::int16> samples((size_t) numSamples);
+        auto* data = preview.getReadPointer(0);
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = static_cast<juce::int16>(juce::roundToInt(juce::jlimit(-1.0f, 1.0f, data[i]) * 32767.0f));
+
+        output.writeInt(PREVIEW_MAGIC);
+        output.writeInt(PREVIEW_VERSION);
+        output.writeInt(numSamples);
+        if (!output.write(samples.get(), sizeof(juce::int16) * (size_t) numSamples))
+            return false;
+
+        output.flush();
+        if (output.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
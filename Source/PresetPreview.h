@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    PresetPreview.h
+    Background-rendered preset previews for the preset browser
+
+    Presets are rendered by an offline engine instance (a second
+    NanoStuttAudioProcessor that never touches the live one) on a
+    low-priority worker thread, over either a fixed test loop or the last
+    seconds of the track's input (see PresetPreviewAudio.h). Previews are
+    cached on disk in the user preset folder as mono 16-bit files, keyed by
+    the preset, a hash of its contents and a hash of the input, so each
+    combination is rendered only once. Previews of an edited preset are
+    deleted when it is rendered again, and the oldest previews go once the
+    folder outgrows MAX_DISK_CACHE_BYTES.
+
+    The editor queues every preset in the background when it opens and
+    asks for the hovered preset first; finished previews of requested
+    presets are kept in memory and announced with a change message.
+
+    Previews use the preset's parameters (auto stutter forced on, 120 BPM);
+    its rate matrix and pattern script are not applied.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include "PresetManager.h"
+
+class NanoStuttAudioProcessor;
+
+class PresetPreviewRenderer : public juce::ChangeBroadcaster,
+                              private juce::Thread
+{
+public:
+    enum class InputSource { TestLoop, CapturedInput };
+
+    static constexpr double PREVIEW_BPM = 120.0;
+    static constexpr double PREVIEW_SECONDS = 4.0;         // Two bars at PREVIEW_BPM
+    static constexpr int RENDER_BLOCK_SIZE = 512;
+    static constexpr int MAX_CACHED_IN_MEMORY = 16;
+    static constexpr juce::int64 MAX_DISK_CACHE_BYTES = 64 * 1024 * 1024;
+
+    // A sample rate of 0 (not known yet) renders nothing until setInput gives one
+    explicit PresetPreviewRenderer(double sampleRate);
+    ~PresetPreviewRenderer() override;
+
+    /**
+        Message thread: sets what previews are rendered over, at the live sample
+        rate. Captured input is the last seconds of the track (at least
+        PREVIEW_SECONDS); previews of the previous input are not used any more.
+        The sample rate is part of the input, so previews rendered at another
+        rate are never returned.
+    */
+    void setInput(InputSource source, double sampleRate, const juce::AudioBuffer<float>* capturedInput = nullptr);
+
+    InputSource getInputSource() const { return inputSource; }
+    double getSampleRate() const { return inputSampleRate; }
+
+    /**
+        Queues presets to be rendered to the disk cache in the background
+        (presets already queued, or cached for the current input, are skipped).
+    */
+    void queueInBackground(const juce::Array<PresetInfo>& presets);
+
+    /**
+        Asks for a preview to be available in memory, ahead of background work.
+        A change message is sent when it is.
+    */
+    void request(const PresetInfo& preset);
+
+    /**
+        Returns the (mono) preview of preset for the current input if it is in memory.
+    */
+    std::shared_ptr<const juce::AudioBuffer<float>> getPreview(const PresetInfo& preset);
+
+private:
+    struct Job
+    {
+        PresetInfo preset;
+        juce::String identity;
+        bool requested = false;     // Keep the result in memory and announce it
+    };
+
+    struct Input
+    {
+        juce::AudioBuffer<float> audio;
+        double sampleRate = 44100.0;
+        juce::uint64 hash = 0;
+    };
+
+    void run() override;
+    void process(const Job& job, const std::shared_ptr<const Input>& input);
+    std::unique_ptr<juce::AudioBuffer<float>> render(const PresetInfo& preset, const Input& input);
+    void keepInMemory(const juce::String& identity, juce::uint64 inputHash, std::shared_ptr<const juce::AudioBuffer<float>> preview);
+
+    // Identifies a preset within the session (file, or factory category and name)
+    static juce::String getPresetIdentity(const PresetInfo& preset);
+    static juce::uint64 getPresetHash(const PresetInfo& preset);
+    static juce::uint64 getAudioHash(const juce::AudioBuffer<float>& audio, double sampleRate);
+    static void createTestLoop(juce::AudioBuffer<float>& dest, double sampleRate);
+
+    // Cache files are named <identity hash>_<preset hash>_<input hash>.nspv
+    juce::File getCacheFile(const juce::String& identity, juce::uint64 presetHash, juce::uint64 inputHash) const;
+    void pruneDiskCache(const juce::String& identity, juce::uint64 presetHash);
+    static bool readPreview(const juce::File& file, juce::AudioBuffer<float>& dest);
+    static bool writePreview(const juce::File& file, const juce::AudioBuffer<float>& preview);     // False if nothing was cached
+
+    //==========================================================================
+    juce::File cacheDirectory;
+    InputSource inputSource = InputSource::TestLoop;
+    double inputSampleRate = 0.0;
+
+    juce::CriticalSection lock;                             // Guards everything below
+    std::shared_ptr<const Input> currentInput;
+    std::deque<Job> jobs;
+    std::set<juce::String> queuedIdentities;                // Presets in jobs
+    struct CachedPreview
+    {
+        juce::uint64 inputHash;
+        std::shared_ptr<const juce::AudioBuffer<float>> audio;
+    };
+    std::map<juce::String, CachedPreview> memoryCache;     // Identity -> preview
+    std::deque<juce::String> memoryOrder;                   // Least recently used first
+
+    std::unique_ptr<NanoStuttAudioProcessor> engine;        // Worker thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetPreviewRenderer)
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    PresetPreviewAudio.h
+    Audio-thread side of preset previews (see PresetPreview.h)
+
+    - PreviewInputHistory keeps the last few seconds of the track's input
+      while an editor is open, so previews can be rendered over the user's
+      own material
+    - PreviewPlayer plays a rendered preview in place of the live output
+      while a preset is hovered, with short fades in and out; the processor
+      only lets it be heard while the transport is stopped in real time
+
+    Both preallocate in prepare(); the message thread copies in or out
+    under a SpinLock the audio thread only try-locks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+class PreviewInputHistory
+{
+public:
+    static constexpr double HISTORY_SECONDS = 4.0;
+
+    // Message thread (prepareToPlay)
+    void prepare(double sampleRate, int numChannels)
+    {
+        const juce::SpinLock::ScopedLockType lock(historyLock);
+        history.setSize(numChannels, juce::jmax(1, static_cast<int>(sampleRate * HISTORY_SECONDS)));
+        history.clear();
+        writePos = 0;
+        numWritten = 0;
+    }
+
+    // Audio thread; a block that arrives while the history is being copied is skipped
+    void push(const juce::AudioBuffer<float>& input, int numSamples)
+    {
+        const juce::SpinLock::ScopedTryLockType lock(historyLock);
+        if (!lock.isLocked())
+            return;
+
+        int size = history.getNumSamples();
+        numSamples = juce::jmin(numSamples, size);
+        int numChannels = juce::jmin(history.getNumChannels(), input.getNumChannels());
+        int size1 = juce::jmin(numSamples, size - writePos);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            history.copyFrom(ch, writePos, input, ch, 0, size1);
+            if (size1 < numSamples)
+                history.copyFrom(ch, 0, input, ch, size1, numSamples - size1);
+        }
+
+        writePos = (writePos + numSamples) % size;
+        numWritten = juce::jmin(size, numWritten + numSamples);
+    }
+
+    /**
+        Message thread: copies the history, oldest sample first, into dest.
+
+        @return     False until the history has been filled once
+    */
+    bool copyTo(juce::AudioBuffer<float>& dest)
+    {
+        const juce::SpinLock::ScopedLockType lock(historyLock);
+        int size = history.getNumSamples();
+        if (numWritten < size)
+            return false;
+
+        dest.setSize(history.getNumChannels(), size);
+        for (int ch = 0; ch < history.getNumChannels(); ++ch)
+        {
+            dest.copyFrom(ch, 0, history, ch, writePos, size - writePos);
+            dest.copyFrom(ch, size - writePos, history, ch, 0, writePos);
+        }
+        return true;
+    }
+
+private:
+    juce::SpinLock historyLock;
+    juce::AudioBuffer<float> history;
+    int writePos = 0;
+    int numWritten = 0;
+};
+
+//==============================================================================
+class PreviewPlayer
+{
+public:
+    static constexpr double MAX_PREVIEW_SECONDS = 8.0;
+    static constexpr double FADE_SECONDS = 0.01;
+
+    // Message thread (prepareToPlay)
+    void prepare(double sampleRate, int numChannels)
+    {
+        const juce::SpinLock::ScopedLockType lock(playerLock);
+        preview.setSize(numChannels, static_cast<int>(sampleRate * MAX_PREVIEW_SECONDS));
+        length = 0;
+        playPos = 0;
+        gain = 0.0f;
+        gainStep = static_cast<float>(1.0 / juce::jmax(1.0, sampleRate * FADE_SECONDS));
+        playing.store(false);
+    }
+
+    // Message thread: starts looping source (rendered at the current sample rate)
+    void play(const juce::AudioBuffer<float>& source)
+    {
+        const juce::SpinLock::ScopedLockType lock(playerLock);
+        length = juce::jmin(source.getNumSamples(), preview.getNumSamples());
+        if (length == 0)
+            return;
+
+        for (int ch = 0; ch < preview.getNumChannels(); ++ch)
+            preview.copyFrom(ch, 0, source, juce::jmin(ch, source.getNumChannels() - 1), 0, length);
+
+        playPos = 0;
+        playing.store(true);
+    }
+
+    // Any thread: fades back to the live output
+    void stop() { playing.store(false); }
+
+    /**
+        Audio thread: crossfades output towards the preview while playing.
+
+        @param audible      False fades back to the live output (e.g. once the transport starts)
+                            without stopping the preview
+    */
+    void process(juce::AudioBuffer<float>& output, bool audible)
+    {
+        bool target = audible && playing.load(std::memory_order_relaxed);
+        if (!target && gain <= 0.0f)
+            return;
+
+        const juce::SpinLock::ScopedTryLockType lock(playerLock);
+        if (!lock.isLocked() || length == 0)
+            return;
+
+        float targetGain = target ? 1.0f : 0.0f;
+        int numChannels = juce::jmin(output.getNumChannels(), preview.getNumChannels());
+
+        for (int i = 0; i < output.getNumSamples(); ++i)
+        {
+            gain = targetGain > gain ? juce::jmin(targetGain, gain + gainStep) : juce::jmax(targetGain, gain - gainStep);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float* data = output.getWritePointer(ch);
+                data[i] += gain * (preview.getSample(ch, playPos) - data[i]);
+            }
+
+            playPos = (playPos + 1) % length;
+        }
+    }
+
+private:
+    juce::SpinLock playerLock;
+    juce::AudioBuffer<float> preview;
+    int length = 0;
+    int playPos = 0;
+    float gain = 0.0f;                  // Audio thread
+    float gainStep = 0.0f;
+    std::atomic<bool> playing { false };
+};
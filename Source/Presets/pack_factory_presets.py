@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Packs the factory preset XML files in this folder into FactoryPresets.bin,
+the single resource the plugin embeds (see Source/FactoryPresetBank.h for
+the layout). Rerun after adding or editing a factory preset:
+
+    python3 Source/Presets/pack_factory_presets.py
+
+Values and strings are written the way juce::OutputStream writes them
+(little-endian, UTF-8 strings with a terminating zero), so the plugin reads
+the pack with plain MemoryInputStream calls.
+"""
+
+import pathlib
+import struct
+import sys
+import xml.etree.ElementTree as ElementTree
+
+MAGIC = 0x3146534E          # "NSF1"
+VERSION = 1
+STATE_TYPE = "PARAMETERS"   # APVTS state type (PluginProcessor.cpp)
+VAR_MARKER_STRING = 5       # juce::var stream marker for strings
+
+PRESETS_DIR = pathlib.Path(__file__).resolve().parent
+OUTPUT = PRESETS_DIR / "FactoryPresets.bin"
+
+
+def write_int(out, value):
+    out += struct.pack("<i", value)
+
+
+def write_float(out, value):
+    out += struct.pack("<f", value)
+
+
+def write_compressed_int(out, value):
+    magnitude = abs(value)
+    data = bytearray()
+    while magnitude > 0:
+        data.append(magnitude & 0xFF)
+        magnitude >>= 8
+    out.append(len(data) | (0x80 if value < 0 else 0))
+    out += data
+
+
+def write_string(out, text):
+    out += text.encode("utf-8") + b"\0"
+
+
+def write_value_tree(out, element):
+    # XML attributes become string properties, as juce::ValueTree::fromXml makes them
+    write_string(out, element.tag)
+    write_compressed_int(out, len(element.attrib))
+    for name, value in element.attrib.items():
+        write_string(out, name)
+        encoded = value.encode("utf-8") + b"\0"
+        write_compressed_int(out, len(encoded) + 1)
+        out.append(VAR_MARKER_STRING)
+        out += encoded
+    write_compressed_int(out, len(element))
+    for child in element:
+        write_value_tree(out, child)
+
+
+def pack_record(path, state):
+    params = [child for child in state if child.tag == "PARAM" and "id" in child.attrib and "value" in child.attrib]
+    extra = ElementTree.Element("EXTRA")
+    extra.extend(child for child in state if child.tag != "PARAM")
+
+    record = bytearray()
+    write_compressed_int(record, len(params))
+    for param in params:
+        write_string(record, param.attrib["id"])
+    for param in params:
+        try:
+            write_float(record, float(param.attrib["value"]))
+        except ValueError:
+            sys.exit(f"{path}: PARAM {param.attrib['id']} has a non-numeric value")
+    write_value_tree(record, extra)
+    return record
+
+
+def main():
+    index = bytearray()
+    records = bytearray()
+    files = sorted(PRESETS_DIR.glob("*/*.xml"))
+
+    for path in files:
+        root = ElementTree.parse(path).getroot()
+        metadata = root.find("METADATA")
+        state = root.find(STATE_TYPE)
+        if root.tag != "NANOSTUTT_PRESET" or metadata is None or state is None:
+            sys.exit(f"{path}: expected NANOSTUTT_PRESET with METADATA and {STATE_TYPE}")
+
+        record = pack_record(path, state)
+
+        write_string(index, metadata.get("name", "Untitled"))
+        write_string(index, metadata.get("category", "Uncategorized"))
+        write_string(index, metadata.get("author", "Unknown"))
+        write_string(index, metadata.get("creationDate", ""))
+        write_string(index, metadata.get("description", ""))
+        write_string(index, metadata.get("tags", ""))
+        write_int(index, len(records))
+        write_int(index, len(record))
+        records += record
+
+    output = bytearray()
+    write_int(output, MAGIC)
+    write_int(output, VERSION)
+    write_compressed_int(output, len(files))
+    output += index + records
+
+    OUTPUT.write_bytes(output)
+    print(f"Packed {len(files)} presets into {OUTPUT.name} ({len(output)} bytes)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,346 @@
+/*
+  ==============================================================================
+
+    RateMarkovChain.h
+    Markov-chain rate selection for the auto stutter engine
+
+    Draws the next stutter rate conditioned on the previously played one.
+    The 25 slots cover both rate systems:
+    - Slots 0-12:  regular repeat rates (same order as regularDenominators)
+    - Slots 13-24: nano rates 0-11
+
+    The transition matrix holds relative affinities (1.0 = neutral) that are
+    multiplied onto the existing probability sliders, so the per-rate weights,
+    active flags and the Repeat/Nano blend keep working in Markov mode.
+    Each row is compiled into a Vose alias table for O(1) sampling.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+class RateMarkovChain
+{
+public:
+    static constexpr int NUM_REGULAR_SLOTS = 13;
+    static constexpr int NUM_NANO_SLOTS = 12;
+    static constexpr int NUM_SLOTS = NUM_REGULAR_SLOTS + NUM_NANO_SLOTS;
+    static constexpr int NO_PREVIOUS_SLOT = -1;
+
+    // MIDI notes at or above this pitch are learned as nano slots (pitch class = nano index)
+    static constexpr int NANO_LEARN_LOWEST_NOTE = 72;  // C5
+
+    RateMarkovChain() { resetToUniform(); }
+
+    //==========================================================================
+    // Slot helpers
+
+    static bool isNanoSlot(int slot) { return slot >= NUM_REGULAR_SLOTS; }
+    static int toSystemIndex(int slot) { return isNanoSlot(slot) ? slot - NUM_REGULAR_SLOTS : slot; }
+    static int toSlot(bool isNano, int systemIndex) { return isNano ? NUM_REGULAR_SLOTS + systemIndex : systemIndex; }
+
+    //==========================================================================
+    // Matrix editing (message thread)
+
+    void resetToUniform()
+    {
+        for (auto& row : matrix)
+            for (auto& cell : row)
+                cell.store(1.0f, std::memory_order_relaxed);
+    }
+
+    void setTransition(int fromSlot, int toSlot, float affinity)
+    {
+        if (juce::isPositiveAndBelow(fromSlot, NUM_SLOTS) && juce::isPositiveAndBelow(toSlot, NUM_SLOTS))
+            matrix[fromSlot][toSlot].store(juce::jmax(0.0f, affinity), std::memory_order_relaxed);
+    }
+
+    float getTransition(int fromSlot, int toSlot) const
+    {
+        if (juce::isPositiveAndBelow(fromSlot, NUM_SLOTS) && juce::isPositiveAndBelow(toSlot, NUM_SLOTS))
+            return matrix[fromSlot][toSlot].load(std::memory_order_relaxed);
+        return 1.0f;
+    }
+
+    /**
+        Learns the matrix from a played sequence of slots.
+        Rows are normalised so that their mean affinity is 1.0; rows that never
+        occur in the sequence stay neutral. Smoothing keeps unseen transitions possible.
+    */
+    void learnFromSequence(const std::vector<int>& slots, float smoothing = 0.05f)
+    {
+        std::array<std::array<float, NUM_SLOTS>, NUM_SLOTS> counts {};
+        std::array<float, NUM_SLOTS> rowTotals {};
+
+        for (size_t i = 1; i < slots.size(); ++i)
+        {
+            int from = slots[i - 1];
+            int to = slots[i];
+            if (juce::isPositiveAndBelow(from, NUM_SLOTS) && juce::isPositiveAndBelow(to, NUM_SLOTS))
+            {
+                counts[from][to] += 1.0f;
+                rowTotals[from] += 1.0f;
+            }
+        }
+
+        for (int from = 0; from < NUM_SLOTS; ++from)
+        {
+            for (int to = 0; to < NUM_SLOTS; ++to)
+            {
+                float affinity = 1.0f;
+                if (rowTotals[from] > 0.0f)
+                    affinity = (counts[from][to] + smoothing) * NUM_SLOTS / (rowTotals[from] + smoothing * NUM_SLOTS);
+                matrix[from][to].store(affinity, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+        Learns the matrix from a MIDI file.
+        Notes below NANO_LEARN_LOWEST_NOTE map to the regular rate whose length is
+        closest to the time until the next note; higher notes map to the nano slot
+        of their pitch class.
+
+        @return     True if at least one transition was learned
+    */
+    bool learnFromMidiFile(const juce::File& file, const std::array<double, NUM_REGULAR_SLOTS>& regularDenominators)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midiFile;
+
+        if (!stream.openedOk() || !midiFile.readFrom(stream))
+            return false;
+
+        int ticksPerQuarter = midiFile.getTimeFormat();
+        if (ticksPerQuarter <= 0)
+            return false;  // SMPTE timing is not supported
+
+        // Merge note-ons from all tracks
+        juce::MidiMessageSequence merged;
+        for (int t = 0; t < midiFile.getNumTracks(); ++t)
+            merged.addSequence(*midiFile.getTrack(t), 0.0);
+        merged.sort();
+
+        std::vector<std::pair<double, int>> noteOns;
+        for (auto* event : merged)
+            if (event->message.isNoteOn())
+                noteOns.emplace_back(event->message.getTimeStamp(), event->message.getNoteNumber());
+
+        std::vector<int> slots;
+        for (size_t i = 0; i < noteOns.size(); ++i)
+        {
+            int note = noteOns[i].second;
+            if (note >= NANO_LEARN_LOWEST_NOTE)
+            {
+                slots.push_back(toSlot(true, note % 12));
+                continue;
+            }
+
+            if (i + 1 >= noteOns.size())
+                break;
+
+            double wholeNotes = (noteOns[i + 1].first - noteOns[i].first) / (ticksPerQuarter * 4.0);
+            if (wholeNotes <= 0.0)
+                continue;  // Chord - only the last note of a cluster defines the interval
+
+            // Nearest regular rate in the log domain
+            int best = 0;
+            double bestDistance = std::numeric_limits<double>::max();
+            for (int r = 0; r < NUM_REGULAR_SLOTS; ++r)
+            {
+                double distance = std::abs(std::log2(wholeNotes * regularDenominators[r]));
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = r;
+                }
+            }
+            slots.push_back(best);
+        }
+
+        if (slots.size() < 2)
+            return false;
+
+        learnFromSequence(slots);
+        return true;
+    }
+
+    //==========================================================================
+    // Compilation (allocation-free, may run on any thread)
+
+    /**
+        Rebuilds the alias tables from the matrix and the current slider weights.
+        strength blends each row between neutral (0.0) and the full matrix (1.0).
+    */
+    void compile(const std::array<float, NUM_REGULAR_SLOTS>& regularWeights,
+                 const std::array<float, NUM_NANO_SLOTS>& nanoWeights,
+                 float nanoBlend, float strength)
+    {
+        const auto ticket = compileTicket.fetch_add(1) + 1;
+
+        // Base distribution mirrors independent selection: system by blend, rate by weight.
+        // An empty system falls back to its first rate, like selectWeightedIndex does.
+        std::array<float, NUM_SLOTS> base {};
+        float regularTotal = std::accumulate(regularWeights.begin(), regularWeights.end(), 0.0f);
+        float nanoTotal = std::accumulate(nanoWeights.begin(), nanoWeights.end(), 0.0f);
+
+        for (int r = 0; r < NUM_REGULAR_SLOTS; ++r)
+            base[r] = regularTotal > 0.0f ? (1.0f - nanoBlend) * regularWeights[r] / regularTotal : 0.0f;
+        if (regularTotal <= 0.0f)
+            base[0] = 1.0f - nanoBlend;
+
+        for (int n = 0; n < NUM_NANO_SLOTS; ++n)
+            base[NUM_REGULAR_SLOTS + n] = nanoTotal > 0.0f ? nanoBlend * nanoWeights[n] / nanoTotal : 0.0f;
+        if (nanoTotal <= 0.0f)
+            base[NUM_REGULAR_SLOTS] = nanoBlend;
+
+        AliasTables scratch;
+        std::array<float, NUM_SLOTS> rowWeights;
+
+        for (int row = 0; row < NUM_ROWS; ++row)
+        {
+            for (int col = 0; col < NUM_SLOTS; ++col)
+            {
+                // The extra start row (no previous event) uses the base distribution
+                float affinity = (row < NUM_SLOTS) ? matrix[row][col].load(std::memory_order_relaxed) : 1.0f;
+                rowWeights[col] = base[col] * ((1.0f - strength) + strength * affinity);
+            }
+            buildAliasRow(rowWeights, scratch.probability[row], scratch.alias[row], scratch.valid[row]);
+        }
+
+        // Publish unless a compile that started later has already published
+        const juce::SpinLock::ScopedLockType lock(tableLock);
+        if (ticket > publishedTicket)
+        {
+            tables = scratch;
+            publishedTicket = ticket;
+        }
+    }
+
+    //==========================================================================
+    // Sampling (audio thread)
+
+    /**
+        Draws the next slot given the previous one in O(1).
+        Returns NO_PREVIOUS_SLOT if the tables are being swapped or the row is empty;
+        the caller then falls back to independent selection.
+    */
+    int sampleNext(int previousSlot, juce::Random& random) const
+    {
+        const juce::SpinLock::ScopedTryLockType lock(tableLock);
+        if (!lock.isLocked())
+            return NO_PREVIOUS_SLOT;
+
+        int row = juce::isPositiveAndBelow(previousSlot, NUM_SLOTS) ? previousSlot : START_ROW;
+        if (!tables.valid[row])
+            return NO_PREVIOUS_SLOT;
+
+        float u = random.nextFloat() * NUM_SLOTS;
+        int column = juce::jmin(static_cast<int>(u), NUM_SLOTS - 1);
+        return (u - column) < tables.probability[row][column] ? column : tables.alias[row][column];
+    }
+
+    //==========================================================================
+    // Serialization (stored as a child of the APVTS state so presets carry it)
+
+    static inline const juce::Identifier stateType { "RATE_TRANSITIONS" };
+
+    juce::ValueTree toValueTree() const
+    {
+        juce::StringArray values;
+        for (const auto& row : matrix)
+            for (const auto& cell : row)
+                values.add(juce::String(cell.load(std::memory_order_relaxed), 4));
+
+        juce::ValueTree tree(stateType);
+        tree.setProperty("matrix", values.joinIntoString(" "), nullptr);
+        return tree;
+    }
+
+    void fromValueTree(const juce::ValueTree& tree)
+    {
+        resetToUniform();
+
+        if (!tree.isValid() || !tree.hasType(stateType))
+            return;
+
+        auto values = juce::StringArray::fromTokens(tree.getProperty("matrix").toString(), " ", "");
+        if (values.size() != NUM_SLOTS * NUM_SLOTS)
+            return;
+
+        for (int i = 0; i < values.size(); ++i)
+            matrix[i / NUM_SLOTS][i % NUM_SLOTS].store(juce::jmax(0.0f, values[i].getFloatValue()), std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int START_ROW = NUM_SLOTS;
+    static constexpr int NUM_ROWS = NUM_SLOTS + 1;
+
+    struct AliasTables
+    {
+        std::array<std::array<float, NUM_SLOTS>, NUM_ROWS> probability {};
+        std::array<std::array<int, NUM_SLOTS>, NUM_ROWS> alias {};
+        std::array<bool, NUM_ROWS> valid {};
+    };
+
+    // Vose's alias method with fixed-size worklists
+    static void buildAliasRow(const std::array<float, NUM_SLOTS>& weights,
+                              std::array<float, NUM_SLOTS>& probability,
+                              std::array<int, NUM_SLOTS>& alias,
+                              bool& valid)
+    {
+        float total = std::accumulate(weights.begin(), weights.end(), 0.0f);
+        valid = total > 0.0f;
+        if (!valid)
+            return;
+
+        std::array<float, NUM_SLOTS> scaled;
+        std::array<int, NUM_SLOTS> small, large;
+        int numSmall = 0, numLarge = 0;
+
+        for (int i = 0; i < NUM_SLOTS; ++i)
+        {
+            scaled[i] = weights[i] * NUM_SLOTS / total;
+            alias[i] = i;
+            if (scaled[i] < 1.0f)
+                small[numSmall++] = i;
+            else
+                large[numLarge++] = i;
+        }
+
+        while (numSmall > 0 && numLarge > 0)
+        {
+            int s = small[--numSmall];
+            int l = large[--numLarge];
+            probability[s] = scaled[s];
+            alias[s] = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0f;
+            if (scaled[l] < 1.0f)
+                small[numSmall++] = l;
+            else
+                large[numLarge++] = l;
+        }
+
+        // Leftovers are 1.0 up to rounding error
+        while (numLarge > 0)
+            probability[large[--numLarge]] = 1.0f;
+        while (numSmall > 0)
+            probability[small[--numSmall]] = 1.0f;
+    }
+
+    std::array<std::array<std::atomic<float>, NUM_SLOTS>, NUM_SLOTS> matrix;
+
+    AliasTables tables;
+    mutable juce::SpinLock tableLock;
+    std::atomic<juce::uint32> compileTicket {0};
+    juce::uint32 publishedTicket = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RateMarkovChain)
+};
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    RefreshCoordinator.h
+    Single vsync-driven refresh driver for the editor
+
+    One juce::VBlankAttachment on the editor replaces the per-component 30 Hz
+    timers. Each frame the coordinator captures one DisplayState from the
+    processor and hands it to every client; clients compare it against what
+    they last displayed and repaint only when it changed.
+
+    No vblank callbacks arrive while the editor has no peer, and frames are
+    skipped while it is not showing (closed, hidden or minimised), so idle
+    editors do no work.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/** Processor state shown by the editor, captured once per frame.
+    The audio side is the processor's last published UiSnapshot, so every
+    client sees values from the same block. */
+struct DisplayState : UiSnapshot
+{
+    bool autoStutterEnabled = false;
+
+    /** @param autoStutterEnabledParam  The processor's "autoStutterEnabled" value, looked up once by the caller */
+    static DisplayState capture(NanoStuttAudioProcessor& processor, const std::atomic<float>& autoStutterEnabledParam)
+    {
+        DisplayState state;
+        static_cast<UiSnapshot&>(state) = processor.getUiSnapshot();
+        state.autoStutterEnabled = autoStutterEnabledParam.load() > 0.5f;
+        return state;
+    }
+};
+
+//==============================================================================
+/** Component refreshed by the coordinator. */
+class RefreshClient
+{
+public:
+    virtual ~RefreshClient() = default;
+
+    /** Called once per frame; repaint only if the displayed state changed. */
+    virtual void refresh(const DisplayState& state) = 0;
+};
+
+//==============================================================================
+class RefreshCoordinator
+{
+public:
+    RefreshCoordinator(juce::Component& editorToWatch, NanoStuttAudioProcessor& p)
+        : editor(editorToWatch), processor(p)
+    {
+    }
+
+    void addClient(RefreshClient* client) { clients.addIfNotAlreadyThere(client); }
+    void removeClient(RefreshClient* client) { clients.removeFirstMatchingValue(client); }
+
+private:
+    // Caps the refresh rate near the old 30 Hz timers on fast displays
+    static constexpr double MIN_FRAME_INTERVAL_MS = 25.0;
+
+    void onVBlank()
+    {
+        if (!editor.isShowing())
+            return;
+
+        double nowMs = juce::Time::getMillisecondCounterHiRes();
+        if (nowMs - lastFrameMs < MIN_FRAME_INTERVAL_MS)
+            return;
+        lastFrameMs = nowMs;
+
+        auto state = DisplayState::capture(processor, autoStutterEnabledParam);
+        for (auto* client : clients)
+            client->refresh(state);
+    }
+
+    juce::Component& editor;
+    NanoStuttAudioProcessor& processor;
+    const std::atomic<float>& autoStutterEnabledParam { *processor.getParameters().getRawParameterValue("autoStutterEnabled") };
+    juce::Array<RefreshClient*> clients;
+    double lastFrameMs = 0.0;
+
+    // Declared last: destroyed first, so no callback can arrive during destruction
+    juce::VBlankAttachment vblankAttachment { &editor, [this] { onVBlank(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RefreshCoordinator)
+};
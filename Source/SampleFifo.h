@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    SampleFifo.h
+    Lock-free mono sample FIFO from the audio thread to an analysis thread
+
+    Single producer (audio thread, one push per block), single consumer.
+    When the consumer falls behind, the samples that do not fit are dropped;
+    analysers only lose a little history.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+class SampleFifo
+{
+public:
+    static constexpr int CAPACITY = 16384;
+
+    // Audio thread
+    void push(const float* samples, int numSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        if (size1 > 0)
+            std::copy(samples, samples + size1, buffer.begin() + start1);
+        if (size2 > 0)
+            std::copy(samples + size1, samples + size1 + size2, buffer.begin() + start2);
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    // Consumer: copies up to maxSamples into dest, returns the number read
+    int pop(float* dest, int maxSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+        if (size1 > 0)
+            std::copy(buffer.begin() + start1, buffer.begin() + start1 + size1, dest);
+        if (size2 > 0)
+            std::copy(buffer.begin() + start2, buffer.begin() + start2 + size2, dest + size1);
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    juce::AbstractFifo fifo { CAPACITY };
+    std::array<float, CAPACITY> buffer {};
+};
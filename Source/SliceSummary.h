@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    SliceSummary.h
+    Min/max summary of the captured stutter slice, for the slice thumbnail
+
+    When an event starts, the processor starts a SliceSummaryBuilder on the
+    region of stutterBuffer that the event loops. The region is still being
+    recorded at that point, so the builder summarises it a few points at a
+    time as audio arrives, at most MAX_SAMPLES_PER_BLOCK samples per block,
+    and never produces a spike at the event start. The finished summary is
+    handed to the editor through a SliceSummaryQueue.
+
+    Single producer (audio thread), single consumer (message thread).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+struct SliceSummary
+{
+    static constexpr int MAX_POINTS = 256;
+
+    juce::uint32 eventId = 0;           // Matches UiSnapshot::sliceEventId of the event it belongs to
+    int lengthSamples = 0;              // Loop length of the event
+    int numPoints = 0;                  // min(MAX_POINTS, lengthSamples)
+    std::array<float, MAX_POINTS> minimums {};
+    std::array<float, MAX_POINTS> maximums {};
+};
+
+class SliceSummaryBuilder
+{
+public:
+    static constexpr int MAX_SAMPLES_PER_BLOCK = 8192;
+
+    /**
+        Audio thread: starts summarising a new slice (a summary in progress is dropped).
+
+        @param eventId          Id of the event that loops this slice
+        @param startPos         First sample of the slice in the circular source buffer
+        @param length           Slice (loop) length in samples
+        @param alreadyCaptured  Samples of the slice already recorded into the source buffer
+    */
+    void start(juce::uint32 eventId, int startPos, int length, int alreadyCaptured)
+    {
+        summary.eventId = eventId;
+        summary.lengthSamples = juce::jmax(1, length);
+        summary.numPoints = juce::jmin(SliceSummary::MAX_POINTS, summary.lengthSamples);
+        sliceStart = startPos;
+        captured = alreadyCaptured;
+        nextPoint = 0;
+        building = true;
+    }
+
+    void cancel() { building = false; }
+
+    // Audio thread: another block was recorded into the source buffer
+    void addCaptured(int numSamples)
+    {
+        if (building)
+            captured += numSamples;
+    }
+
+    /**
+        Audio thread: summarises the points whose audio has been recorded, up to
+        the per-block budget. Returns true when the summary has just completed.
+    */
+    bool process(const juce::AudioBuffer<float>& source)
+    {
+        if (!building)
+            return false;
+
+        int bufferSize = source.getNumSamples();
+        if (bufferSize <= 0 || summary.lengthSamples > bufferSize)
+        {
+            building = false;
+            return false;
+        }
+
+        int available = juce::jmin(captured, summary.lengthSamples);
+        int budget = MAX_SAMPLES_PER_BLOCK;
+
+        while (nextPoint < summary.numPoints && budget > 0)
+        {
+            int pointStart = getPointBoundary(nextPoint);
+            int pointEnd = getPointBoundary(nextPoint + 1);
+            if (pointEnd > available)
+                break;
+
+            auto range = findRange(source, (sliceStart + pointStart) % bufferSize, pointEnd - pointStart);
+            summary.minimums[(size_t) nextPoint] = range.getStart();
+            summary.maximums[(size_t) nextPoint] = range.getEnd();
+
+            budget -= pointEnd - pointStart;
+            ++nextPoint;
+        }
+
+        if (nextPoint < summary.numPoints)
+            return false;
+
+        building = false;
+        return true;
+    }
+
+    const SliceSummary& getSummary() const { return summary; }
+
+private:
+    int getPointBoundary(int point) const
+    {
+        return static_cast<int>((juce::int64) point * summary.lengthSamples / summary.numPoints);
+    }
+
+    // Min/max over all channels of a circular stretch of the source
+    static juce::Range<float> findRange(const juce::AudioBuffer<float>& source, int startIndex, int numSamples)
+    {
+        int firstPart = juce::jmin(numSamples, source.getNumSamples() - startIndex);
+        juce::Range<float> range;
+        bool first = true;
+
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+        {
+            const float* data = source.getReadPointer(ch);
+            for (auto part : { juce::Range<int>(startIndex, startIndex + firstPart),
+                               juce::Range<int>(0, numSamples - firstPart) })
+            {
+                if (part.isEmpty())
+                    continue;
+
+                auto partRange = juce::FloatVectorOperations::findMinAndMax(data + part.getStart(), part.getLength());
+                range = first ? partRange : range.getUnionWith(partRange);
+                first = false;
+            }
+        }
+
+        return range;
+    }
+
+    SliceSummary summary;
+    int sliceStart = 0;
+    int captured = 0;
+    int nextPoint = 0;
+    bool building = false;
+};
+
+class SliceSummaryQueue
+{
+public:
+    static constexpr int CAPACITY = 4;
+
+    // Audio thread; a full queue drops the summary (the thumbnail keeps the previous slice)
+    void push(const SliceSummary& summary)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 > 0)
+            summaries[(size_t) start1] = summary;
+        fifo.finishedWrite(size1);
+    }
+
+    // Message thread: drains the queue, copying the newest summary into dest
+    bool popLatest(SliceSummary& dest)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+        if (size2 > 0)
+            dest = summaries[(size_t) (start2 + size2 - 1)];
+        else if (size1 > 0)
+            dest = summaries[(size_t) (start1 + size1 - 1)];
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2 > 0;
+    }
+
+private:
+    juce::AbstractFifo fifo { CAPACITY };
+    std::array<SliceSummary, CAPACITY> summaries {};
+};
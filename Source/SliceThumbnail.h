@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    SliceThumbnail.h
+    Waveform of the slice the current event loops, with live loop markers
+
+    - While shown, the processor summarises each new event's slice over its
+      first blocks and queues it (see SliceSummary.h); nothing is built while
+      the thumbnail is hidden
+    - The waveform is rendered into a cached image once per slice
+    - Markers are drawn live from the UI snapshot: read position, the
+      gated-off region (nano gate) and the cycle crossfade region
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "ColorPalette.h"
+#include "RefreshCoordinator.h"
+
+class SliceThumbnail : public juce::Component, public RefreshClient
+{
+public:
+    SliceThumbnail(NanoStuttAudioProcessor& p) : processor(p)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    ~SliceThumbnail() override
+    {
+        processor.setSliceThumbnailActive(false);
+    }
+
+    // Summaries are only built while the thumbnail is visible
+    void visibilityChanged() override
+    {
+        processor.setSliceThumbnailActive(isVisible());
+    }
+
+    void resized() override
+    {
+        cachedScale = 0.0f;  // Re-render the waveform at the next paint
+    }
+
+    void refresh(const DisplayState& state) override
+    {
+        if (!isVisible())
+            return;
+
+        bool changed = false;
+
+        if (processor.getSliceSummaryQueue().popLatest(summary))
+        {
+            waveformDirty = true;
+            changed = true;
+        }
+
+        bool eventShown = state.autoStutterActive && summary.eventId == state.sliceEventId;
+        if (eventShown != shownEvent
+            || (eventShown && (state.slicePosition != shownPosition
+                               || state.sliceGate != shownGate
+                               || state.sliceCrossfade != shownCrossfade
+                               || state.sliceReversed != shownReversed)))
+        {
+            shownEvent = eventShown;
+            shownPosition = state.slicePosition;
+            shownGate = state.sliceGate;
+            shownCrossfade = state.sliceCrossfade;
+            shownReversed = state.sliceReversed;
+            changed = true;
+        }
+
+        if (changed)
+            repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        if (getWidth() <= 0 || getHeight() <= 0)
+            return;
+
+        g.setColour(juce::Colour(0xff05050a));
+        g.fillRect(bounds);
+
+        if (summary.numPoints == 0)
+        {
+            g.setColour(ColorPalette::textInactive);
+            g.setFont(juce::FontOptions(11.0f));
+            g.drawText("Slice appears at the next stutter event", bounds, juce::Justification::centred, false);
+        }
+        else
+        {
+            float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+            if (scale != cachedScale || waveformDirty || waveformImage.isNull())
+            {
+                cachedScale = scale;
+                renderWaveform();
+                waveformDirty = false;
+            }
+
+            // The last slice stays visible, dimmed, between events
+            g.setOpacity(shownEvent ? 1.0f : 0.35f);
+            g.drawImage(waveformImage, bounds);
+            g.setOpacity(1.0f);
+
+            if (shownEvent)
+                drawMarkers(g, bounds);
+        }
+
+        g.setColour(ColorPalette::frameGrey);
+        g.drawRect(bounds, 1.0f);
+    }
+
+private:
+    void drawMarkers(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        float width = bounds.getWidth();
+
+        // Gated-off region (silent part of each nano cycle)
+        if (shownGate < 1.0f)
+        {
+            g.setColour(juce::Colours::black.withAlpha(0.55f));
+            g.fillRect(bounds.withLeft(bounds.getX() + shownGate * width));
+            g.setColour(ColorPalette::nanoPurple);
+            g.drawVerticalLine(juce::roundToInt(bounds.getX() + shownGate * width), bounds.getY(), bounds.getBottom());
+        }
+
+        // Cycle crossfade region at the end of the slice
+        auto crossfadeBounds = bounds.withLeft(bounds.getRight() - shownCrossfade * width);
+        g.setColour(ColorPalette::rhythmicOrange.withAlpha(0.2f));
+        g.fillRect(crossfadeBounds);
+        g.setColour(ColorPalette::rhythmicOrange.withAlpha(0.7f));
+        g.drawVerticalLine(juce::roundToInt(crossfadeBounds.getX()), bounds.getY(), bounds.getBottom());
+
+        // Read position
+        float x = bounds.getX() + shownPosition * width;
+        g.setColour(juce::Colours::white);
+        g.drawLine(x, bounds.getY(), x, bounds.getBottom(), 1.5f);
+
+        if (shownReversed)
+        {
+            g.setFont(juce::FontOptions(9.0f));
+            g.drawText("REV", bounds.reduced(4.0f, 2.0f), juce::Justification::topRight, false);
+        }
+    }
+
+    // One vertical min/max bar per summary point
+    void renderWaveform()
+    {
+        waveformImage = juce::Image(juce::Image::ARGB,
+                                    juce::jmax(1, juce::roundToInt(getWidth() * cachedScale)),
+                                    juce::jmax(1, juce::roundToInt(getHeight() * cachedScale)),
+                                    true);
+        juce::Graphics g(waveformImage);
+        g.addTransform(juce::AffineTransform::scale(cachedScale));
+
+        auto bounds = getLocalBounds().toFloat().reduced(0.0f, 2.0f);
+        float pointWidth = bounds.getWidth() / summary.numPoints;
+        float centreY = bounds.getCentreY();
+        float halfHeight = bounds.getHeight() * 0.5f;
+
+        juce::RectangleList<float> bars;
+        for (int i = 0; i < summary.numPoints; ++i)
+        {
+            float top = centreY - juce::jlimit(-1.0f, 1.0f, summary.maximums[(size_t) i]) * halfHeight;
+            float bottom = centreY - juce::jlimit(-1.0f, 1.0f, summary.minimums[(size_t) i]) * halfHeight;
+            bars.addWithoutMerging({ bounds.getX() + i * pointWidth, top, juce::jmax(1.0f, pointWidth), juce::jmax(1.0f, bottom - top) });
+        }
+
+        g.setColour(ColorPalette::accentCyan.withAlpha(0.8f));
+        g.fillRectList(bars);
+
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        g.drawHorizontalLine(juce::roundToInt(centreY), bounds.getX(), bounds.getRight());
+    }
+
+    NanoStuttAudioProcessor& processor;
+
+    SliceSummary summary;
+    juce::Image waveformImage;
+    float cachedScale = 0.0f;
+    bool waveformDirty = true;
+
+    bool shownEvent = false;
+    float shownPosition = 0.0f;
+    float shownGate = 1.0f;
+    float shownCrossfade = 0.0f;
+    bool shownReversed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SliceThumbnail)
+};
@@ -0,0 +1,337 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+    Output spectrum with nano slot frequency overlay
+
+    - While shown, the processor pushes its output into a SampleFifo once per
+      block; nothing is pushed (or analysed) while the panel is hidden
+    - A background thread runs a Hann-windowed 2048-point FFT every 512
+      samples and reduces it to log-spaced bins (20 Hz - 20 kHz)
+    - The message thread applies peak hold, renders the spectrum into a
+      cached image when new data arrived, and overlays the active nano
+      slots (playing slot highlighted)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "ColorPalette.h"
+#include "RefreshCoordinator.h"
+
+class SpectrumAnalyzer : public juce::Component, public RefreshClient, private juce::Thread
+{
+public:
+    SpectrumAnalyzer(NanoStuttAudioProcessor& p) : juce::Thread("NanoStutt Spectrum"), processor(p)
+    {
+        setInterceptsMouseClicks(false, false);
+
+        auto& apvts = processor.getParameters();
+        for (size_t i = 0; i < nanoActiveParams.size(); ++i)
+            nanoActiveParams[i] = apvts.getRawParameterValue("nanoActive_" + juce::String((int) i));
+    }
+
+    ~SpectrumAnalyzer() override
+    {
+        setActive(false);
+    }
+
+    // Analysis only runs while the panel is visible
+    void visibilityChanged() override
+    {
+        setActive(isVisible());
+    }
+
+    void resized() override
+    {
+        cachedScale = 0.0f;  // Re-render both layers at the next paint
+    }
+
+    void refresh(const DisplayState& state) override
+    {
+        if (!active)
+            return;
+
+        sampleRate.store(state.sampleRate);
+
+        bool changed = false;
+
+        if (spectrumReady.exchange(false))
+        {
+            {
+                const juce::SpinLock::ScopedLockType lock(levelsLock);
+                levels = analysedLevels;
+            }
+
+            // Peak hold with a linear fall-off
+            double nowMs = juce::Time::getMillisecondCounterHiRes();
+            float fall = static_cast<float>((nowMs - lastPeakUpdateMs) * PEAK_FALL_PER_MS);
+            lastPeakUpdateMs = nowMs;
+            for (size_t i = 0; i < peaks.size(); ++i)
+                peaks[i] = juce::jmax(levels[i], peaks[i] - fall);
+
+            spectrumDirty = true;
+            changed = true;
+        }
+
+        if (state.nanoSlotFrequencies != shownNanoFrequencies || state.playingNanoIndex != shownPlayingNano)
+        {
+            shownNanoFrequencies = state.nanoSlotFrequencies;
+            shownPlayingNano = state.playingNanoIndex;
+            changed = true;
+        }
+
+        if (changed)
+            repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        if (getWidth() <= 0 || getHeight() <= 0)
+            return;
+
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (scale != cachedScale || backgroundImage.isNull())
+        {
+            cachedScale = scale;
+            renderBackground();
+            spectrumDirty = true;
+        }
+
+        if (spectrumDirty)
+        {
+            renderSpectrum();
+            spectrumDirty = false;
+        }
+
+        g.drawImage(backgroundImage, bounds);
+        g.drawImage(spectrumImage, bounds);
+
+        // Nano slot overlay (live: cheap, and follows tuning changes immediately)
+        for (size_t i = 0; i < shownNanoFrequencies.size(); ++i)
+        {
+            float frequency = shownNanoFrequencies[i];
+            bool slotActive = nanoActiveParams[i] != nullptr && nanoActiveParams[i]->load() > 0.5f;
+            if (!slotActive || frequency < MIN_FREQUENCY || frequency > MAX_FREQUENCY)
+                continue;
+
+            bool playing = static_cast<int>(i) == shownPlayingNano;
+            float x = frequencyToX(frequency, bounds.getWidth());
+            g.setColour(ColorPalette::nanoPurple.withAlpha(playing ? 1.0f : 0.45f));
+            g.drawLine(x, bounds.getY(), x, bounds.getBottom(), playing ? 2.0f : 1.0f);
+        }
+
+        g.setColour(ColorPalette::frameGrey);
+        g.drawRect(bounds, 1.0f);
+    }
+
+private:
+    static constexpr int FFT_ORDER = 11;
+    static constexpr int FFT_SIZE = 1 << FFT_ORDER;
+    static constexpr int HOP_SIZE = 512;
+    static constexpr int NUM_BINS = 96;
+    static constexpr float MIN_FREQUENCY = 20.0f;
+    static constexpr float MAX_FREQUENCY = 20000.0f;
+    static constexpr float MIN_DB = -90.0f;
+    static constexpr double PEAK_FALL_PER_MS = 0.0005;   // Full scale in 2 s
+
+    //==============================================================================
+    void setActive(bool shouldBeActive)
+    {
+        if (shouldBeActive == active)
+            return;
+        active = shouldBeActive;
+
+        processor.setAnalyzerActive(active);
+        if (active)
+        {
+            lastPeakUpdateMs = juce::Time::getMillisecondCounterHiRes();
+            startThread(juce::Thread::Priority::low);
+        }
+        else
+        {
+            stopThread(500);
+        }
+    }
+
+    // Analysis thread
+    void run() override
+    {
+        std::array<float, HOP_SIZE> incoming {};
+        int samplesSinceFft = 0;
+
+        while (!threadShouldExit())
+        {
+            int numRead = processor.getAnalyzerFifo().pop(incoming.data(), HOP_SIZE);
+            if (numRead == 0)
+            {
+                wait(10);
+                continue;
+            }
+
+            for (int i = 0; i < numRead; ++i)
+            {
+                history[(size_t) historyPos] = incoming[(size_t) i];
+                historyPos = (historyPos + 1) % FFT_SIZE;
+            }
+
+            samplesSinceFft += numRead;
+            if (samplesSinceFft >= HOP_SIZE)
+            {
+                samplesSinceFft = 0;
+                analyse();
+            }
+        }
+    }
+
+    void analyse()
+    {
+        // Oldest sample first
+        for (int i = 0; i < FFT_SIZE; ++i)
+            fftData[(size_t) i] = history[(size_t) ((historyPos + i) % FFT_SIZE)];
+        std::fill(fftData.begin() + FFT_SIZE, fftData.end(), 0.0f);
+
+        window.multiplyWithWindowingTable(fftData.data(), (size_t) FFT_SIZE);
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        double rate = sampleRate.load();
+        float binWidth = static_cast<float>(rate / FFT_SIZE);
+        std::array<float, NUM_BINS> result {};
+
+        for (int bin = 0; bin < NUM_BINS; ++bin)
+        {
+            // Highest FFT magnitude within this log-spaced band
+            float f0 = binToFrequency(static_cast<float>(bin));
+            float f1 = binToFrequency(static_cast<float>(bin + 1));
+            int first = juce::jlimit(1, FFT_SIZE / 2 - 1, static_cast<int>(f0 / binWidth));
+            int last = juce::jlimit(first, FFT_SIZE / 2 - 1, static_cast<int>(f1 / binWidth));
+
+            float magnitude = 0.0f;
+            for (int k = first; k <= last; ++k)
+                magnitude = juce::jmax(magnitude, fftData[(size_t) k]);
+
+            // Hann window: a full-scale sine peaks at FFT_SIZE / 4
+            float db = juce::Decibels::gainToDecibels(magnitude * 4.0f / FFT_SIZE, MIN_DB);
+            result[(size_t) bin] = juce::jmap(db, MIN_DB, 0.0f, 0.0f, 1.0f);
+        }
+
+        {
+            const juce::SpinLock::ScopedLockType lock(levelsLock);
+            analysedLevels = result;
+        }
+        spectrumReady.store(true);
+    }
+
+    //==============================================================================
+    static float binToFrequency(float bin)
+    {
+        return MIN_FREQUENCY * std::pow(MAX_FREQUENCY / MIN_FREQUENCY, bin / NUM_BINS);
+    }
+
+    static float frequencyToX(float frequency, float width)
+    {
+        return width * std::log(frequency / MIN_FREQUENCY) / std::log(MAX_FREQUENCY / MIN_FREQUENCY);
+    }
+
+    juce::Image createLayerImage(bool hasAlpha) const
+    {
+        return juce::Image(hasAlpha ? juce::Image::ARGB : juce::Image::RGB,
+                           juce::jmax(1, juce::roundToInt(getWidth() * cachedScale)),
+                           juce::jmax(1, juce::roundToInt(getHeight() * cachedScale)),
+                           true);
+    }
+
+    // Dark panel with decade grid lines
+    void renderBackground()
+    {
+        backgroundImage = createLayerImage(false);
+        juce::Graphics g(backgroundImage);
+        g.addTransform(juce::AffineTransform::scale(cachedScale));
+
+        auto bounds = getLocalBounds().toFloat();
+        g.setColour(juce::Colour(0xff05050a));
+        g.fillRect(bounds);
+
+        g.setFont(juce::FontOptions(9.0f));
+        for (float frequency : { 50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f })
+        {
+            float x = frequencyToX(frequency, bounds.getWidth());
+            g.setColour(juce::Colours::white.withAlpha(0.07f));
+            g.drawVerticalLine(juce::roundToInt(x), bounds.getY(), bounds.getBottom());
+            g.setColour(juce::Colours::white.withAlpha(0.3f));
+            g.drawText(frequency >= 1000.0f ? juce::String(frequency / 1000.0f, 0) + "k" : juce::String(frequency, 0),
+                       juce::Rectangle<float>(x + 2.0f, bounds.getBottom() - 12.0f, 30.0f, 12.0f),
+                       juce::Justification::centredLeft, false);
+        }
+    }
+
+    // Filled spectrum plus peak-hold line
+    void renderSpectrum()
+    {
+        spectrumImage = createLayerImage(true);
+        juce::Graphics g(spectrumImage);
+        g.addTransform(juce::AffineTransform::scale(cachedScale));
+
+        auto bounds = getLocalBounds().toFloat();
+        float binPixelWidth = bounds.getWidth() / NUM_BINS;
+        auto levelToY = [&bounds](float level) { return bounds.getBottom() - level * bounds.getHeight(); };
+
+        juce::Path fill, peakLine;
+        fill.startNewSubPath(bounds.getX(), bounds.getBottom());
+        for (int bin = 0; bin < NUM_BINS; ++bin)
+        {
+            float x = bounds.getX() + (bin + 0.5f) * binPixelWidth;
+            fill.lineTo(x, levelToY(levels[(size_t) bin]));
+
+            if (bin == 0)
+                peakLine.startNewSubPath(x, levelToY(peaks[(size_t) bin]));
+            else
+                peakLine.lineTo(x, levelToY(peaks[(size_t) bin]));
+        }
+        fill.lineTo(bounds.getRight(), bounds.getBottom());
+        fill.closeSubPath();
+
+        g.setGradientFill(juce::ColourGradient(ColorPalette::accentCyan.withAlpha(0.5f), 0.0f, bounds.getY(),
+                                               ColorPalette::accentCyan.withAlpha(0.05f), 0.0f, bounds.getBottom(), false));
+        g.fillPath(fill);
+
+        g.setColour(juce::Colours::white.withAlpha(0.6f));
+        g.strokePath(peakLine, juce::PathStrokeType(1.0f));
+    }
+
+    //==============================================================================
+    NanoStuttAudioProcessor& processor;
+    std::array<std::atomic<float>*, 12> nanoActiveParams {};
+    bool active = false;
+
+    // Analysis thread
+    juce::dsp::FFT fft { FFT_ORDER };
+    juce::dsp::WindowingFunction<float> window { (size_t) FFT_SIZE, juce::dsp::WindowingFunction<float>::hann, false };
+    std::array<float, FFT_SIZE> history {};
+    int historyPos = 0;
+    std::array<float, FFT_SIZE * 2> fftData {};
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // Handoff
+    juce::SpinLock levelsLock;
+    std::array<float, NUM_BINS> analysedLevels {};
+    std::atomic<bool> spectrumReady { false };
+
+    // Message thread
+    std::array<float, NUM_BINS> levels {};
+    std::array<float, NUM_BINS> peaks {};
+    double lastPeakUpdateMs = 0.0;
+    std::array<float, 12> shownNanoFrequencies {};
+    int shownPlayingNano = -1;
+
+    juce::Image backgroundImage;
+    juce::Image spectrumImage;
+    float cachedScale = 0.0f;
+    bool spectrumDirty = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    StateSlots.h
+    In-memory A/B/C/D snapshots of the parameter state for quick comparison
+
+    Each slot is a flat array of normalised values in ParameterTable order,
+    stored and cleared on the message thread. Recall only sets a pending
+    slot; the audio thread applies it at the next event boundary (see
+    processBlock) by writing the parameters that differ from the current
+    values, so nothing is parsed and no event changes its sound halfway.
+
+    Session parameters (and the morph amount) are stored but never recalled.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "ParameterTable.h"
+
+class StateSlots
+{
+public:
+    static constexpr int NUM_SLOTS = 4;
+
+    /**
+        Message thread, before use: sizes the slots for the table so storing
+        never reallocates while the audio thread may be reading.
+
+        @param excluded     Parameter IDs that are never recalled
+    */
+    void prepare(const ParameterTable& tableToUse, const juce::StringArray& excluded)
+    {
+        table = &tableToUse;
+        auto size = (size_t) table->size();
+
+        recallable.assign(size, true);
+        for (int i = 0; i < table->size(); ++i)
+            recallable[(size_t) i] = !excluded.contains(table->getID(i));
+
+        const juce::SpinLock::ScopedLockType lock(slotLock);
+        for (auto& values : slots)
+            values.assign(size, 0.0f);
+        for (auto& stored : filled)
+            stored.store(false);
+    }
+
+    // Message thread: stores normalised values (in table order) in slot
+    void store(int slot, const std::vector<float>& normalisedValues)
+    {
+        jassert(juce::isPositiveAndBelow(slot, NUM_SLOTS));
+        jassert(table != nullptr && (int) normalisedValues.size() == table->size());
+
+        const juce::SpinLock::ScopedLockType lock(slotLock);
+        std::copy(normalisedValues.begin(), normalisedValues.end(), slots[(size_t) slot].begin());
+        filled[(size_t) slot].store(true);
+        activeSlot.store(slot);
+    }
+
+    void clear(int slot)
+    {
+        jassert(juce::isPositiveAndBelow(slot, NUM_SLOTS));
+
+        // A recall of this slot that has not happened yet is dropped
+        int expected = slot;
+        pendingRecall.compare_exchange_strong(expected, -1);
+        filled[(size_t) slot].store(false);
+        expected = slot;
+        activeSlot.compare_exchange_strong(expected, -1);
+    }
+
+    bool hasSlot(int slot) const    { return filled[(size_t) slot].load(); }
+
+    // Slot last stored or recalled (-1 = none)
+    int getActiveSlot() const       { return activeSlot.load(); }
+
+    // Any thread: recall slot at the next event boundary (a later request replaces an earlier one)
+    void requestRecall(int slot)
+    {
+        if (juce::isPositiveAndBelow(slot, NUM_SLOTS) && hasSlot(slot))
+            pendingRecall.store(slot);
+    }
+
+    bool hasPendingRecall() const   { return pendingRecall.load(std::memory_order_relaxed) >= 0; }
+
+    /**
+        Audio thread: applies the pending recall by calling
+        write(parameterIndex, normalisedValue) for every recallable parameter
+        that differs. If a slot is being stored right now, the recall stays
+        pending for the next call.
+
+        @return     True if any parameter was written
+    */
+    template <typename WriteFunction>
+    bool processRecall(WriteFunction&& write)
+    {
+        const juce::SpinLock::ScopedTryLockType lock(slotLock);
+        if (!lock.isLocked())
+            return false;
+
+        int slot = pendingRecall.exchange(-1);
+        if (slot < 0 || !hasSlot(slot))
+            return false;
+
+        const auto& values = slots[(size_t) slot];
+        bool wrote = false;
+
+        for (int i = 0; i < table->size(); ++i)
+        {
+            if (recallable[(size_t) i] && table->getParameter(i)->getValue() != values[(size_t) i])
+            {
+                write(i, values[(size_t) i]);
+                wrote = true;
+            }
+        }
+
+        activeSlot.store(slot);
+        return wrote;
+    }
+
+private:
+    const ParameterTable* table = nullptr;
+    std::vector<bool> recallable;
+
+    juce::SpinLock slotLock;                // Message thread stores under it, audio thread try-locks
+    std::array<std::vector<float>, NUM_SLOTS> slots;
+    std::array<std::atomic<bool>, NUM_SLOTS> filled {};
+
+    std::atomic<int> pendingRecall { -1 };
+    std::atomic<int> activeSlot { -1 };
+};
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    StutterGroupSync.h
+    Process-wide registry for sharing stutter decisions between instances
+
+    Instances join one of a fixed set of groups (A-H). The group leader makes
+    its usual decisions at each scheduling point and publishes them, keyed by
+    the start of the scheduled unit in 1/32 notes. Followers skip their own
+    decision and apply the leader's at the same host PPQ position, so every
+    member stutters on the same grid.
+
+    Each decision is packed into a single 64-bit atomic, so publishing and
+    fetching are lock-free and never tear. Decisions are published one quant
+    unit ahead of the event, which leaves followers processed earlier in the
+    same host cycle at least one block to pick them up.
+
+    Leader liveness is measured on the shared host timeline rather than the
+    wall clock: the leader stamps its transport position every block, and a
+    follower trusts the group only while that stamp is within a bar of its
+    own position. This holds for offline renders and for hosts that process
+    blocks faster or slower than real time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <limits>
+
+class StutterGroupRegistry
+{
+public:
+    static constexpr int NUM_GROUPS = 8;                // Group parameter: 0 = off, 1-8 = A-H
+    static constexpr int SLOTS_PER_GROUP = 64;          // Ring of decisions indexed by unit start
+    static constexpr int LEADER_TIMEOUT_UNITS = 32;      // 1/32 notes between leader and follower (one bar)
+
+    struct Decision
+    {
+        int unitStart = 0;          // Start of the scheduled unit in 1/32 notes
+        bool fire = false;
+        int rateSlot = -1;          // RateMarkovChain slot, -1 = follower decides
+        int reverse = -1;           // 1 = reversed, 0 = forward, -1 = follower decides
+        int quantIndex = 6;         // Quant index applied from unitStart on
+        float gate = 1.0f;          // autoStutterGate of the leader (0.25 - 1.0)
+    };
+
+    StutterGroupRegistry()
+    {
+        for (auto& group : groups)
+        {
+            group.leaderPosition.store(NO_LEADER);
+            for (auto& slot : group.slots)
+                slot.store(0);
+        }
+    }
+
+    static bool isValidGroup(int group) { return group >= 1 && group <= NUM_GROUPS; }
+
+    // Leader, audio thread: once per block with its transport position in 1/32 notes,
+    // so followers can tell the leader is alive and on the same timeline
+    void touchLeader(int group, int transportPosition)
+    {
+        if (isValidGroup(group))
+            groups[(size_t) group - 1].leaderPosition.store(transportPosition, std::memory_order_relaxed);
+    }
+
+    // Leader, audio thread. Multiple leaders in one group simply overwrite each other.
+    void publish(int group, const Decision& decision)
+    {
+        if (!isValidGroup(group))
+            return;
+
+        auto& slot = groups[(size_t) group - 1].slots[(size_t) wrapSlot(decision.unitStart)];
+        slot.store(pack(decision), std::memory_order_release);
+    }
+
+    /**
+        Follower, audio thread: false if no live leader has published a decision for this unit yet.
+
+        @param transportPosition    The follower's own transport position in 1/32 notes
+    */
+    bool fetch(int group, int unitStart, int transportPosition, Decision& decision) const
+    {
+        if (!isValidGroup(group))
+            return false;
+
+        const auto& g = groups[(size_t) group - 1];
+        auto leaderPosition = g.leaderPosition.load(std::memory_order_relaxed);
+        if (leaderPosition == NO_LEADER || std::abs(static_cast<juce::int64>(transportPosition) - leaderPosition) > LEADER_TIMEOUT_UNITS)
+            return false;
+
+        auto packed = g.slots[(size_t) wrapSlot(unitStart)].load(std::memory_order_acquire);
+        if ((packed & VALID_BIT) == 0 || static_cast<juce::uint32>(packed) != static_cast<juce::uint32>(unitStart))
+            return false;
+
+        decision = unpack(packed);
+        return true;
+    }
+
+private:
+    // Bit layout: 0-31 unit start, 32 valid, 33 fire, 34-38 rate slot + 1,
+    // 39-40 reverse + 1, 41-44 quant index, 45-52 gate (0.25 - 1.0 in 255 steps)
+    static constexpr juce::uint64 VALID_BIT = 1ull << 32;
+    static constexpr juce::uint64 FIRE_BIT = 1ull << 33;
+    static constexpr juce::int64 NO_LEADER = std::numeric_limits<juce::int64>::min();
+
+    static int wrapSlot(int unitStart) { return ((unitStart % SLOTS_PER_GROUP) + SLOTS_PER_GROUP) % SLOTS_PER_GROUP; }
+
+    static juce::uint64 pack(const Decision& d)
+    {
+        auto gateByte = static_cast<juce::uint64>(juce::roundToInt((juce::jlimit(0.25f, 1.0f, d.gate) - 0.25f) / 0.75f * 255.0f));
+
+        return static_cast<juce::uint64>(static_cast<juce::uint32>(d.unitStart))
+             | VALID_BIT
+             | (d.fire ? FIRE_BIT : 0)
+             | (static_cast<juce::uint64>(juce::jlimit(0, 31, d.rateSlot + 1)) << 34)
+             | (static_cast<juce::uint64>(juce::jlimit(0, 2, d.reverse + 1)) << 39)
+             | (static_cast<juce::uint64>(juce::jlimit(0, 15, d.quantIndex)) << 41)
+             | (gateByte << 45);
+    }
+
+    static Decision unpack(juce::uint64 packed)
+    {
+        Decision d;
+        d.unitStart = static_cast<int>(static_cast<juce::uint32>(packed));
+        d.fire = (packed & FIRE_BIT) != 0;
+        d.rateSlot = static_cast<int>((packed >> 34) & 0x1f) - 1;
+        d.reverse = static_cast<int>((packed >> 39) & 0x3) - 1;
+        d.quantIndex = static_cast<int>((packed >> 41) & 0xf);
+        d.gate = 0.25f + static_cast<float>((packed >> 45) & 0xff) / 255.0f * 0.75f;
+        return d;
+    }
+
+    struct Group
+    {
+        std::atomic<juce::int64> leaderPosition;         // Last transport position stamped by the leader
+        std::array<std::atomic<juce::uint64>, SLOTS_PER_GROUP> slots;
+    };
+
+    std::array<Group, NUM_GROUPS> groups;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StutterGroupRegistry)
+};
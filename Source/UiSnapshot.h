@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    UiSnapshot.h
+    Audio-to-UI state, published once per processed block
+
+    The processor fills one UiSnapshot at the end of each block and publishes
+    it through a triple buffer: the audio thread never waits, the message
+    thread always reads a complete snapshot from a single block, and neither
+    side can observe a half-written one. The editor reads only this, so one
+    frame never mixes values from different blocks and the GUI never queries
+    the host playhead itself.
+
+    Single writer (audio thread), single reader (message thread).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+struct UiSnapshot
+{
+    // Host transport (PPQ with timing offset applied, same space as the scheduler)
+    double playheadPpq = 0.0;
+    double playheadBpm = 120.0;
+    bool transportPlaying = false;
+
+    // Active stutter event
+    bool autoStutterActive = false;
+    bool usingNanoRate = false;
+    float nanoFrequency = 0.0f;
+    int playingNanoIndex = -1;          // -1 = none, 0-11
+    int playingRegularIndex = -1;       // -1 = none, 0-12
+    int quantIndex = 0;
+
+    // Output visualization buffer
+    int outputWritePos = 0;
+    int outputBufferSize = 0;
+
+    // Spectrum analyzer
+    double sampleRate = 44100.0;
+    std::array<float, 12> nanoSlotFrequencies {};   // Hz, per nano slot at the current tuning
+
+    // Slice thumbnail (fractions of the loop, in captured-slice order; see SliceSummary.h)
+    juce::uint32 sliceEventId = 0;      // Incremented per event, 0 = no event yet
+    float slicePosition = 0.0f;         // Current read position
+    float sliceGate = 1.0f;             // Audible region [0, sliceGate)
+    float sliceCrossfade = 0.0f;        // Cycle crossfade region [1 - sliceCrossfade, 1)
+    bool sliceReversed = false;         // Playing the slice backwards
+
+    // A/B/C/D state slots
+    int activeStateSlot = -1;           // Last stored or recalled slot, -1 = none
+    juce::uint32 stateSlotRecalls = 0;  // Incremented per applied recall
+
+    // Linked state
+    juce::uint32 linkedTuningUpdates = 0;   // Incremented when a linked instance changed the tuning
+};
+
+class UiSnapshotBuffer
+{
+public:
+    // Audio thread
+    void publish(const UiSnapshot& snapshot)
+    {
+        buffers[(size_t) writeIndex] = snapshot;
+        writeIndex = middle.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Message thread: latest published snapshot (the previous one again if nothing new arrived)
+    const UiSnapshot& read()
+    {
+        if ((middle.load(std::memory_order_relaxed) & FRESH_BIT) != 0)
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return buffers[(size_t) readIndex];
+    }
+
+private:
+    static constexpr int INDEX_MASK = 0x3;
+    static constexpr int FRESH_BIT = 0x4;
+
+    std::array<UiSnapshot, 3> buffers {};
+    int writeIndex = 0;                 // Owned by the audio thread
+    int readIndex = 1;                  // Owned by the message thread
+    std::atomic<int> middle { 2 };      // Index handed between them, FRESH_BIT = not read yet
+};
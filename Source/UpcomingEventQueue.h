@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    UpcomingEventQueue.h
+    Lock-free preview queue of scheduled stutter events
+
+    The scheduler decides each event one quant unit before it starts (fire,
+    quant unit, rate, reverse, gate) and pushes it here. The editor drains
+    the queue on the message thread to show what is coming next.
+
+    Single producer (audio thread), single consumer (message thread).
+    A full queue drops the newest event; the UI only loses a preview.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+struct UpcomingEvent
+{
+    double startPpq = 0.0;      // Event start (host PPQ, timing offset applied)
+    double lengthPpq = 0.0;     // Gated event length
+    int rateSlot = -1;          // RateMarkovChain slot, -1 = drawn when the event starts
+    bool reversed = false;
+    int quantIndex = 6;         // 0 = 4 bars ... 8 = 1/32
+};
+
+class UpcomingEventQueue
+{
+public:
+    static constexpr int CAPACITY = 64;
+
+    // Audio thread
+    void push(const UpcomingEvent& event)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 > 0)
+            events[(size_t) start1] = event;
+        fifo.finishedWrite(size1);
+    }
+
+    // Audio thread: the transport moved, previously announced events will not happen
+    void invalidate() { generation.fetch_add(1, std::memory_order_release); }
+
+    // Message thread: incremented whenever announced events became invalid
+    juce::uint32 getGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    // Message thread: drains all pending events in scheduling order
+    template <typename Callback>
+    void popAll(Callback&& callback)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+        for (int i = 0; i < size1; ++i)
+            callback(events[(size_t) (start1 + i)]);
+        for (int i = 0; i < size2; ++i)
+            callback(events[(size_t) (start2 + i)]);
+        fifo.finishedRead(size1 + size2);
+    }
+
+private:
+    juce::AbstractFifo fifo { CAPACITY };
+    std::array<UpcomingEvent, CAPACITY> events {};
+    std::atomic<juce::uint32> generation { 0 };
+};
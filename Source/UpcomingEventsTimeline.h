@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    UpcomingEventsTimeline.h
+    Scrolling timeline of scheduled and recent stutter events
+
+    - Drains the processor's UpcomingEventQueue (events are announced one
+      quant unit before they start)
+    - Scrolls with the host playhead, "now" line near the left edge
+    - Orange = repeat rate, purple = nano rate, arrow = reversed
+    - "Next" readout with rate and distance in beats
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "ColorPalette.h"
+#include "RefreshCoordinator.h"
+
+class UpcomingEventsTimeline : public juce::Component, public RefreshClient
+{
+public:
+    UpcomingEventsTimeline(NanoStuttAudioProcessor& p) : processor(p)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    // Drains new events and scrolls; repaints only while playing or when events changed
+    void refresh(const DisplayState& state) override
+    {
+        auto& queue = processor.getUpcomingEventQueue();
+        bool changed = false;
+
+        // Transport jumped: announced events are void
+        auto generation = queue.getGeneration();
+        if (generation != lastGeneration)
+        {
+            lastGeneration = generation;
+            events.clearQuick();
+            changed = true;
+        }
+
+        queue.popAll([this, &changed](const UpcomingEvent& event)
+        {
+            if (events.size() >= MAX_EVENTS)
+                events.remove(0);
+            events.add(event);
+            changed = true;
+        });
+
+        // Playhead arrives once per audio block; extrapolate between blocks for smooth scrolling
+        double nowMs = juce::Time::getMillisecondCounterHiRes();
+        if (state.playheadPpq != lastBlockPpq)
+        {
+            lastBlockPpq = state.playheadPpq;
+            lastBlockTimeMs = nowMs;
+        }
+
+        double previousPpq = displayPpq;
+        if (state.transportPlaying)
+        {
+            double elapsedMs = juce::jmin(nowMs - lastBlockTimeMs, MAX_EXTRAPOLATION_MS);
+            displayPpq = state.playheadPpq + elapsedMs * state.playheadBpm / 60000.0;
+        }
+        else
+        {
+            displayPpq = state.playheadPpq;
+        }
+
+        // Drop events that scrolled out of view
+        while (!events.isEmpty() && events.getReference(0).startPpq + events.getReference(0).lengthPpq < displayPpq - HISTORY_BEATS)
+            events.remove(0);
+
+        if (changed || displayPpq != previousPpq)
+            repaint();
+    }
+
+    // Next event that has not started yet (used for "next up" highlights in the editor)
+    const UpcomingEvent* getNextEvent() const
+    {
+        for (const auto& event : events)
+            if (event.startPpq > displayPpq)
+                return &event;
+        return nullptr;
+    }
+
+    static juce::String getRateName(int rateSlot)
+    {
+        static const juce::StringArray rateNames { "1", "1/2d", "1/2", "1/4d", "1/3", "1/4", "1/8d", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32" };
+        static const juce::StringArray nanoNames { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+
+        if (rateSlot < 0)
+            return "?";
+        if (RateMarkovChain::isNanoSlot(rateSlot))
+            return "n" + nanoNames[RateMarkovChain::toSystemIndex(rateSlot)];
+        return rateNames[rateSlot];
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        g.setColour(juce::Colour(0xff05050a));
+        g.fillRect(bounds);
+
+        auto laneBounds = bounds.withTrimmedRight(NEXT_READOUT_WIDTH);
+        float beatWidth = laneBounds.getWidth() / static_cast<float>(VISIBLE_BEATS);
+        double windowStart = displayPpq - HISTORY_BEATS;
+
+        auto ppqToX = [&](double ppq)
+        {
+            return laneBounds.getX() + static_cast<float>((ppq - windowStart) * beatWidth);
+        };
+
+        // Beat grid, bar lines brighter
+        for (double beat = std::ceil(windowStart); beat <= windowStart + VISIBLE_BEATS; beat += 1.0)
+        {
+            bool isBar = std::fmod(beat, 4.0) == 0.0;
+            g.setColour(juce::Colours::white.withAlpha(isBar ? 0.15f : 0.05f));
+            g.drawVerticalLine(static_cast<int>(ppqToX(beat)), laneBounds.getY(), laneBounds.getBottom());
+        }
+
+        // Events
+        g.setFont(juce::FontOptions(10.0f));
+        for (const auto& event : events)
+        {
+            float x1 = juce::jmax(laneBounds.getX(), ppqToX(event.startPpq));
+            float x2 = juce::jmin(laneBounds.getRight(), ppqToX(event.startPpq + event.lengthPpq));
+            if (x2 <= x1)
+                continue;
+
+            bool isNano = event.rateSlot >= 0 && RateMarkovChain::isNanoSlot(event.rateSlot);
+            bool isPast = event.startPpq + event.lengthPpq < displayPpq;
+            auto colour = isNano ? ColorPalette::nanoPurple : ColorPalette::rhythmicOrange;
+
+            auto eventBounds = juce::Rectangle<float>(x1, laneBounds.getY() + 2.0f, x2 - x1, laneBounds.getHeight() - 4.0f);
+            g.setColour(colour.withAlpha(isPast ? 0.25f : 0.6f));
+            g.fillRoundedRectangle(eventBounds, 2.0f);
+
+            if (eventBounds.getWidth() > 18.0f)
+            {
+                g.setColour(juce::Colours::black.withAlpha(isPast ? 0.5f : 0.9f));
+                g.drawText((event.reversed ? juce::String(juce::CharPointer_UTF8("\xe2\x97\x80")) : juce::String())
+                               + getRateName(event.rateSlot),
+                           eventBounds.reduced(2.0f, 0.0f), juce::Justification::centredLeft, false);
+            }
+        }
+
+        // Now line
+        g.setColour(juce::Colours::white.withAlpha(0.8f));
+        g.drawVerticalLine(static_cast<int>(ppqToX(displayPpq)), laneBounds.getY(), laneBounds.getBottom());
+
+        // Next-up readout
+        auto readoutBounds = bounds.removeFromRight(NEXT_READOUT_WIDTH).reduced(4.0f, 0.0f);
+        g.setFont(juce::FontOptions(11.0f));
+        if (auto* next = getNextEvent())
+        {
+            bool isNano = next->rateSlot >= 0 && RateMarkovChain::isNanoSlot(next->rateSlot);
+            g.setColour(isNano ? ColorPalette::nanoPurple : ColorPalette::rhythmicOrange);
+            g.drawText("NEXT " + getRateName(next->rateSlot) + (next->reversed ? " rev" : "")
+                           + "  " + juce::String(next->startPpq - displayPpq, 1) + "b",
+                       readoutBounds, juce::Justification::centredLeft, false);
+        }
+        else
+        {
+            g.setColour(juce::Colours::grey);
+            g.drawText("NEXT -", readoutBounds, juce::Justification::centredLeft, false);
+        }
+
+        g.setColour(ColorPalette::frameGrey);
+        g.drawRect(getLocalBounds().toFloat(), 1.0f);
+    }
+
+private:
+    static constexpr double VISIBLE_BEATS = 16.0;       // One bar of history, three ahead
+    static constexpr double HISTORY_BEATS = 4.0;
+    static constexpr float NEXT_READOUT_WIDTH = 130.0f;
+    static constexpr int MAX_EVENTS = 128;
+    static constexpr double MAX_EXTRAPOLATION_MS = 250.0;
+
+    NanoStuttAudioProcessor& processor;
+    juce::Array<UpcomingEvent> events;
+    juce::uint32 lastGeneration = 0;
+    double displayPpq = 0.0;
+    double lastBlockPpq = 0.0;
+    double lastBlockTimeMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UpcomingEventsTimeline)
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    LinkedStateTests.cpp
+    Linked instances must mirror each other without the host hearing of it
+
+    Two processors join the same link channel; an edit on the leader is
+    applied by the follower's next block. The follower's AudioProcessorListeners
+    (which is how the plugin wrappers tell the host) must not be called.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int BLOCK_SIZE = 512;
+    constexpr float LINK_CHANNEL = 8.0f;    // Link H, used by no other test
+
+    struct ParameterChangeCounter : public juce::AudioProcessorListener
+    {
+        void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override { ++numChanges; }
+        void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+
+        int numChanges = 0;
+    };
+
+    void setParameter(NanoStuttAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        auto* parameter = processor.getParameters().getParameter(parameterID);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // No play head: the block returns after the linked state is exchanged
+    void processBlock(NanoStuttAudioProcessor& processor)
+    {
+        juce::AudioBuffer<float> buffer(2, BLOCK_SIZE);
+        juce::MidiBuffer midi;
+        buffer.clear();
+        processor.processBlock(buffer, midi);
+    }
+}
+
+//==============================================================================
+class LinkedStateTests : public juce::UnitTest
+{
+public:
+    LinkedStateTests() : juce::UnitTest("Linked state", "NanoStutt") {}
+
+    void runTest() override
+    {
+        NanoStuttAudioProcessor leader, follower;
+        for (auto* processor : { &leader, &follower })
+        {
+            processor->setPlayConfigDetails(2, 2, SAMPLE_RATE, BLOCK_SIZE);
+            processor->prepareToPlay(SAMPLE_RATE, BLOCK_SIZE);
+            setParameter(*processor, "stateLink", LINK_CHANNEL);
+            processBlock(*processor);   // Joins the channel
+        }
+
+        ParameterChangeCounter followerListener;
+        follower.addListener(&followerListener);
+
+        beginTest("A linked change is applied without notifying the follower's processor listeners");
+        {
+            setParameter(leader, "nanoBlend", 0.9f);
+            processBlock(leader);
+            processBlock(follower);
+
+            auto* nanoBlend = follower.getParameters().getParameter("nanoBlend");
+            expectWithinAbsoluteError(nanoBlend->convertFrom0to1(nanoBlend->getValue()), 0.9f, 1.0e-4f);
+            expectWithinAbsoluteError(follower.getParameters().getRawParameterValue("nanoBlend")->load(), 0.9f, 1.0e-4f);
+            expectEquals(followerListener.numChanges, 0);
+        }
+
+        beginTest("Taking the quiet writes updates the state tree without notifying the host");
+        {
+            int numTaken = 0;
+            follower.takeQuietParameterWrites([&numTaken](int) { ++numTaken; });
+
+            auto child = follower.getParameters().state.getChildWithProperty("id", "nanoBlend");
+            expectGreaterThan(numTaken, 0);
+            expectWithinAbsoluteError(static_cast<float>(child.getProperty("value")), 0.9f, 1.0e-4f);
+            expectEquals(followerListener.numChanges, 0);
+        }
+
+        follower.removeListener(&followerListener);
+        for (auto* processor : { &leader, &follower })
+            processor->releaseResources();
+    }
+};
+
+static LinkedStateTests linkedStateTests;
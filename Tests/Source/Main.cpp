@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Console runner for the NanoStutt unit tests
+
+    Runs every juce::UnitTest compiled into the app (category "NanoStutt")
+    and returns non-zero if any of them failed, so build machines can gate
+    on it.
+
+    Build from NanoStuttTests.jucer in this folder; it compiles the plugin
+    sources from ../Source into a console app.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("NanoStutt");
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    return numFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    PatternScriptTests.cpp
+    The compiler must reject any script the VM cannot run
+
+    Nesting is limited separately from the VM stack, so a script can be well
+    within the nesting limit and still need more stack than the VM has. The
+    compiler tracks the stack depth of every instruction and rejects it.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PatternScript.h"
+
+namespace
+{
+    // "rate = 1 + (1 + (... + 1))": every parenthesis holds one more value on the stack
+    juce::String makeNestedSum(int numTerms)
+    {
+        juce::String expression = "1";
+        for (int i = 1; i < numTerms; ++i)
+            expression = "1 + (" + expression + ")";
+        return "rate = " + expression;
+    }
+}
+
+//==============================================================================
+class PatternScriptTests : public juce::UnitTest
+{
+public:
+    PatternScriptTests() : juce::UnitTest("Pattern script", "NanoStutt") {}
+
+    void runTest() override
+    {
+        juce::Random random(1);
+
+        beginTest("A script using the whole stack compiles and runs");
+        {
+            PatternScript::Program program;
+            expect(PatternScript::compile(makeNestedSum(PatternScript::MAX_STACK_DEPTH), program).wasOk());
+
+            PatternScript::Registers registers {};
+            expect(PatternScript::execute(program, registers, random));
+            expectEquals(registers[PatternScript::Rate], static_cast<float>(PatternScript::MAX_STACK_DEPTH));
+        }
+
+        beginTest("A script needing more stack than the VM has is a compile error");
+        {
+            PatternScript::Program program;
+            auto result = PatternScript::compile(makeNestedSum(PatternScript::MAX_STACK_DEPTH + 1), program);
+            expect(result.failed());
+            expect(result.getErrorMessage().contains("too complex"));
+            expect(!program.isValid);
+        }
+    }
+};
+
+static PatternScriptTests patternScriptTests;